@@ -29,9 +29,202 @@ THE SOFTWARE.
 local c = require "evdev.core"
 local constants = require "evdev.constants"
 
+-- Batched reads: cdata over the C buffer under LuaJIT, otherwise tables
+-- of the same shape built through Device:event()
+local batch
+if jit then
+	local ok, ffiBatch = pcall(require, "evdev.ffi")
+	if ok then
+		batch = ffiBatch
+	end
+end
+
+if not batch then
+	local floor = math.floor
+
+	local function readBatch(device, max)
+		local count, reason = device:readBatch(max)
+		if not count then
+			return nil, reason
+		end
+		local events = {}
+		for i = 1, count do
+			local timestamp, type, code, value = device:event(i)
+			local sec = floor(timestamp)
+			events[i - 1] = {
+				time = { tv_sec = sec, tv_usec = floor((timestamp - sec) * 1e6 + 0.5) },
+				type = type, code = code, value = value,
+			}
+		end
+		return count, events
+	end
+
+	-- sources hold the 0-based Ring index, matching the C array
+	local function harvest(ring, block)
+		local count = ring:harvest(block)
+		if not count then
+			return nil
+		end
+		local events, sources = {}, {}
+		for i = 1, count do
+			local timestamp, type, code, value, _, index = ring:event(i)
+			local sec = floor(timestamp)
+			events[i - 1] = {
+				time = { tv_sec = sec, tv_usec = floor((timestamp - sec) * 1e6 + 0.5) },
+				type = type, code = code, value = value,
+			}
+			sources[i - 1] = index - 1
+		end
+		return count, events, sources
+	end
+
+	local function timestamp(event)
+		return event.time.tv_sec + event.time.tv_usec / 1e6
+	end
+
+	batch = {
+		backend = "c",
+		readBatch = readBatch,
+		harvest = harvest,
+		timestamp = timestamp,
+	}
+end
+
+-- Coroutine scheduler: Device:readAsync() yields its device when nothing
+-- is ready, and run() waits on every yielded device with one Poller,
+-- resuming each coroutine with the event its device produced
+local poller
+local ready = {} -- coroutines to resume, with their resume arguments
+local waiting = {} -- device -> the coroutine waiting on it
+
+local unpack = table.unpack or unpack
+
+local function spawn(fn, ...)
+	local co = coroutine.create(fn)
+	ready[#ready + 1] = { co, n = select("#", ...), ... }
+	return co
+end
+
+local function step(co, ...)
+	local ok, device = coroutine.resume(co, ...)
+	if not ok then
+		error(debug.traceback(co, device), 0)
+	elseif coroutine.status(co) == "dead" then
+		return
+	elseif device == nil then
+		-- a plain coroutine.yield() lets the others run first
+		ready[#ready + 1] = { co, n = 0 }
+	elseif waiting[device] then
+		error("device is already awaited by another coroutine", 0)
+	else
+		waiting[device] = co
+		poller:add(device)
+	end
+end
+
+-- a device closed while awaited (by another coroutine or a rate limit)
+-- has left the epoll set, so its coroutine is resumed with why
+local function resumeEnded()
+	for device, co in pairs(waiting) do
+		local reason = device:ended()
+		if reason then
+			waiting[device] = nil
+			poller:remove(device)
+			ready[#ready + 1] = { co, n = 2, nil, reason }
+		end
+	end
+end
+
+local function loop()
+	while true do
+		local batch = ready
+		ready = {}
+		for i = 1, #batch do
+			local entry = batch[i]
+			step(entry[1], unpack(entry, 2, entry.n + 1))
+		end
+
+		if #ready == 0 then
+			resumeEnded()
+		end
+		if #ready == 0 then
+			if next(waiting) == nil then
+				return
+			end
+			-- debounced transitions settle without the fd turning readable
+			local timeout
+			for device in pairs(waiting) do
+				local t = device:timeout()
+				if t and (not timeout or t < timeout) then
+					timeout = t
+				end
+			end
+			local woke = { poller:wait(timeout) }
+			if #woke == 0 then
+				for device in pairs(waiting) do
+					if device:timeout() == 0 then
+						woke[#woke + 1] = device
+					end
+				end
+			end
+			for i = 1, #woke do
+				local device = woke[i]
+				local co = waiting[device]
+				waiting[device] = nil
+				poller:remove(device)
+				-- an earlier coroutine may have closed it just now
+				local reason = device:ended()
+				if reason then
+					step(co, nil, reason)
+				else
+					step(co, device:tryRead())
+				end
+			end
+		end
+	end
+end
+
+local function run()
+	poller = poller or c.Poller()
+	local ok, err = pcall(loop)
+	if not ok then
+		-- start afresh next time rather than with the failed run's waiters
+		poller:close()
+		poller, ready, waiting = nil, {}, {}
+		error(err, 0)
+	end
+end
+
 return setmetatable({
 	Device = c.Device,
 	Uinput = c.Uinput,
+	Trackpad = c.Trackpad,
+	Aggregate = c.Aggregate,
+	Forwarder = c.Forwarder,
+	Pool = c.Pool,
+	Group = c.Group,
+	Generator = c.Generator,
+	Meter = c.Meter,
+	Dispatcher = c.Dispatcher,
+	Hotkeys = c.Hotkeys,
+	Recorder = c.Recorder,
+	Replay = c.Replay,
+	Merge = c.Merge,
+	Ring = c.Ring,
+	Poller = c.Poller,
+	flightSignal = c.flightSignal,
+	metrics = c.metrics,
+	sendState = c.sendState,
+	receiveState = c.receiveState,
+	name = c.name,
+	section = c.section,
+	monotonic = c.monotonic,
+	spawn = spawn,
+	run = run,
+	readBatch = batch.readBatch,
+	harvest = batch.harvest,
+	timestamp = batch.timestamp,
+	backend = batch.backend,
 }, {
 	__index = constants
 })
@@ -0,0 +1,2622 @@
+/* Constants for the Linux evdev API
+ * created by the gen-constants.lua script from the <linux/input.h> header
+ *
+ * Each name is guarded, so building against older headers only leaves
+ * out what they don't define. */
+
+struct evdevConstant {
+	const char *name;
+	int value;
+	int alias; /* another name for a value, or a limit; never a code's name */
+};
+
+struct evdevConstantSection {
+	const char *prefix;
+	const struct evdevConstant *constants;
+	int count;
+};
+
+/* Event Types */
+static const struct evdevConstant evdevConstants_EV[] = {
+#ifdef EV_VERSION
+	{ "EV_VERSION", EV_VERSION, 0 },
+#endif
+#ifdef EV_SYN
+	{ "EV_SYN", EV_SYN, 0 },
+#endif
+#ifdef EV_KEY
+	{ "EV_KEY", EV_KEY, 0 },
+#endif
+#ifdef EV_REL
+	{ "EV_REL", EV_REL, 0 },
+#endif
+#ifdef EV_ABS
+	{ "EV_ABS", EV_ABS, 0 },
+#endif
+#ifdef EV_MSC
+	{ "EV_MSC", EV_MSC, 0 },
+#endif
+#ifdef EV_SW
+	{ "EV_SW", EV_SW, 0 },
+#endif
+#ifdef EV_LED
+	{ "EV_LED", EV_LED, 0 },
+#endif
+#ifdef EV_SND
+	{ "EV_SND", EV_SND, 0 },
+#endif
+#ifdef EV_REP
+	{ "EV_REP", EV_REP, 0 },
+#endif
+#ifdef EV_FF
+	{ "EV_FF", EV_FF, 0 },
+#endif
+#ifdef EV_PWR
+	{ "EV_PWR", EV_PWR, 0 },
+#endif
+#ifdef EV_FF_STATUS
+	{ "EV_FF_STATUS", EV_FF_STATUS, 0 },
+#endif
+#ifdef EV_MAX
+	{ "EV_MAX", EV_MAX, 1 },
+#endif
+#ifdef EV_CNT
+	{ "EV_CNT", EV_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Synchronization */
+static const struct evdevConstant evdevConstants_SYN[] = {
+#ifdef SYN_REPORT
+	{ "SYN_REPORT", SYN_REPORT, 0 },
+#endif
+#ifdef SYN_CONFIG
+	{ "SYN_CONFIG", SYN_CONFIG, 0 },
+#endif
+#ifdef SYN_MT_REPORT
+	{ "SYN_MT_REPORT", SYN_MT_REPORT, 0 },
+#endif
+#ifdef SYN_DROPPED
+	{ "SYN_DROPPED", SYN_DROPPED, 0 },
+#endif
+#ifdef SYN_MAX
+	{ "SYN_MAX", SYN_MAX, 1 },
+#endif
+#ifdef SYN_CNT
+	{ "SYN_CNT", SYN_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Keys */
+static const struct evdevConstant evdevConstants_KEY[] = {
+#ifdef KEY_RESERVED
+	{ "KEY_RESERVED", KEY_RESERVED, 0 },
+#endif
+#ifdef KEY_ESC
+	{ "KEY_ESC", KEY_ESC, 0 },
+#endif
+#ifdef KEY_1
+	{ "KEY_1", KEY_1, 0 },
+#endif
+#ifdef KEY_2
+	{ "KEY_2", KEY_2, 0 },
+#endif
+#ifdef KEY_3
+	{ "KEY_3", KEY_3, 0 },
+#endif
+#ifdef KEY_4
+	{ "KEY_4", KEY_4, 0 },
+#endif
+#ifdef KEY_5
+	{ "KEY_5", KEY_5, 0 },
+#endif
+#ifdef KEY_6
+	{ "KEY_6", KEY_6, 0 },
+#endif
+#ifdef KEY_7
+	{ "KEY_7", KEY_7, 0 },
+#endif
+#ifdef KEY_8
+	{ "KEY_8", KEY_8, 0 },
+#endif
+#ifdef KEY_9
+	{ "KEY_9", KEY_9, 0 },
+#endif
+#ifdef KEY_0
+	{ "KEY_0", KEY_0, 0 },
+#endif
+#ifdef KEY_MINUS
+	{ "KEY_MINUS", KEY_MINUS, 0 },
+#endif
+#ifdef KEY_EQUAL
+	{ "KEY_EQUAL", KEY_EQUAL, 0 },
+#endif
+#ifdef KEY_BACKSPACE
+	{ "KEY_BACKSPACE", KEY_BACKSPACE, 0 },
+#endif
+#ifdef KEY_TAB
+	{ "KEY_TAB", KEY_TAB, 0 },
+#endif
+#ifdef KEY_Q
+	{ "KEY_Q", KEY_Q, 0 },
+#endif
+#ifdef KEY_W
+	{ "KEY_W", KEY_W, 0 },
+#endif
+#ifdef KEY_E
+	{ "KEY_E", KEY_E, 0 },
+#endif
+#ifdef KEY_R
+	{ "KEY_R", KEY_R, 0 },
+#endif
+#ifdef KEY_T
+	{ "KEY_T", KEY_T, 0 },
+#endif
+#ifdef KEY_Y
+	{ "KEY_Y", KEY_Y, 0 },
+#endif
+#ifdef KEY_U
+	{ "KEY_U", KEY_U, 0 },
+#endif
+#ifdef KEY_I
+	{ "KEY_I", KEY_I, 0 },
+#endif
+#ifdef KEY_O
+	{ "KEY_O", KEY_O, 0 },
+#endif
+#ifdef KEY_P
+	{ "KEY_P", KEY_P, 0 },
+#endif
+#ifdef KEY_LEFTBRACE
+	{ "KEY_LEFTBRACE", KEY_LEFTBRACE, 0 },
+#endif
+#ifdef KEY_RIGHTBRACE
+	{ "KEY_RIGHTBRACE", KEY_RIGHTBRACE, 0 },
+#endif
+#ifdef KEY_ENTER
+	{ "KEY_ENTER", KEY_ENTER, 0 },
+#endif
+#ifdef KEY_LEFTCTRL
+	{ "KEY_LEFTCTRL", KEY_LEFTCTRL, 0 },
+#endif
+#ifdef KEY_A
+	{ "KEY_A", KEY_A, 0 },
+#endif
+#ifdef KEY_S
+	{ "KEY_S", KEY_S, 0 },
+#endif
+#ifdef KEY_D
+	{ "KEY_D", KEY_D, 0 },
+#endif
+#ifdef KEY_F
+	{ "KEY_F", KEY_F, 0 },
+#endif
+#ifdef KEY_G
+	{ "KEY_G", KEY_G, 0 },
+#endif
+#ifdef KEY_H
+	{ "KEY_H", KEY_H, 0 },
+#endif
+#ifdef KEY_J
+	{ "KEY_J", KEY_J, 0 },
+#endif
+#ifdef KEY_K
+	{ "KEY_K", KEY_K, 0 },
+#endif
+#ifdef KEY_L
+	{ "KEY_L", KEY_L, 0 },
+#endif
+#ifdef KEY_SEMICOLON
+	{ "KEY_SEMICOLON", KEY_SEMICOLON, 0 },
+#endif
+#ifdef KEY_APOSTROPHE
+	{ "KEY_APOSTROPHE", KEY_APOSTROPHE, 0 },
+#endif
+#ifdef KEY_GRAVE
+	{ "KEY_GRAVE", KEY_GRAVE, 0 },
+#endif
+#ifdef KEY_LEFTSHIFT
+	{ "KEY_LEFTSHIFT", KEY_LEFTSHIFT, 0 },
+#endif
+#ifdef KEY_BACKSLASH
+	{ "KEY_BACKSLASH", KEY_BACKSLASH, 0 },
+#endif
+#ifdef KEY_Z
+	{ "KEY_Z", KEY_Z, 0 },
+#endif
+#ifdef KEY_X
+	{ "KEY_X", KEY_X, 0 },
+#endif
+#ifdef KEY_C
+	{ "KEY_C", KEY_C, 0 },
+#endif
+#ifdef KEY_V
+	{ "KEY_V", KEY_V, 0 },
+#endif
+#ifdef KEY_B
+	{ "KEY_B", KEY_B, 0 },
+#endif
+#ifdef KEY_N
+	{ "KEY_N", KEY_N, 0 },
+#endif
+#ifdef KEY_M
+	{ "KEY_M", KEY_M, 0 },
+#endif
+#ifdef KEY_COMMA
+	{ "KEY_COMMA", KEY_COMMA, 0 },
+#endif
+#ifdef KEY_DOT
+	{ "KEY_DOT", KEY_DOT, 0 },
+#endif
+#ifdef KEY_SLASH
+	{ "KEY_SLASH", KEY_SLASH, 0 },
+#endif
+#ifdef KEY_RIGHTSHIFT
+	{ "KEY_RIGHTSHIFT", KEY_RIGHTSHIFT, 0 },
+#endif
+#ifdef KEY_KPASTERISK
+	{ "KEY_KPASTERISK", KEY_KPASTERISK, 0 },
+#endif
+#ifdef KEY_LEFTALT
+	{ "KEY_LEFTALT", KEY_LEFTALT, 0 },
+#endif
+#ifdef KEY_SPACE
+	{ "KEY_SPACE", KEY_SPACE, 0 },
+#endif
+#ifdef KEY_CAPSLOCK
+	{ "KEY_CAPSLOCK", KEY_CAPSLOCK, 0 },
+#endif
+#ifdef KEY_F1
+	{ "KEY_F1", KEY_F1, 0 },
+#endif
+#ifdef KEY_F2
+	{ "KEY_F2", KEY_F2, 0 },
+#endif
+#ifdef KEY_F3
+	{ "KEY_F3", KEY_F3, 0 },
+#endif
+#ifdef KEY_F4
+	{ "KEY_F4", KEY_F4, 0 },
+#endif
+#ifdef KEY_F5
+	{ "KEY_F5", KEY_F5, 0 },
+#endif
+#ifdef KEY_F6
+	{ "KEY_F6", KEY_F6, 0 },
+#endif
+#ifdef KEY_F7
+	{ "KEY_F7", KEY_F7, 0 },
+#endif
+#ifdef KEY_F8
+	{ "KEY_F8", KEY_F8, 0 },
+#endif
+#ifdef KEY_F9
+	{ "KEY_F9", KEY_F9, 0 },
+#endif
+#ifdef KEY_F10
+	{ "KEY_F10", KEY_F10, 0 },
+#endif
+#ifdef KEY_NUMLOCK
+	{ "KEY_NUMLOCK", KEY_NUMLOCK, 0 },
+#endif
+#ifdef KEY_SCROLLLOCK
+	{ "KEY_SCROLLLOCK", KEY_SCROLLLOCK, 0 },
+#endif
+#ifdef KEY_KP7
+	{ "KEY_KP7", KEY_KP7, 0 },
+#endif
+#ifdef KEY_KP8
+	{ "KEY_KP8", KEY_KP8, 0 },
+#endif
+#ifdef KEY_KP9
+	{ "KEY_KP9", KEY_KP9, 0 },
+#endif
+#ifdef KEY_KPMINUS
+	{ "KEY_KPMINUS", KEY_KPMINUS, 0 },
+#endif
+#ifdef KEY_KP4
+	{ "KEY_KP4", KEY_KP4, 0 },
+#endif
+#ifdef KEY_KP5
+	{ "KEY_KP5", KEY_KP5, 0 },
+#endif
+#ifdef KEY_KP6
+	{ "KEY_KP6", KEY_KP6, 0 },
+#endif
+#ifdef KEY_KPPLUS
+	{ "KEY_KPPLUS", KEY_KPPLUS, 0 },
+#endif
+#ifdef KEY_KP1
+	{ "KEY_KP1", KEY_KP1, 0 },
+#endif
+#ifdef KEY_KP2
+	{ "KEY_KP2", KEY_KP2, 0 },
+#endif
+#ifdef KEY_KP3
+	{ "KEY_KP3", KEY_KP3, 0 },
+#endif
+#ifdef KEY_KP0
+	{ "KEY_KP0", KEY_KP0, 0 },
+#endif
+#ifdef KEY_KPDOT
+	{ "KEY_KPDOT", KEY_KPDOT, 0 },
+#endif
+#ifdef KEY_ZENKAKUHANKAKU
+	{ "KEY_ZENKAKUHANKAKU", KEY_ZENKAKUHANKAKU, 0 },
+#endif
+#ifdef KEY_102ND
+	{ "KEY_102ND", KEY_102ND, 0 },
+#endif
+#ifdef KEY_F11
+	{ "KEY_F11", KEY_F11, 0 },
+#endif
+#ifdef KEY_F12
+	{ "KEY_F12", KEY_F12, 0 },
+#endif
+#ifdef KEY_RO
+	{ "KEY_RO", KEY_RO, 0 },
+#endif
+#ifdef KEY_KATAKANA
+	{ "KEY_KATAKANA", KEY_KATAKANA, 0 },
+#endif
+#ifdef KEY_HIRAGANA
+	{ "KEY_HIRAGANA", KEY_HIRAGANA, 0 },
+#endif
+#ifdef KEY_HENKAN
+	{ "KEY_HENKAN", KEY_HENKAN, 0 },
+#endif
+#ifdef KEY_KATAKANAHIRAGANA
+	{ "KEY_KATAKANAHIRAGANA", KEY_KATAKANAHIRAGANA, 0 },
+#endif
+#ifdef KEY_MUHENKAN
+	{ "KEY_MUHENKAN", KEY_MUHENKAN, 0 },
+#endif
+#ifdef KEY_KPJPCOMMA
+	{ "KEY_KPJPCOMMA", KEY_KPJPCOMMA, 0 },
+#endif
+#ifdef KEY_KPENTER
+	{ "KEY_KPENTER", KEY_KPENTER, 0 },
+#endif
+#ifdef KEY_RIGHTCTRL
+	{ "KEY_RIGHTCTRL", KEY_RIGHTCTRL, 0 },
+#endif
+#ifdef KEY_KPSLASH
+	{ "KEY_KPSLASH", KEY_KPSLASH, 0 },
+#endif
+#ifdef KEY_SYSRQ
+	{ "KEY_SYSRQ", KEY_SYSRQ, 0 },
+#endif
+#ifdef KEY_RIGHTALT
+	{ "KEY_RIGHTALT", KEY_RIGHTALT, 0 },
+#endif
+#ifdef KEY_LINEFEED
+	{ "KEY_LINEFEED", KEY_LINEFEED, 0 },
+#endif
+#ifdef KEY_HOME
+	{ "KEY_HOME", KEY_HOME, 0 },
+#endif
+#ifdef KEY_UP
+	{ "KEY_UP", KEY_UP, 0 },
+#endif
+#ifdef KEY_PAGEUP
+	{ "KEY_PAGEUP", KEY_PAGEUP, 0 },
+#endif
+#ifdef KEY_LEFT
+	{ "KEY_LEFT", KEY_LEFT, 0 },
+#endif
+#ifdef KEY_RIGHT
+	{ "KEY_RIGHT", KEY_RIGHT, 0 },
+#endif
+#ifdef KEY_END
+	{ "KEY_END", KEY_END, 0 },
+#endif
+#ifdef KEY_DOWN
+	{ "KEY_DOWN", KEY_DOWN, 0 },
+#endif
+#ifdef KEY_PAGEDOWN
+	{ "KEY_PAGEDOWN", KEY_PAGEDOWN, 0 },
+#endif
+#ifdef KEY_INSERT
+	{ "KEY_INSERT", KEY_INSERT, 0 },
+#endif
+#ifdef KEY_DELETE
+	{ "KEY_DELETE", KEY_DELETE, 0 },
+#endif
+#ifdef KEY_MACRO
+	{ "KEY_MACRO", KEY_MACRO, 0 },
+#endif
+#ifdef KEY_MUTE
+	{ "KEY_MUTE", KEY_MUTE, 0 },
+#endif
+#ifdef KEY_VOLUMEDOWN
+	{ "KEY_VOLUMEDOWN", KEY_VOLUMEDOWN, 0 },
+#endif
+#ifdef KEY_VOLUMEUP
+	{ "KEY_VOLUMEUP", KEY_VOLUMEUP, 0 },
+#endif
+#ifdef KEY_POWER
+	{ "KEY_POWER", KEY_POWER, 0 },
+#endif
+#ifdef KEY_KPEQUAL
+	{ "KEY_KPEQUAL", KEY_KPEQUAL, 0 },
+#endif
+#ifdef KEY_KPPLUSMINUS
+	{ "KEY_KPPLUSMINUS", KEY_KPPLUSMINUS, 0 },
+#endif
+#ifdef KEY_PAUSE
+	{ "KEY_PAUSE", KEY_PAUSE, 0 },
+#endif
+#ifdef KEY_SCALE
+	{ "KEY_SCALE", KEY_SCALE, 0 },
+#endif
+#ifdef KEY_KPCOMMA
+	{ "KEY_KPCOMMA", KEY_KPCOMMA, 0 },
+#endif
+#ifdef KEY_HANGEUL
+	{ "KEY_HANGEUL", KEY_HANGEUL, 0 },
+#endif
+#ifdef KEY_HANGUEL
+	{ "KEY_HANGUEL", KEY_HANGUEL, 1 },
+#endif
+#ifdef KEY_HANJA
+	{ "KEY_HANJA", KEY_HANJA, 0 },
+#endif
+#ifdef KEY_YEN
+	{ "KEY_YEN", KEY_YEN, 0 },
+#endif
+#ifdef KEY_LEFTMETA
+	{ "KEY_LEFTMETA", KEY_LEFTMETA, 0 },
+#endif
+#ifdef KEY_RIGHTMETA
+	{ "KEY_RIGHTMETA", KEY_RIGHTMETA, 0 },
+#endif
+#ifdef KEY_COMPOSE
+	{ "KEY_COMPOSE", KEY_COMPOSE, 0 },
+#endif
+#ifdef KEY_STOP
+	{ "KEY_STOP", KEY_STOP, 0 },
+#endif
+#ifdef KEY_AGAIN
+	{ "KEY_AGAIN", KEY_AGAIN, 0 },
+#endif
+#ifdef KEY_PROPS
+	{ "KEY_PROPS", KEY_PROPS, 0 },
+#endif
+#ifdef KEY_UNDO
+	{ "KEY_UNDO", KEY_UNDO, 0 },
+#endif
+#ifdef KEY_FRONT
+	{ "KEY_FRONT", KEY_FRONT, 0 },
+#endif
+#ifdef KEY_COPY
+	{ "KEY_COPY", KEY_COPY, 0 },
+#endif
+#ifdef KEY_OPEN
+	{ "KEY_OPEN", KEY_OPEN, 0 },
+#endif
+#ifdef KEY_PASTE
+	{ "KEY_PASTE", KEY_PASTE, 0 },
+#endif
+#ifdef KEY_FIND
+	{ "KEY_FIND", KEY_FIND, 0 },
+#endif
+#ifdef KEY_CUT
+	{ "KEY_CUT", KEY_CUT, 0 },
+#endif
+#ifdef KEY_HELP
+	{ "KEY_HELP", KEY_HELP, 0 },
+#endif
+#ifdef KEY_MENU
+	{ "KEY_MENU", KEY_MENU, 0 },
+#endif
+#ifdef KEY_CALC
+	{ "KEY_CALC", KEY_CALC, 0 },
+#endif
+#ifdef KEY_SETUP
+	{ "KEY_SETUP", KEY_SETUP, 0 },
+#endif
+#ifdef KEY_SLEEP
+	{ "KEY_SLEEP", KEY_SLEEP, 0 },
+#endif
+#ifdef KEY_WAKEUP
+	{ "KEY_WAKEUP", KEY_WAKEUP, 0 },
+#endif
+#ifdef KEY_FILE
+	{ "KEY_FILE", KEY_FILE, 0 },
+#endif
+#ifdef KEY_SENDFILE
+	{ "KEY_SENDFILE", KEY_SENDFILE, 0 },
+#endif
+#ifdef KEY_DELETEFILE
+	{ "KEY_DELETEFILE", KEY_DELETEFILE, 0 },
+#endif
+#ifdef KEY_XFER
+	{ "KEY_XFER", KEY_XFER, 0 },
+#endif
+#ifdef KEY_PROG1
+	{ "KEY_PROG1", KEY_PROG1, 0 },
+#endif
+#ifdef KEY_PROG2
+	{ "KEY_PROG2", KEY_PROG2, 0 },
+#endif
+#ifdef KEY_WWW
+	{ "KEY_WWW", KEY_WWW, 0 },
+#endif
+#ifdef KEY_MSDOS
+	{ "KEY_MSDOS", KEY_MSDOS, 0 },
+#endif
+#ifdef KEY_COFFEE
+	{ "KEY_COFFEE", KEY_COFFEE, 0 },
+#endif
+#ifdef KEY_SCREENLOCK
+	{ "KEY_SCREENLOCK", KEY_SCREENLOCK, 1 },
+#endif
+#ifdef KEY_ROTATE_DISPLAY
+	{ "KEY_ROTATE_DISPLAY", KEY_ROTATE_DISPLAY, 0 },
+#endif
+#ifdef KEY_DIRECTION
+	{ "KEY_DIRECTION", KEY_DIRECTION, 1 },
+#endif
+#ifdef KEY_CYCLEWINDOWS
+	{ "KEY_CYCLEWINDOWS", KEY_CYCLEWINDOWS, 0 },
+#endif
+#ifdef KEY_MAIL
+	{ "KEY_MAIL", KEY_MAIL, 0 },
+#endif
+#ifdef KEY_BOOKMARKS
+	{ "KEY_BOOKMARKS", KEY_BOOKMARKS, 0 },
+#endif
+#ifdef KEY_COMPUTER
+	{ "KEY_COMPUTER", KEY_COMPUTER, 0 },
+#endif
+#ifdef KEY_BACK
+	{ "KEY_BACK", KEY_BACK, 0 },
+#endif
+#ifdef KEY_FORWARD
+	{ "KEY_FORWARD", KEY_FORWARD, 0 },
+#endif
+#ifdef KEY_CLOSECD
+	{ "KEY_CLOSECD", KEY_CLOSECD, 0 },
+#endif
+#ifdef KEY_EJECTCD
+	{ "KEY_EJECTCD", KEY_EJECTCD, 0 },
+#endif
+#ifdef KEY_EJECTCLOSECD
+	{ "KEY_EJECTCLOSECD", KEY_EJECTCLOSECD, 0 },
+#endif
+#ifdef KEY_NEXTSONG
+	{ "KEY_NEXTSONG", KEY_NEXTSONG, 0 },
+#endif
+#ifdef KEY_PLAYPAUSE
+	{ "KEY_PLAYPAUSE", KEY_PLAYPAUSE, 0 },
+#endif
+#ifdef KEY_PREVIOUSSONG
+	{ "KEY_PREVIOUSSONG", KEY_PREVIOUSSONG, 0 },
+#endif
+#ifdef KEY_STOPCD
+	{ "KEY_STOPCD", KEY_STOPCD, 0 },
+#endif
+#ifdef KEY_RECORD
+	{ "KEY_RECORD", KEY_RECORD, 0 },
+#endif
+#ifdef KEY_REWIND
+	{ "KEY_REWIND", KEY_REWIND, 0 },
+#endif
+#ifdef KEY_PHONE
+	{ "KEY_PHONE", KEY_PHONE, 0 },
+#endif
+#ifdef KEY_ISO
+	{ "KEY_ISO", KEY_ISO, 0 },
+#endif
+#ifdef KEY_CONFIG
+	{ "KEY_CONFIG", KEY_CONFIG, 0 },
+#endif
+#ifdef KEY_HOMEPAGE
+	{ "KEY_HOMEPAGE", KEY_HOMEPAGE, 0 },
+#endif
+#ifdef KEY_REFRESH
+	{ "KEY_REFRESH", KEY_REFRESH, 0 },
+#endif
+#ifdef KEY_EXIT
+	{ "KEY_EXIT", KEY_EXIT, 0 },
+#endif
+#ifdef KEY_MOVE
+	{ "KEY_MOVE", KEY_MOVE, 0 },
+#endif
+#ifdef KEY_EDIT
+	{ "KEY_EDIT", KEY_EDIT, 0 },
+#endif
+#ifdef KEY_SCROLLUP
+	{ "KEY_SCROLLUP", KEY_SCROLLUP, 0 },
+#endif
+#ifdef KEY_SCROLLDOWN
+	{ "KEY_SCROLLDOWN", KEY_SCROLLDOWN, 0 },
+#endif
+#ifdef KEY_KPLEFTPAREN
+	{ "KEY_KPLEFTPAREN", KEY_KPLEFTPAREN, 0 },
+#endif
+#ifdef KEY_KPRIGHTPAREN
+	{ "KEY_KPRIGHTPAREN", KEY_KPRIGHTPAREN, 0 },
+#endif
+#ifdef KEY_NEW
+	{ "KEY_NEW", KEY_NEW, 0 },
+#endif
+#ifdef KEY_REDO
+	{ "KEY_REDO", KEY_REDO, 0 },
+#endif
+#ifdef KEY_F13
+	{ "KEY_F13", KEY_F13, 0 },
+#endif
+#ifdef KEY_F14
+	{ "KEY_F14", KEY_F14, 0 },
+#endif
+#ifdef KEY_F15
+	{ "KEY_F15", KEY_F15, 0 },
+#endif
+#ifdef KEY_F16
+	{ "KEY_F16", KEY_F16, 0 },
+#endif
+#ifdef KEY_F17
+	{ "KEY_F17", KEY_F17, 0 },
+#endif
+#ifdef KEY_F18
+	{ "KEY_F18", KEY_F18, 0 },
+#endif
+#ifdef KEY_F19
+	{ "KEY_F19", KEY_F19, 0 },
+#endif
+#ifdef KEY_F20
+	{ "KEY_F20", KEY_F20, 0 },
+#endif
+#ifdef KEY_F21
+	{ "KEY_F21", KEY_F21, 0 },
+#endif
+#ifdef KEY_F22
+	{ "KEY_F22", KEY_F22, 0 },
+#endif
+#ifdef KEY_F23
+	{ "KEY_F23", KEY_F23, 0 },
+#endif
+#ifdef KEY_F24
+	{ "KEY_F24", KEY_F24, 0 },
+#endif
+#ifdef KEY_PLAYCD
+	{ "KEY_PLAYCD", KEY_PLAYCD, 0 },
+#endif
+#ifdef KEY_PAUSECD
+	{ "KEY_PAUSECD", KEY_PAUSECD, 0 },
+#endif
+#ifdef KEY_PROG3
+	{ "KEY_PROG3", KEY_PROG3, 0 },
+#endif
+#ifdef KEY_PROG4
+	{ "KEY_PROG4", KEY_PROG4, 0 },
+#endif
+#ifdef KEY_ALL_APPLICATIONS
+	{ "KEY_ALL_APPLICATIONS", KEY_ALL_APPLICATIONS, 0 },
+#endif
+#ifdef KEY_DASHBOARD
+	{ "KEY_DASHBOARD", KEY_DASHBOARD, 1 },
+#endif
+#ifdef KEY_SUSPEND
+	{ "KEY_SUSPEND", KEY_SUSPEND, 0 },
+#endif
+#ifdef KEY_CLOSE
+	{ "KEY_CLOSE", KEY_CLOSE, 0 },
+#endif
+#ifdef KEY_PLAY
+	{ "KEY_PLAY", KEY_PLAY, 0 },
+#endif
+#ifdef KEY_FASTFORWARD
+	{ "KEY_FASTFORWARD", KEY_FASTFORWARD, 0 },
+#endif
+#ifdef KEY_BASSBOOST
+	{ "KEY_BASSBOOST", KEY_BASSBOOST, 0 },
+#endif
+#ifdef KEY_PRINT
+	{ "KEY_PRINT", KEY_PRINT, 0 },
+#endif
+#ifdef KEY_HP
+	{ "KEY_HP", KEY_HP, 0 },
+#endif
+#ifdef KEY_CAMERA
+	{ "KEY_CAMERA", KEY_CAMERA, 0 },
+#endif
+#ifdef KEY_SOUND
+	{ "KEY_SOUND", KEY_SOUND, 0 },
+#endif
+#ifdef KEY_QUESTION
+	{ "KEY_QUESTION", KEY_QUESTION, 0 },
+#endif
+#ifdef KEY_EMAIL
+	{ "KEY_EMAIL", KEY_EMAIL, 0 },
+#endif
+#ifdef KEY_CHAT
+	{ "KEY_CHAT", KEY_CHAT, 0 },
+#endif
+#ifdef KEY_SEARCH
+	{ "KEY_SEARCH", KEY_SEARCH, 0 },
+#endif
+#ifdef KEY_CONNECT
+	{ "KEY_CONNECT", KEY_CONNECT, 0 },
+#endif
+#ifdef KEY_FINANCE
+	{ "KEY_FINANCE", KEY_FINANCE, 0 },
+#endif
+#ifdef KEY_SPORT
+	{ "KEY_SPORT", KEY_SPORT, 0 },
+#endif
+#ifdef KEY_SHOP
+	{ "KEY_SHOP", KEY_SHOP, 0 },
+#endif
+#ifdef KEY_ALTERASE
+	{ "KEY_ALTERASE", KEY_ALTERASE, 0 },
+#endif
+#ifdef KEY_CANCEL
+	{ "KEY_CANCEL", KEY_CANCEL, 0 },
+#endif
+#ifdef KEY_BRIGHTNESSDOWN
+	{ "KEY_BRIGHTNESSDOWN", KEY_BRIGHTNESSDOWN, 0 },
+#endif
+#ifdef KEY_BRIGHTNESSUP
+	{ "KEY_BRIGHTNESSUP", KEY_BRIGHTNESSUP, 0 },
+#endif
+#ifdef KEY_MEDIA
+	{ "KEY_MEDIA", KEY_MEDIA, 0 },
+#endif
+#ifdef KEY_SWITCHVIDEOMODE
+	{ "KEY_SWITCHVIDEOMODE", KEY_SWITCHVIDEOMODE, 0 },
+#endif
+#ifdef KEY_KBDILLUMTOGGLE
+	{ "KEY_KBDILLUMTOGGLE", KEY_KBDILLUMTOGGLE, 0 },
+#endif
+#ifdef KEY_KBDILLUMDOWN
+	{ "KEY_KBDILLUMDOWN", KEY_KBDILLUMDOWN, 0 },
+#endif
+#ifdef KEY_KBDILLUMUP
+	{ "KEY_KBDILLUMUP", KEY_KBDILLUMUP, 0 },
+#endif
+#ifdef KEY_SEND
+	{ "KEY_SEND", KEY_SEND, 0 },
+#endif
+#ifdef KEY_REPLY
+	{ "KEY_REPLY", KEY_REPLY, 0 },
+#endif
+#ifdef KEY_FORWARDMAIL
+	{ "KEY_FORWARDMAIL", KEY_FORWARDMAIL, 0 },
+#endif
+#ifdef KEY_SAVE
+	{ "KEY_SAVE", KEY_SAVE, 0 },
+#endif
+#ifdef KEY_DOCUMENTS
+	{ "KEY_DOCUMENTS", KEY_DOCUMENTS, 0 },
+#endif
+#ifdef KEY_BATTERY
+	{ "KEY_BATTERY", KEY_BATTERY, 0 },
+#endif
+#ifdef KEY_BLUETOOTH
+	{ "KEY_BLUETOOTH", KEY_BLUETOOTH, 0 },
+#endif
+#ifdef KEY_WLAN
+	{ "KEY_WLAN", KEY_WLAN, 0 },
+#endif
+#ifdef KEY_UWB
+	{ "KEY_UWB", KEY_UWB, 0 },
+#endif
+#ifdef KEY_UNKNOWN
+	{ "KEY_UNKNOWN", KEY_UNKNOWN, 0 },
+#endif
+#ifdef KEY_VIDEO_NEXT
+	{ "KEY_VIDEO_NEXT", KEY_VIDEO_NEXT, 0 },
+#endif
+#ifdef KEY_VIDEO_PREV
+	{ "KEY_VIDEO_PREV", KEY_VIDEO_PREV, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_CYCLE
+	{ "KEY_BRIGHTNESS_CYCLE", KEY_BRIGHTNESS_CYCLE, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_AUTO
+	{ "KEY_BRIGHTNESS_AUTO", KEY_BRIGHTNESS_AUTO, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_ZERO
+	{ "KEY_BRIGHTNESS_ZERO", KEY_BRIGHTNESS_ZERO, 1 },
+#endif
+#ifdef KEY_DISPLAY_OFF
+	{ "KEY_DISPLAY_OFF", KEY_DISPLAY_OFF, 0 },
+#endif
+#ifdef KEY_WWAN
+	{ "KEY_WWAN", KEY_WWAN, 0 },
+#endif
+#ifdef KEY_WIMAX
+	{ "KEY_WIMAX", KEY_WIMAX, 1 },
+#endif
+#ifdef KEY_RFKILL
+	{ "KEY_RFKILL", KEY_RFKILL, 0 },
+#endif
+#ifdef KEY_MICMUTE
+	{ "KEY_MICMUTE", KEY_MICMUTE, 0 },
+#endif
+#ifdef KEY_OK
+	{ "KEY_OK", KEY_OK, 0 },
+#endif
+#ifdef KEY_SELECT
+	{ "KEY_SELECT", KEY_SELECT, 0 },
+#endif
+#ifdef KEY_GOTO
+	{ "KEY_GOTO", KEY_GOTO, 0 },
+#endif
+#ifdef KEY_CLEAR
+	{ "KEY_CLEAR", KEY_CLEAR, 0 },
+#endif
+#ifdef KEY_POWER2
+	{ "KEY_POWER2", KEY_POWER2, 0 },
+#endif
+#ifdef KEY_OPTION
+	{ "KEY_OPTION", KEY_OPTION, 0 },
+#endif
+#ifdef KEY_INFO
+	{ "KEY_INFO", KEY_INFO, 0 },
+#endif
+#ifdef KEY_TIME
+	{ "KEY_TIME", KEY_TIME, 0 },
+#endif
+#ifdef KEY_VENDOR
+	{ "KEY_VENDOR", KEY_VENDOR, 0 },
+#endif
+#ifdef KEY_ARCHIVE
+	{ "KEY_ARCHIVE", KEY_ARCHIVE, 0 },
+#endif
+#ifdef KEY_PROGRAM
+	{ "KEY_PROGRAM", KEY_PROGRAM, 0 },
+#endif
+#ifdef KEY_CHANNEL
+	{ "KEY_CHANNEL", KEY_CHANNEL, 0 },
+#endif
+#ifdef KEY_FAVORITES
+	{ "KEY_FAVORITES", KEY_FAVORITES, 0 },
+#endif
+#ifdef KEY_EPG
+	{ "KEY_EPG", KEY_EPG, 0 },
+#endif
+#ifdef KEY_PVR
+	{ "KEY_PVR", KEY_PVR, 0 },
+#endif
+#ifdef KEY_MHP
+	{ "KEY_MHP", KEY_MHP, 0 },
+#endif
+#ifdef KEY_LANGUAGE
+	{ "KEY_LANGUAGE", KEY_LANGUAGE, 0 },
+#endif
+#ifdef KEY_TITLE
+	{ "KEY_TITLE", KEY_TITLE, 0 },
+#endif
+#ifdef KEY_SUBTITLE
+	{ "KEY_SUBTITLE", KEY_SUBTITLE, 0 },
+#endif
+#ifdef KEY_ANGLE
+	{ "KEY_ANGLE", KEY_ANGLE, 0 },
+#endif
+#ifdef KEY_FULL_SCREEN
+	{ "KEY_FULL_SCREEN", KEY_FULL_SCREEN, 0 },
+#endif
+#ifdef KEY_ZOOM
+	{ "KEY_ZOOM", KEY_ZOOM, 1 },
+#endif
+#ifdef KEY_MODE
+	{ "KEY_MODE", KEY_MODE, 0 },
+#endif
+#ifdef KEY_KEYBOARD
+	{ "KEY_KEYBOARD", KEY_KEYBOARD, 0 },
+#endif
+#ifdef KEY_ASPECT_RATIO
+	{ "KEY_ASPECT_RATIO", KEY_ASPECT_RATIO, 0 },
+#endif
+#ifdef KEY_SCREEN
+	{ "KEY_SCREEN", KEY_SCREEN, 1 },
+#endif
+#ifdef KEY_PC
+	{ "KEY_PC", KEY_PC, 0 },
+#endif
+#ifdef KEY_TV
+	{ "KEY_TV", KEY_TV, 0 },
+#endif
+#ifdef KEY_TV2
+	{ "KEY_TV2", KEY_TV2, 0 },
+#endif
+#ifdef KEY_VCR
+	{ "KEY_VCR", KEY_VCR, 0 },
+#endif
+#ifdef KEY_VCR2
+	{ "KEY_VCR2", KEY_VCR2, 0 },
+#endif
+#ifdef KEY_SAT
+	{ "KEY_SAT", KEY_SAT, 0 },
+#endif
+#ifdef KEY_SAT2
+	{ "KEY_SAT2", KEY_SAT2, 0 },
+#endif
+#ifdef KEY_CD
+	{ "KEY_CD", KEY_CD, 0 },
+#endif
+#ifdef KEY_TAPE
+	{ "KEY_TAPE", KEY_TAPE, 0 },
+#endif
+#ifdef KEY_RADIO
+	{ "KEY_RADIO", KEY_RADIO, 0 },
+#endif
+#ifdef KEY_TUNER
+	{ "KEY_TUNER", KEY_TUNER, 0 },
+#endif
+#ifdef KEY_PLAYER
+	{ "KEY_PLAYER", KEY_PLAYER, 0 },
+#endif
+#ifdef KEY_TEXT
+	{ "KEY_TEXT", KEY_TEXT, 0 },
+#endif
+#ifdef KEY_DVD
+	{ "KEY_DVD", KEY_DVD, 0 },
+#endif
+#ifdef KEY_AUX
+	{ "KEY_AUX", KEY_AUX, 0 },
+#endif
+#ifdef KEY_MP3
+	{ "KEY_MP3", KEY_MP3, 0 },
+#endif
+#ifdef KEY_AUDIO
+	{ "KEY_AUDIO", KEY_AUDIO, 0 },
+#endif
+#ifdef KEY_VIDEO
+	{ "KEY_VIDEO", KEY_VIDEO, 0 },
+#endif
+#ifdef KEY_DIRECTORY
+	{ "KEY_DIRECTORY", KEY_DIRECTORY, 0 },
+#endif
+#ifdef KEY_LIST
+	{ "KEY_LIST", KEY_LIST, 0 },
+#endif
+#ifdef KEY_MEMO
+	{ "KEY_MEMO", KEY_MEMO, 0 },
+#endif
+#ifdef KEY_CALENDAR
+	{ "KEY_CALENDAR", KEY_CALENDAR, 0 },
+#endif
+#ifdef KEY_RED
+	{ "KEY_RED", KEY_RED, 0 },
+#endif
+#ifdef KEY_GREEN
+	{ "KEY_GREEN", KEY_GREEN, 0 },
+#endif
+#ifdef KEY_YELLOW
+	{ "KEY_YELLOW", KEY_YELLOW, 0 },
+#endif
+#ifdef KEY_BLUE
+	{ "KEY_BLUE", KEY_BLUE, 0 },
+#endif
+#ifdef KEY_CHANNELUP
+	{ "KEY_CHANNELUP", KEY_CHANNELUP, 0 },
+#endif
+#ifdef KEY_CHANNELDOWN
+	{ "KEY_CHANNELDOWN", KEY_CHANNELDOWN, 0 },
+#endif
+#ifdef KEY_FIRST
+	{ "KEY_FIRST", KEY_FIRST, 0 },
+#endif
+#ifdef KEY_LAST
+	{ "KEY_LAST", KEY_LAST, 0 },
+#endif
+#ifdef KEY_AB
+	{ "KEY_AB", KEY_AB, 0 },
+#endif
+#ifdef KEY_NEXT
+	{ "KEY_NEXT", KEY_NEXT, 0 },
+#endif
+#ifdef KEY_RESTART
+	{ "KEY_RESTART", KEY_RESTART, 0 },
+#endif
+#ifdef KEY_SLOW
+	{ "KEY_SLOW", KEY_SLOW, 0 },
+#endif
+#ifdef KEY_SHUFFLE
+	{ "KEY_SHUFFLE", KEY_SHUFFLE, 0 },
+#endif
+#ifdef KEY_BREAK
+	{ "KEY_BREAK", KEY_BREAK, 0 },
+#endif
+#ifdef KEY_PREVIOUS
+	{ "KEY_PREVIOUS", KEY_PREVIOUS, 0 },
+#endif
+#ifdef KEY_DIGITS
+	{ "KEY_DIGITS", KEY_DIGITS, 0 },
+#endif
+#ifdef KEY_TEEN
+	{ "KEY_TEEN", KEY_TEEN, 0 },
+#endif
+#ifdef KEY_TWEN
+	{ "KEY_TWEN", KEY_TWEN, 0 },
+#endif
+#ifdef KEY_VIDEOPHONE
+	{ "KEY_VIDEOPHONE", KEY_VIDEOPHONE, 0 },
+#endif
+#ifdef KEY_GAMES
+	{ "KEY_GAMES", KEY_GAMES, 0 },
+#endif
+#ifdef KEY_ZOOMIN
+	{ "KEY_ZOOMIN", KEY_ZOOMIN, 0 },
+#endif
+#ifdef KEY_ZOOMOUT
+	{ "KEY_ZOOMOUT", KEY_ZOOMOUT, 0 },
+#endif
+#ifdef KEY_ZOOMRESET
+	{ "KEY_ZOOMRESET", KEY_ZOOMRESET, 0 },
+#endif
+#ifdef KEY_WORDPROCESSOR
+	{ "KEY_WORDPROCESSOR", KEY_WORDPROCESSOR, 0 },
+#endif
+#ifdef KEY_EDITOR
+	{ "KEY_EDITOR", KEY_EDITOR, 0 },
+#endif
+#ifdef KEY_SPREADSHEET
+	{ "KEY_SPREADSHEET", KEY_SPREADSHEET, 0 },
+#endif
+#ifdef KEY_GRAPHICSEDITOR
+	{ "KEY_GRAPHICSEDITOR", KEY_GRAPHICSEDITOR, 0 },
+#endif
+#ifdef KEY_PRESENTATION
+	{ "KEY_PRESENTATION", KEY_PRESENTATION, 0 },
+#endif
+#ifdef KEY_DATABASE
+	{ "KEY_DATABASE", KEY_DATABASE, 0 },
+#endif
+#ifdef KEY_NEWS
+	{ "KEY_NEWS", KEY_NEWS, 0 },
+#endif
+#ifdef KEY_VOICEMAIL
+	{ "KEY_VOICEMAIL", KEY_VOICEMAIL, 0 },
+#endif
+#ifdef KEY_ADDRESSBOOK
+	{ "KEY_ADDRESSBOOK", KEY_ADDRESSBOOK, 0 },
+#endif
+#ifdef KEY_MESSENGER
+	{ "KEY_MESSENGER", KEY_MESSENGER, 0 },
+#endif
+#ifdef KEY_DISPLAYTOGGLE
+	{ "KEY_DISPLAYTOGGLE", KEY_DISPLAYTOGGLE, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_TOGGLE
+	{ "KEY_BRIGHTNESS_TOGGLE", KEY_BRIGHTNESS_TOGGLE, 1 },
+#endif
+#ifdef KEY_SPELLCHECK
+	{ "KEY_SPELLCHECK", KEY_SPELLCHECK, 0 },
+#endif
+#ifdef KEY_LOGOFF
+	{ "KEY_LOGOFF", KEY_LOGOFF, 0 },
+#endif
+#ifdef KEY_DOLLAR
+	{ "KEY_DOLLAR", KEY_DOLLAR, 0 },
+#endif
+#ifdef KEY_EURO
+	{ "KEY_EURO", KEY_EURO, 0 },
+#endif
+#ifdef KEY_FRAMEBACK
+	{ "KEY_FRAMEBACK", KEY_FRAMEBACK, 0 },
+#endif
+#ifdef KEY_FRAMEFORWARD
+	{ "KEY_FRAMEFORWARD", KEY_FRAMEFORWARD, 0 },
+#endif
+#ifdef KEY_CONTEXT_MENU
+	{ "KEY_CONTEXT_MENU", KEY_CONTEXT_MENU, 0 },
+#endif
+#ifdef KEY_MEDIA_REPEAT
+	{ "KEY_MEDIA_REPEAT", KEY_MEDIA_REPEAT, 0 },
+#endif
+#ifdef KEY_10CHANNELSUP
+	{ "KEY_10CHANNELSUP", KEY_10CHANNELSUP, 0 },
+#endif
+#ifdef KEY_10CHANNELSDOWN
+	{ "KEY_10CHANNELSDOWN", KEY_10CHANNELSDOWN, 0 },
+#endif
+#ifdef KEY_IMAGES
+	{ "KEY_IMAGES", KEY_IMAGES, 0 },
+#endif
+#ifdef KEY_NOTIFICATION_CENTER
+	{ "KEY_NOTIFICATION_CENTER", KEY_NOTIFICATION_CENTER, 0 },
+#endif
+#ifdef KEY_PICKUP_PHONE
+	{ "KEY_PICKUP_PHONE", KEY_PICKUP_PHONE, 0 },
+#endif
+#ifdef KEY_HANGUP_PHONE
+	{ "KEY_HANGUP_PHONE", KEY_HANGUP_PHONE, 0 },
+#endif
+#ifdef KEY_LINK_PHONE
+	{ "KEY_LINK_PHONE", KEY_LINK_PHONE, 0 },
+#endif
+#ifdef KEY_DEL_EOL
+	{ "KEY_DEL_EOL", KEY_DEL_EOL, 0 },
+#endif
+#ifdef KEY_DEL_EOS
+	{ "KEY_DEL_EOS", KEY_DEL_EOS, 0 },
+#endif
+#ifdef KEY_INS_LINE
+	{ "KEY_INS_LINE", KEY_INS_LINE, 0 },
+#endif
+#ifdef KEY_DEL_LINE
+	{ "KEY_DEL_LINE", KEY_DEL_LINE, 0 },
+#endif
+#ifdef KEY_FN
+	{ "KEY_FN", KEY_FN, 0 },
+#endif
+#ifdef KEY_FN_ESC
+	{ "KEY_FN_ESC", KEY_FN_ESC, 0 },
+#endif
+#ifdef KEY_FN_F1
+	{ "KEY_FN_F1", KEY_FN_F1, 0 },
+#endif
+#ifdef KEY_FN_F2
+	{ "KEY_FN_F2", KEY_FN_F2, 0 },
+#endif
+#ifdef KEY_FN_F3
+	{ "KEY_FN_F3", KEY_FN_F3, 0 },
+#endif
+#ifdef KEY_FN_F4
+	{ "KEY_FN_F4", KEY_FN_F4, 0 },
+#endif
+#ifdef KEY_FN_F5
+	{ "KEY_FN_F5", KEY_FN_F5, 0 },
+#endif
+#ifdef KEY_FN_F6
+	{ "KEY_FN_F6", KEY_FN_F6, 0 },
+#endif
+#ifdef KEY_FN_F7
+	{ "KEY_FN_F7", KEY_FN_F7, 0 },
+#endif
+#ifdef KEY_FN_F8
+	{ "KEY_FN_F8", KEY_FN_F8, 0 },
+#endif
+#ifdef KEY_FN_F9
+	{ "KEY_FN_F9", KEY_FN_F9, 0 },
+#endif
+#ifdef KEY_FN_F10
+	{ "KEY_FN_F10", KEY_FN_F10, 0 },
+#endif
+#ifdef KEY_FN_F11
+	{ "KEY_FN_F11", KEY_FN_F11, 0 },
+#endif
+#ifdef KEY_FN_F12
+	{ "KEY_FN_F12", KEY_FN_F12, 0 },
+#endif
+#ifdef KEY_FN_1
+	{ "KEY_FN_1", KEY_FN_1, 0 },
+#endif
+#ifdef KEY_FN_2
+	{ "KEY_FN_2", KEY_FN_2, 0 },
+#endif
+#ifdef KEY_FN_D
+	{ "KEY_FN_D", KEY_FN_D, 0 },
+#endif
+#ifdef KEY_FN_E
+	{ "KEY_FN_E", KEY_FN_E, 0 },
+#endif
+#ifdef KEY_FN_F
+	{ "KEY_FN_F", KEY_FN_F, 0 },
+#endif
+#ifdef KEY_FN_S
+	{ "KEY_FN_S", KEY_FN_S, 0 },
+#endif
+#ifdef KEY_FN_B
+	{ "KEY_FN_B", KEY_FN_B, 0 },
+#endif
+#ifdef KEY_FN_RIGHT_SHIFT
+	{ "KEY_FN_RIGHT_SHIFT", KEY_FN_RIGHT_SHIFT, 0 },
+#endif
+#ifdef KEY_BRL_DOT1
+	{ "KEY_BRL_DOT1", KEY_BRL_DOT1, 0 },
+#endif
+#ifdef KEY_BRL_DOT2
+	{ "KEY_BRL_DOT2", KEY_BRL_DOT2, 0 },
+#endif
+#ifdef KEY_BRL_DOT3
+	{ "KEY_BRL_DOT3", KEY_BRL_DOT3, 0 },
+#endif
+#ifdef KEY_BRL_DOT4
+	{ "KEY_BRL_DOT4", KEY_BRL_DOT4, 0 },
+#endif
+#ifdef KEY_BRL_DOT5
+	{ "KEY_BRL_DOT5", KEY_BRL_DOT5, 0 },
+#endif
+#ifdef KEY_BRL_DOT6
+	{ "KEY_BRL_DOT6", KEY_BRL_DOT6, 0 },
+#endif
+#ifdef KEY_BRL_DOT7
+	{ "KEY_BRL_DOT7", KEY_BRL_DOT7, 0 },
+#endif
+#ifdef KEY_BRL_DOT8
+	{ "KEY_BRL_DOT8", KEY_BRL_DOT8, 0 },
+#endif
+#ifdef KEY_BRL_DOT9
+	{ "KEY_BRL_DOT9", KEY_BRL_DOT9, 0 },
+#endif
+#ifdef KEY_BRL_DOT10
+	{ "KEY_BRL_DOT10", KEY_BRL_DOT10, 0 },
+#endif
+#ifdef KEY_NUMERIC_0
+	{ "KEY_NUMERIC_0", KEY_NUMERIC_0, 0 },
+#endif
+#ifdef KEY_NUMERIC_1
+	{ "KEY_NUMERIC_1", KEY_NUMERIC_1, 0 },
+#endif
+#ifdef KEY_NUMERIC_2
+	{ "KEY_NUMERIC_2", KEY_NUMERIC_2, 0 },
+#endif
+#ifdef KEY_NUMERIC_3
+	{ "KEY_NUMERIC_3", KEY_NUMERIC_3, 0 },
+#endif
+#ifdef KEY_NUMERIC_4
+	{ "KEY_NUMERIC_4", KEY_NUMERIC_4, 0 },
+#endif
+#ifdef KEY_NUMERIC_5
+	{ "KEY_NUMERIC_5", KEY_NUMERIC_5, 0 },
+#endif
+#ifdef KEY_NUMERIC_6
+	{ "KEY_NUMERIC_6", KEY_NUMERIC_6, 0 },
+#endif
+#ifdef KEY_NUMERIC_7
+	{ "KEY_NUMERIC_7", KEY_NUMERIC_7, 0 },
+#endif
+#ifdef KEY_NUMERIC_8
+	{ "KEY_NUMERIC_8", KEY_NUMERIC_8, 0 },
+#endif
+#ifdef KEY_NUMERIC_9
+	{ "KEY_NUMERIC_9", KEY_NUMERIC_9, 0 },
+#endif
+#ifdef KEY_NUMERIC_STAR
+	{ "KEY_NUMERIC_STAR", KEY_NUMERIC_STAR, 0 },
+#endif
+#ifdef KEY_NUMERIC_POUND
+	{ "KEY_NUMERIC_POUND", KEY_NUMERIC_POUND, 0 },
+#endif
+#ifdef KEY_NUMERIC_A
+	{ "KEY_NUMERIC_A", KEY_NUMERIC_A, 0 },
+#endif
+#ifdef KEY_NUMERIC_B
+	{ "KEY_NUMERIC_B", KEY_NUMERIC_B, 0 },
+#endif
+#ifdef KEY_NUMERIC_C
+	{ "KEY_NUMERIC_C", KEY_NUMERIC_C, 0 },
+#endif
+#ifdef KEY_NUMERIC_D
+	{ "KEY_NUMERIC_D", KEY_NUMERIC_D, 0 },
+#endif
+#ifdef KEY_CAMERA_FOCUS
+	{ "KEY_CAMERA_FOCUS", KEY_CAMERA_FOCUS, 0 },
+#endif
+#ifdef KEY_WPS_BUTTON
+	{ "KEY_WPS_BUTTON", KEY_WPS_BUTTON, 0 },
+#endif
+#ifdef KEY_TOUCHPAD_TOGGLE
+	{ "KEY_TOUCHPAD_TOGGLE", KEY_TOUCHPAD_TOGGLE, 0 },
+#endif
+#ifdef KEY_TOUCHPAD_ON
+	{ "KEY_TOUCHPAD_ON", KEY_TOUCHPAD_ON, 0 },
+#endif
+#ifdef KEY_TOUCHPAD_OFF
+	{ "KEY_TOUCHPAD_OFF", KEY_TOUCHPAD_OFF, 0 },
+#endif
+#ifdef KEY_CAMERA_ZOOMIN
+	{ "KEY_CAMERA_ZOOMIN", KEY_CAMERA_ZOOMIN, 0 },
+#endif
+#ifdef KEY_CAMERA_ZOOMOUT
+	{ "KEY_CAMERA_ZOOMOUT", KEY_CAMERA_ZOOMOUT, 0 },
+#endif
+#ifdef KEY_CAMERA_UP
+	{ "KEY_CAMERA_UP", KEY_CAMERA_UP, 0 },
+#endif
+#ifdef KEY_CAMERA_DOWN
+	{ "KEY_CAMERA_DOWN", KEY_CAMERA_DOWN, 0 },
+#endif
+#ifdef KEY_CAMERA_LEFT
+	{ "KEY_CAMERA_LEFT", KEY_CAMERA_LEFT, 0 },
+#endif
+#ifdef KEY_CAMERA_RIGHT
+	{ "KEY_CAMERA_RIGHT", KEY_CAMERA_RIGHT, 0 },
+#endif
+#ifdef KEY_ATTENDANT_ON
+	{ "KEY_ATTENDANT_ON", KEY_ATTENDANT_ON, 0 },
+#endif
+#ifdef KEY_ATTENDANT_OFF
+	{ "KEY_ATTENDANT_OFF", KEY_ATTENDANT_OFF, 0 },
+#endif
+#ifdef KEY_ATTENDANT_TOGGLE
+	{ "KEY_ATTENDANT_TOGGLE", KEY_ATTENDANT_TOGGLE, 0 },
+#endif
+#ifdef KEY_LIGHTS_TOGGLE
+	{ "KEY_LIGHTS_TOGGLE", KEY_LIGHTS_TOGGLE, 0 },
+#endif
+#ifdef KEY_ALS_TOGGLE
+	{ "KEY_ALS_TOGGLE", KEY_ALS_TOGGLE, 0 },
+#endif
+#ifdef KEY_ROTATE_LOCK_TOGGLE
+	{ "KEY_ROTATE_LOCK_TOGGLE", KEY_ROTATE_LOCK_TOGGLE, 0 },
+#endif
+#ifdef KEY_REFRESH_RATE_TOGGLE
+	{ "KEY_REFRESH_RATE_TOGGLE", KEY_REFRESH_RATE_TOGGLE, 0 },
+#endif
+#ifdef KEY_BUTTONCONFIG
+	{ "KEY_BUTTONCONFIG", KEY_BUTTONCONFIG, 0 },
+#endif
+#ifdef KEY_TASKMANAGER
+	{ "KEY_TASKMANAGER", KEY_TASKMANAGER, 0 },
+#endif
+#ifdef KEY_JOURNAL
+	{ "KEY_JOURNAL", KEY_JOURNAL, 0 },
+#endif
+#ifdef KEY_CONTROLPANEL
+	{ "KEY_CONTROLPANEL", KEY_CONTROLPANEL, 0 },
+#endif
+#ifdef KEY_APPSELECT
+	{ "KEY_APPSELECT", KEY_APPSELECT, 0 },
+#endif
+#ifdef KEY_SCREENSAVER
+	{ "KEY_SCREENSAVER", KEY_SCREENSAVER, 0 },
+#endif
+#ifdef KEY_VOICECOMMAND
+	{ "KEY_VOICECOMMAND", KEY_VOICECOMMAND, 0 },
+#endif
+#ifdef KEY_ASSISTANT
+	{ "KEY_ASSISTANT", KEY_ASSISTANT, 0 },
+#endif
+#ifdef KEY_KBD_LAYOUT_NEXT
+	{ "KEY_KBD_LAYOUT_NEXT", KEY_KBD_LAYOUT_NEXT, 0 },
+#endif
+#ifdef KEY_EMOJI_PICKER
+	{ "KEY_EMOJI_PICKER", KEY_EMOJI_PICKER, 0 },
+#endif
+#ifdef KEY_DICTATE
+	{ "KEY_DICTATE", KEY_DICTATE, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_MIN
+	{ "KEY_BRIGHTNESS_MIN", KEY_BRIGHTNESS_MIN, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_MAX
+	{ "KEY_BRIGHTNESS_MAX", KEY_BRIGHTNESS_MAX, 1 },
+#endif
+#ifdef KEY_KBDINPUTASSIST_PREV
+	{ "KEY_KBDINPUTASSIST_PREV", KEY_KBDINPUTASSIST_PREV, 0 },
+#endif
+#ifdef KEY_KBDINPUTASSIST_NEXT
+	{ "KEY_KBDINPUTASSIST_NEXT", KEY_KBDINPUTASSIST_NEXT, 0 },
+#endif
+#ifdef KEY_KBDINPUTASSIST_PREVGROUP
+	{ "KEY_KBDINPUTASSIST_PREVGROUP", KEY_KBDINPUTASSIST_PREVGROUP, 0 },
+#endif
+#ifdef KEY_KBDINPUTASSIST_NEXTGROUP
+	{ "KEY_KBDINPUTASSIST_NEXTGROUP", KEY_KBDINPUTASSIST_NEXTGROUP, 0 },
+#endif
+#ifdef KEY_KBDINPUTASSIST_ACCEPT
+	{ "KEY_KBDINPUTASSIST_ACCEPT", KEY_KBDINPUTASSIST_ACCEPT, 0 },
+#endif
+#ifdef KEY_KBDINPUTASSIST_CANCEL
+	{ "KEY_KBDINPUTASSIST_CANCEL", KEY_KBDINPUTASSIST_CANCEL, 0 },
+#endif
+#ifdef KEY_RIGHT_UP
+	{ "KEY_RIGHT_UP", KEY_RIGHT_UP, 0 },
+#endif
+#ifdef KEY_RIGHT_DOWN
+	{ "KEY_RIGHT_DOWN", KEY_RIGHT_DOWN, 0 },
+#endif
+#ifdef KEY_LEFT_UP
+	{ "KEY_LEFT_UP", KEY_LEFT_UP, 0 },
+#endif
+#ifdef KEY_LEFT_DOWN
+	{ "KEY_LEFT_DOWN", KEY_LEFT_DOWN, 0 },
+#endif
+#ifdef KEY_ROOT_MENU
+	{ "KEY_ROOT_MENU", KEY_ROOT_MENU, 0 },
+#endif
+#ifdef KEY_MEDIA_TOP_MENU
+	{ "KEY_MEDIA_TOP_MENU", KEY_MEDIA_TOP_MENU, 0 },
+#endif
+#ifdef KEY_NUMERIC_11
+	{ "KEY_NUMERIC_11", KEY_NUMERIC_11, 0 },
+#endif
+#ifdef KEY_NUMERIC_12
+	{ "KEY_NUMERIC_12", KEY_NUMERIC_12, 0 },
+#endif
+#ifdef KEY_AUDIO_DESC
+	{ "KEY_AUDIO_DESC", KEY_AUDIO_DESC, 0 },
+#endif
+#ifdef KEY_3D_MODE
+	{ "KEY_3D_MODE", KEY_3D_MODE, 0 },
+#endif
+#ifdef KEY_NEXT_FAVORITE
+	{ "KEY_NEXT_FAVORITE", KEY_NEXT_FAVORITE, 0 },
+#endif
+#ifdef KEY_STOP_RECORD
+	{ "KEY_STOP_RECORD", KEY_STOP_RECORD, 0 },
+#endif
+#ifdef KEY_PAUSE_RECORD
+	{ "KEY_PAUSE_RECORD", KEY_PAUSE_RECORD, 0 },
+#endif
+#ifdef KEY_VOD
+	{ "KEY_VOD", KEY_VOD, 0 },
+#endif
+#ifdef KEY_UNMUTE
+	{ "KEY_UNMUTE", KEY_UNMUTE, 0 },
+#endif
+#ifdef KEY_FASTREVERSE
+	{ "KEY_FASTREVERSE", KEY_FASTREVERSE, 0 },
+#endif
+#ifdef KEY_SLOWREVERSE
+	{ "KEY_SLOWREVERSE", KEY_SLOWREVERSE, 0 },
+#endif
+#ifdef KEY_DATA
+	{ "KEY_DATA", KEY_DATA, 0 },
+#endif
+#ifdef KEY_ONSCREEN_KEYBOARD
+	{ "KEY_ONSCREEN_KEYBOARD", KEY_ONSCREEN_KEYBOARD, 0 },
+#endif
+#ifdef KEY_PRIVACY_SCREEN_TOGGLE
+	{ "KEY_PRIVACY_SCREEN_TOGGLE", KEY_PRIVACY_SCREEN_TOGGLE, 0 },
+#endif
+#ifdef KEY_SELECTIVE_SCREENSHOT
+	{ "KEY_SELECTIVE_SCREENSHOT", KEY_SELECTIVE_SCREENSHOT, 0 },
+#endif
+#ifdef KEY_NEXT_ELEMENT
+	{ "KEY_NEXT_ELEMENT", KEY_NEXT_ELEMENT, 0 },
+#endif
+#ifdef KEY_PREVIOUS_ELEMENT
+	{ "KEY_PREVIOUS_ELEMENT", KEY_PREVIOUS_ELEMENT, 0 },
+#endif
+#ifdef KEY_AUTOPILOT_ENGAGE_TOGGLE
+	{ "KEY_AUTOPILOT_ENGAGE_TOGGLE", KEY_AUTOPILOT_ENGAGE_TOGGLE, 0 },
+#endif
+#ifdef KEY_MARK_WAYPOINT
+	{ "KEY_MARK_WAYPOINT", KEY_MARK_WAYPOINT, 0 },
+#endif
+#ifdef KEY_SOS
+	{ "KEY_SOS", KEY_SOS, 0 },
+#endif
+#ifdef KEY_NAV_CHART
+	{ "KEY_NAV_CHART", KEY_NAV_CHART, 0 },
+#endif
+#ifdef KEY_FISHING_CHART
+	{ "KEY_FISHING_CHART", KEY_FISHING_CHART, 0 },
+#endif
+#ifdef KEY_SINGLE_RANGE_RADAR
+	{ "KEY_SINGLE_RANGE_RADAR", KEY_SINGLE_RANGE_RADAR, 0 },
+#endif
+#ifdef KEY_DUAL_RANGE_RADAR
+	{ "KEY_DUAL_RANGE_RADAR", KEY_DUAL_RANGE_RADAR, 0 },
+#endif
+#ifdef KEY_RADAR_OVERLAY
+	{ "KEY_RADAR_OVERLAY", KEY_RADAR_OVERLAY, 0 },
+#endif
+#ifdef KEY_TRADITIONAL_SONAR
+	{ "KEY_TRADITIONAL_SONAR", KEY_TRADITIONAL_SONAR, 0 },
+#endif
+#ifdef KEY_CLEARVU_SONAR
+	{ "KEY_CLEARVU_SONAR", KEY_CLEARVU_SONAR, 0 },
+#endif
+#ifdef KEY_SIDEVU_SONAR
+	{ "KEY_SIDEVU_SONAR", KEY_SIDEVU_SONAR, 0 },
+#endif
+#ifdef KEY_NAV_INFO
+	{ "KEY_NAV_INFO", KEY_NAV_INFO, 0 },
+#endif
+#ifdef KEY_BRIGHTNESS_MENU
+	{ "KEY_BRIGHTNESS_MENU", KEY_BRIGHTNESS_MENU, 0 },
+#endif
+#ifdef KEY_MACRO1
+	{ "KEY_MACRO1", KEY_MACRO1, 0 },
+#endif
+#ifdef KEY_MACRO2
+	{ "KEY_MACRO2", KEY_MACRO2, 0 },
+#endif
+#ifdef KEY_MACRO3
+	{ "KEY_MACRO3", KEY_MACRO3, 0 },
+#endif
+#ifdef KEY_MACRO4
+	{ "KEY_MACRO4", KEY_MACRO4, 0 },
+#endif
+#ifdef KEY_MACRO5
+	{ "KEY_MACRO5", KEY_MACRO5, 0 },
+#endif
+#ifdef KEY_MACRO6
+	{ "KEY_MACRO6", KEY_MACRO6, 0 },
+#endif
+#ifdef KEY_MACRO7
+	{ "KEY_MACRO7", KEY_MACRO7, 0 },
+#endif
+#ifdef KEY_MACRO8
+	{ "KEY_MACRO8", KEY_MACRO8, 0 },
+#endif
+#ifdef KEY_MACRO9
+	{ "KEY_MACRO9", KEY_MACRO9, 0 },
+#endif
+#ifdef KEY_MACRO10
+	{ "KEY_MACRO10", KEY_MACRO10, 0 },
+#endif
+#ifdef KEY_MACRO11
+	{ "KEY_MACRO11", KEY_MACRO11, 0 },
+#endif
+#ifdef KEY_MACRO12
+	{ "KEY_MACRO12", KEY_MACRO12, 0 },
+#endif
+#ifdef KEY_MACRO13
+	{ "KEY_MACRO13", KEY_MACRO13, 0 },
+#endif
+#ifdef KEY_MACRO14
+	{ "KEY_MACRO14", KEY_MACRO14, 0 },
+#endif
+#ifdef KEY_MACRO15
+	{ "KEY_MACRO15", KEY_MACRO15, 0 },
+#endif
+#ifdef KEY_MACRO16
+	{ "KEY_MACRO16", KEY_MACRO16, 0 },
+#endif
+#ifdef KEY_MACRO17
+	{ "KEY_MACRO17", KEY_MACRO17, 0 },
+#endif
+#ifdef KEY_MACRO18
+	{ "KEY_MACRO18", KEY_MACRO18, 0 },
+#endif
+#ifdef KEY_MACRO19
+	{ "KEY_MACRO19", KEY_MACRO19, 0 },
+#endif
+#ifdef KEY_MACRO20
+	{ "KEY_MACRO20", KEY_MACRO20, 0 },
+#endif
+#ifdef KEY_MACRO21
+	{ "KEY_MACRO21", KEY_MACRO21, 0 },
+#endif
+#ifdef KEY_MACRO22
+	{ "KEY_MACRO22", KEY_MACRO22, 0 },
+#endif
+#ifdef KEY_MACRO23
+	{ "KEY_MACRO23", KEY_MACRO23, 0 },
+#endif
+#ifdef KEY_MACRO24
+	{ "KEY_MACRO24", KEY_MACRO24, 0 },
+#endif
+#ifdef KEY_MACRO25
+	{ "KEY_MACRO25", KEY_MACRO25, 0 },
+#endif
+#ifdef KEY_MACRO26
+	{ "KEY_MACRO26", KEY_MACRO26, 0 },
+#endif
+#ifdef KEY_MACRO27
+	{ "KEY_MACRO27", KEY_MACRO27, 0 },
+#endif
+#ifdef KEY_MACRO28
+	{ "KEY_MACRO28", KEY_MACRO28, 0 },
+#endif
+#ifdef KEY_MACRO29
+	{ "KEY_MACRO29", KEY_MACRO29, 0 },
+#endif
+#ifdef KEY_MACRO30
+	{ "KEY_MACRO30", KEY_MACRO30, 0 },
+#endif
+#ifdef KEY_MACRO_RECORD_START
+	{ "KEY_MACRO_RECORD_START", KEY_MACRO_RECORD_START, 0 },
+#endif
+#ifdef KEY_MACRO_RECORD_STOP
+	{ "KEY_MACRO_RECORD_STOP", KEY_MACRO_RECORD_STOP, 0 },
+#endif
+#ifdef KEY_MACRO_PRESET_CYCLE
+	{ "KEY_MACRO_PRESET_CYCLE", KEY_MACRO_PRESET_CYCLE, 0 },
+#endif
+#ifdef KEY_MACRO_PRESET1
+	{ "KEY_MACRO_PRESET1", KEY_MACRO_PRESET1, 0 },
+#endif
+#ifdef KEY_MACRO_PRESET2
+	{ "KEY_MACRO_PRESET2", KEY_MACRO_PRESET2, 0 },
+#endif
+#ifdef KEY_MACRO_PRESET3
+	{ "KEY_MACRO_PRESET3", KEY_MACRO_PRESET3, 0 },
+#endif
+#ifdef KEY_KBD_LCD_MENU1
+	{ "KEY_KBD_LCD_MENU1", KEY_KBD_LCD_MENU1, 0 },
+#endif
+#ifdef KEY_KBD_LCD_MENU2
+	{ "KEY_KBD_LCD_MENU2", KEY_KBD_LCD_MENU2, 0 },
+#endif
+#ifdef KEY_KBD_LCD_MENU3
+	{ "KEY_KBD_LCD_MENU3", KEY_KBD_LCD_MENU3, 0 },
+#endif
+#ifdef KEY_KBD_LCD_MENU4
+	{ "KEY_KBD_LCD_MENU4", KEY_KBD_LCD_MENU4, 0 },
+#endif
+#ifdef KEY_KBD_LCD_MENU5
+	{ "KEY_KBD_LCD_MENU5", KEY_KBD_LCD_MENU5, 0 },
+#endif
+#ifdef KEY_MIN_INTERESTING
+	{ "KEY_MIN_INTERESTING", KEY_MIN_INTERESTING, 1 },
+#endif
+#ifdef KEY_MAX
+	{ "KEY_MAX", KEY_MAX, 1 },
+#endif
+#ifdef KEY_CNT
+	{ "KEY_CNT", KEY_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Buttons */
+static const struct evdevConstant evdevConstants_BTN[] = {
+#ifdef BTN_MISC
+	{ "BTN_MISC", BTN_MISC, 1 },
+#endif
+#ifdef BTN_0
+	{ "BTN_0", BTN_0, 0 },
+#endif
+#ifdef BTN_1
+	{ "BTN_1", BTN_1, 0 },
+#endif
+#ifdef BTN_2
+	{ "BTN_2", BTN_2, 0 },
+#endif
+#ifdef BTN_3
+	{ "BTN_3", BTN_3, 0 },
+#endif
+#ifdef BTN_4
+	{ "BTN_4", BTN_4, 0 },
+#endif
+#ifdef BTN_5
+	{ "BTN_5", BTN_5, 0 },
+#endif
+#ifdef BTN_6
+	{ "BTN_6", BTN_6, 0 },
+#endif
+#ifdef BTN_7
+	{ "BTN_7", BTN_7, 0 },
+#endif
+#ifdef BTN_8
+	{ "BTN_8", BTN_8, 0 },
+#endif
+#ifdef BTN_9
+	{ "BTN_9", BTN_9, 0 },
+#endif
+#ifdef BTN_MOUSE
+	{ "BTN_MOUSE", BTN_MOUSE, 1 },
+#endif
+#ifdef BTN_LEFT
+	{ "BTN_LEFT", BTN_LEFT, 0 },
+#endif
+#ifdef BTN_RIGHT
+	{ "BTN_RIGHT", BTN_RIGHT, 0 },
+#endif
+#ifdef BTN_MIDDLE
+	{ "BTN_MIDDLE", BTN_MIDDLE, 0 },
+#endif
+#ifdef BTN_SIDE
+	{ "BTN_SIDE", BTN_SIDE, 0 },
+#endif
+#ifdef BTN_EXTRA
+	{ "BTN_EXTRA", BTN_EXTRA, 0 },
+#endif
+#ifdef BTN_FORWARD
+	{ "BTN_FORWARD", BTN_FORWARD, 0 },
+#endif
+#ifdef BTN_BACK
+	{ "BTN_BACK", BTN_BACK, 0 },
+#endif
+#ifdef BTN_TASK
+	{ "BTN_TASK", BTN_TASK, 0 },
+#endif
+#ifdef BTN_JOYSTICK
+	{ "BTN_JOYSTICK", BTN_JOYSTICK, 1 },
+#endif
+#ifdef BTN_TRIGGER
+	{ "BTN_TRIGGER", BTN_TRIGGER, 0 },
+#endif
+#ifdef BTN_THUMB
+	{ "BTN_THUMB", BTN_THUMB, 0 },
+#endif
+#ifdef BTN_THUMB2
+	{ "BTN_THUMB2", BTN_THUMB2, 0 },
+#endif
+#ifdef BTN_TOP
+	{ "BTN_TOP", BTN_TOP, 0 },
+#endif
+#ifdef BTN_TOP2
+	{ "BTN_TOP2", BTN_TOP2, 0 },
+#endif
+#ifdef BTN_PINKIE
+	{ "BTN_PINKIE", BTN_PINKIE, 0 },
+#endif
+#ifdef BTN_BASE
+	{ "BTN_BASE", BTN_BASE, 0 },
+#endif
+#ifdef BTN_BASE2
+	{ "BTN_BASE2", BTN_BASE2, 0 },
+#endif
+#ifdef BTN_BASE3
+	{ "BTN_BASE3", BTN_BASE3, 0 },
+#endif
+#ifdef BTN_BASE4
+	{ "BTN_BASE4", BTN_BASE4, 0 },
+#endif
+#ifdef BTN_BASE5
+	{ "BTN_BASE5", BTN_BASE5, 0 },
+#endif
+#ifdef BTN_BASE6
+	{ "BTN_BASE6", BTN_BASE6, 0 },
+#endif
+#ifdef BTN_DEAD
+	{ "BTN_DEAD", BTN_DEAD, 0 },
+#endif
+#ifdef BTN_GAMEPAD
+	{ "BTN_GAMEPAD", BTN_GAMEPAD, 1 },
+#endif
+#ifdef BTN_SOUTH
+	{ "BTN_SOUTH", BTN_SOUTH, 0 },
+#endif
+#ifdef BTN_A
+	{ "BTN_A", BTN_A, 1 },
+#endif
+#ifdef BTN_EAST
+	{ "BTN_EAST", BTN_EAST, 0 },
+#endif
+#ifdef BTN_B
+	{ "BTN_B", BTN_B, 1 },
+#endif
+#ifdef BTN_C
+	{ "BTN_C", BTN_C, 0 },
+#endif
+#ifdef BTN_NORTH
+	{ "BTN_NORTH", BTN_NORTH, 0 },
+#endif
+#ifdef BTN_X
+	{ "BTN_X", BTN_X, 1 },
+#endif
+#ifdef BTN_WEST
+	{ "BTN_WEST", BTN_WEST, 0 },
+#endif
+#ifdef BTN_Y
+	{ "BTN_Y", BTN_Y, 1 },
+#endif
+#ifdef BTN_Z
+	{ "BTN_Z", BTN_Z, 0 },
+#endif
+#ifdef BTN_TL
+	{ "BTN_TL", BTN_TL, 0 },
+#endif
+#ifdef BTN_TR
+	{ "BTN_TR", BTN_TR, 0 },
+#endif
+#ifdef BTN_TL2
+	{ "BTN_TL2", BTN_TL2, 0 },
+#endif
+#ifdef BTN_TR2
+	{ "BTN_TR2", BTN_TR2, 0 },
+#endif
+#ifdef BTN_SELECT
+	{ "BTN_SELECT", BTN_SELECT, 0 },
+#endif
+#ifdef BTN_START
+	{ "BTN_START", BTN_START, 0 },
+#endif
+#ifdef BTN_MODE
+	{ "BTN_MODE", BTN_MODE, 0 },
+#endif
+#ifdef BTN_THUMBL
+	{ "BTN_THUMBL", BTN_THUMBL, 0 },
+#endif
+#ifdef BTN_THUMBR
+	{ "BTN_THUMBR", BTN_THUMBR, 0 },
+#endif
+#ifdef BTN_DIGI
+	{ "BTN_DIGI", BTN_DIGI, 1 },
+#endif
+#ifdef BTN_TOOL_PEN
+	{ "BTN_TOOL_PEN", BTN_TOOL_PEN, 0 },
+#endif
+#ifdef BTN_TOOL_RUBBER
+	{ "BTN_TOOL_RUBBER", BTN_TOOL_RUBBER, 0 },
+#endif
+#ifdef BTN_TOOL_BRUSH
+	{ "BTN_TOOL_BRUSH", BTN_TOOL_BRUSH, 0 },
+#endif
+#ifdef BTN_TOOL_PENCIL
+	{ "BTN_TOOL_PENCIL", BTN_TOOL_PENCIL, 0 },
+#endif
+#ifdef BTN_TOOL_AIRBRUSH
+	{ "BTN_TOOL_AIRBRUSH", BTN_TOOL_AIRBRUSH, 0 },
+#endif
+#ifdef BTN_TOOL_FINGER
+	{ "BTN_TOOL_FINGER", BTN_TOOL_FINGER, 0 },
+#endif
+#ifdef BTN_TOOL_MOUSE
+	{ "BTN_TOOL_MOUSE", BTN_TOOL_MOUSE, 0 },
+#endif
+#ifdef BTN_TOOL_LENS
+	{ "BTN_TOOL_LENS", BTN_TOOL_LENS, 0 },
+#endif
+#ifdef BTN_TOOL_QUINTTAP
+	{ "BTN_TOOL_QUINTTAP", BTN_TOOL_QUINTTAP, 0 },
+#endif
+#ifdef BTN_STYLUS3
+	{ "BTN_STYLUS3", BTN_STYLUS3, 0 },
+#endif
+#ifdef BTN_TOUCH
+	{ "BTN_TOUCH", BTN_TOUCH, 0 },
+#endif
+#ifdef BTN_STYLUS
+	{ "BTN_STYLUS", BTN_STYLUS, 0 },
+#endif
+#ifdef BTN_STYLUS2
+	{ "BTN_STYLUS2", BTN_STYLUS2, 0 },
+#endif
+#ifdef BTN_TOOL_DOUBLETAP
+	{ "BTN_TOOL_DOUBLETAP", BTN_TOOL_DOUBLETAP, 0 },
+#endif
+#ifdef BTN_TOOL_TRIPLETAP
+	{ "BTN_TOOL_TRIPLETAP", BTN_TOOL_TRIPLETAP, 0 },
+#endif
+#ifdef BTN_TOOL_QUADTAP
+	{ "BTN_TOOL_QUADTAP", BTN_TOOL_QUADTAP, 0 },
+#endif
+#ifdef BTN_WHEEL
+	{ "BTN_WHEEL", BTN_WHEEL, 1 },
+#endif
+#ifdef BTN_GEAR_DOWN
+	{ "BTN_GEAR_DOWN", BTN_GEAR_DOWN, 0 },
+#endif
+#ifdef BTN_GEAR_UP
+	{ "BTN_GEAR_UP", BTN_GEAR_UP, 0 },
+#endif
+#ifdef BTN_DPAD_UP
+	{ "BTN_DPAD_UP", BTN_DPAD_UP, 0 },
+#endif
+#ifdef BTN_DPAD_DOWN
+	{ "BTN_DPAD_DOWN", BTN_DPAD_DOWN, 0 },
+#endif
+#ifdef BTN_DPAD_LEFT
+	{ "BTN_DPAD_LEFT", BTN_DPAD_LEFT, 0 },
+#endif
+#ifdef BTN_DPAD_RIGHT
+	{ "BTN_DPAD_RIGHT", BTN_DPAD_RIGHT, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY
+	{ "BTN_TRIGGER_HAPPY", BTN_TRIGGER_HAPPY, 1 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY1
+	{ "BTN_TRIGGER_HAPPY1", BTN_TRIGGER_HAPPY1, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY2
+	{ "BTN_TRIGGER_HAPPY2", BTN_TRIGGER_HAPPY2, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY3
+	{ "BTN_TRIGGER_HAPPY3", BTN_TRIGGER_HAPPY3, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY4
+	{ "BTN_TRIGGER_HAPPY4", BTN_TRIGGER_HAPPY4, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY5
+	{ "BTN_TRIGGER_HAPPY5", BTN_TRIGGER_HAPPY5, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY6
+	{ "BTN_TRIGGER_HAPPY6", BTN_TRIGGER_HAPPY6, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY7
+	{ "BTN_TRIGGER_HAPPY7", BTN_TRIGGER_HAPPY7, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY8
+	{ "BTN_TRIGGER_HAPPY8", BTN_TRIGGER_HAPPY8, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY9
+	{ "BTN_TRIGGER_HAPPY9", BTN_TRIGGER_HAPPY9, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY10
+	{ "BTN_TRIGGER_HAPPY10", BTN_TRIGGER_HAPPY10, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY11
+	{ "BTN_TRIGGER_HAPPY11", BTN_TRIGGER_HAPPY11, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY12
+	{ "BTN_TRIGGER_HAPPY12", BTN_TRIGGER_HAPPY12, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY13
+	{ "BTN_TRIGGER_HAPPY13", BTN_TRIGGER_HAPPY13, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY14
+	{ "BTN_TRIGGER_HAPPY14", BTN_TRIGGER_HAPPY14, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY15
+	{ "BTN_TRIGGER_HAPPY15", BTN_TRIGGER_HAPPY15, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY16
+	{ "BTN_TRIGGER_HAPPY16", BTN_TRIGGER_HAPPY16, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY17
+	{ "BTN_TRIGGER_HAPPY17", BTN_TRIGGER_HAPPY17, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY18
+	{ "BTN_TRIGGER_HAPPY18", BTN_TRIGGER_HAPPY18, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY19
+	{ "BTN_TRIGGER_HAPPY19", BTN_TRIGGER_HAPPY19, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY20
+	{ "BTN_TRIGGER_HAPPY20", BTN_TRIGGER_HAPPY20, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY21
+	{ "BTN_TRIGGER_HAPPY21", BTN_TRIGGER_HAPPY21, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY22
+	{ "BTN_TRIGGER_HAPPY22", BTN_TRIGGER_HAPPY22, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY23
+	{ "BTN_TRIGGER_HAPPY23", BTN_TRIGGER_HAPPY23, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY24
+	{ "BTN_TRIGGER_HAPPY24", BTN_TRIGGER_HAPPY24, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY25
+	{ "BTN_TRIGGER_HAPPY25", BTN_TRIGGER_HAPPY25, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY26
+	{ "BTN_TRIGGER_HAPPY26", BTN_TRIGGER_HAPPY26, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY27
+	{ "BTN_TRIGGER_HAPPY27", BTN_TRIGGER_HAPPY27, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY28
+	{ "BTN_TRIGGER_HAPPY28", BTN_TRIGGER_HAPPY28, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY29
+	{ "BTN_TRIGGER_HAPPY29", BTN_TRIGGER_HAPPY29, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY30
+	{ "BTN_TRIGGER_HAPPY30", BTN_TRIGGER_HAPPY30, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY31
+	{ "BTN_TRIGGER_HAPPY31", BTN_TRIGGER_HAPPY31, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY32
+	{ "BTN_TRIGGER_HAPPY32", BTN_TRIGGER_HAPPY32, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY33
+	{ "BTN_TRIGGER_HAPPY33", BTN_TRIGGER_HAPPY33, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY34
+	{ "BTN_TRIGGER_HAPPY34", BTN_TRIGGER_HAPPY34, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY35
+	{ "BTN_TRIGGER_HAPPY35", BTN_TRIGGER_HAPPY35, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY36
+	{ "BTN_TRIGGER_HAPPY36", BTN_TRIGGER_HAPPY36, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY37
+	{ "BTN_TRIGGER_HAPPY37", BTN_TRIGGER_HAPPY37, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY38
+	{ "BTN_TRIGGER_HAPPY38", BTN_TRIGGER_HAPPY38, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY39
+	{ "BTN_TRIGGER_HAPPY39", BTN_TRIGGER_HAPPY39, 0 },
+#endif
+#ifdef BTN_TRIGGER_HAPPY40
+	{ "BTN_TRIGGER_HAPPY40", BTN_TRIGGER_HAPPY40, 0 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Relative Axes */
+static const struct evdevConstant evdevConstants_REL[] = {
+#ifdef REL_X
+	{ "REL_X", REL_X, 0 },
+#endif
+#ifdef REL_Y
+	{ "REL_Y", REL_Y, 0 },
+#endif
+#ifdef REL_Z
+	{ "REL_Z", REL_Z, 0 },
+#endif
+#ifdef REL_RX
+	{ "REL_RX", REL_RX, 0 },
+#endif
+#ifdef REL_RY
+	{ "REL_RY", REL_RY, 0 },
+#endif
+#ifdef REL_RZ
+	{ "REL_RZ", REL_RZ, 0 },
+#endif
+#ifdef REL_HWHEEL
+	{ "REL_HWHEEL", REL_HWHEEL, 0 },
+#endif
+#ifdef REL_DIAL
+	{ "REL_DIAL", REL_DIAL, 0 },
+#endif
+#ifdef REL_WHEEL
+	{ "REL_WHEEL", REL_WHEEL, 0 },
+#endif
+#ifdef REL_MISC
+	{ "REL_MISC", REL_MISC, 0 },
+#endif
+#ifdef REL_RESERVED
+	{ "REL_RESERVED", REL_RESERVED, 0 },
+#endif
+#ifdef REL_WHEEL_HI_RES
+	{ "REL_WHEEL_HI_RES", REL_WHEEL_HI_RES, 0 },
+#endif
+#ifdef REL_HWHEEL_HI_RES
+	{ "REL_HWHEEL_HI_RES", REL_HWHEEL_HI_RES, 0 },
+#endif
+#ifdef REL_MAX
+	{ "REL_MAX", REL_MAX, 1 },
+#endif
+#ifdef REL_CNT
+	{ "REL_CNT", REL_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Absolute Axes */
+static const struct evdevConstant evdevConstants_ABS[] = {
+#ifdef ABS_X
+	{ "ABS_X", ABS_X, 0 },
+#endif
+#ifdef ABS_Y
+	{ "ABS_Y", ABS_Y, 0 },
+#endif
+#ifdef ABS_Z
+	{ "ABS_Z", ABS_Z, 0 },
+#endif
+#ifdef ABS_RX
+	{ "ABS_RX", ABS_RX, 0 },
+#endif
+#ifdef ABS_RY
+	{ "ABS_RY", ABS_RY, 0 },
+#endif
+#ifdef ABS_RZ
+	{ "ABS_RZ", ABS_RZ, 0 },
+#endif
+#ifdef ABS_THROTTLE
+	{ "ABS_THROTTLE", ABS_THROTTLE, 0 },
+#endif
+#ifdef ABS_RUDDER
+	{ "ABS_RUDDER", ABS_RUDDER, 0 },
+#endif
+#ifdef ABS_WHEEL
+	{ "ABS_WHEEL", ABS_WHEEL, 0 },
+#endif
+#ifdef ABS_GAS
+	{ "ABS_GAS", ABS_GAS, 0 },
+#endif
+#ifdef ABS_BRAKE
+	{ "ABS_BRAKE", ABS_BRAKE, 0 },
+#endif
+#ifdef ABS_HAT0X
+	{ "ABS_HAT0X", ABS_HAT0X, 0 },
+#endif
+#ifdef ABS_HAT0Y
+	{ "ABS_HAT0Y", ABS_HAT0Y, 0 },
+#endif
+#ifdef ABS_HAT1X
+	{ "ABS_HAT1X", ABS_HAT1X, 0 },
+#endif
+#ifdef ABS_HAT1Y
+	{ "ABS_HAT1Y", ABS_HAT1Y, 0 },
+#endif
+#ifdef ABS_HAT2X
+	{ "ABS_HAT2X", ABS_HAT2X, 0 },
+#endif
+#ifdef ABS_HAT2Y
+	{ "ABS_HAT2Y", ABS_HAT2Y, 0 },
+#endif
+#ifdef ABS_HAT3X
+	{ "ABS_HAT3X", ABS_HAT3X, 0 },
+#endif
+#ifdef ABS_HAT3Y
+	{ "ABS_HAT3Y", ABS_HAT3Y, 0 },
+#endif
+#ifdef ABS_PRESSURE
+	{ "ABS_PRESSURE", ABS_PRESSURE, 0 },
+#endif
+#ifdef ABS_DISTANCE
+	{ "ABS_DISTANCE", ABS_DISTANCE, 0 },
+#endif
+#ifdef ABS_TILT_X
+	{ "ABS_TILT_X", ABS_TILT_X, 0 },
+#endif
+#ifdef ABS_TILT_Y
+	{ "ABS_TILT_Y", ABS_TILT_Y, 0 },
+#endif
+#ifdef ABS_TOOL_WIDTH
+	{ "ABS_TOOL_WIDTH", ABS_TOOL_WIDTH, 0 },
+#endif
+#ifdef ABS_VOLUME
+	{ "ABS_VOLUME", ABS_VOLUME, 0 },
+#endif
+#ifdef ABS_PROFILE
+	{ "ABS_PROFILE", ABS_PROFILE, 0 },
+#endif
+#ifdef ABS_MISC
+	{ "ABS_MISC", ABS_MISC, 0 },
+#endif
+#ifdef ABS_RESERVED
+	{ "ABS_RESERVED", ABS_RESERVED, 0 },
+#endif
+#ifdef ABS_MT_SLOT
+	{ "ABS_MT_SLOT", ABS_MT_SLOT, 0 },
+#endif
+#ifdef ABS_MT_TOUCH_MAJOR
+	{ "ABS_MT_TOUCH_MAJOR", ABS_MT_TOUCH_MAJOR, 0 },
+#endif
+#ifdef ABS_MT_TOUCH_MINOR
+	{ "ABS_MT_TOUCH_MINOR", ABS_MT_TOUCH_MINOR, 0 },
+#endif
+#ifdef ABS_MT_WIDTH_MAJOR
+	{ "ABS_MT_WIDTH_MAJOR", ABS_MT_WIDTH_MAJOR, 0 },
+#endif
+#ifdef ABS_MT_WIDTH_MINOR
+	{ "ABS_MT_WIDTH_MINOR", ABS_MT_WIDTH_MINOR, 0 },
+#endif
+#ifdef ABS_MT_ORIENTATION
+	{ "ABS_MT_ORIENTATION", ABS_MT_ORIENTATION, 0 },
+#endif
+#ifdef ABS_MT_POSITION_X
+	{ "ABS_MT_POSITION_X", ABS_MT_POSITION_X, 0 },
+#endif
+#ifdef ABS_MT_POSITION_Y
+	{ "ABS_MT_POSITION_Y", ABS_MT_POSITION_Y, 0 },
+#endif
+#ifdef ABS_MT_TOOL_TYPE
+	{ "ABS_MT_TOOL_TYPE", ABS_MT_TOOL_TYPE, 0 },
+#endif
+#ifdef ABS_MT_BLOB_ID
+	{ "ABS_MT_BLOB_ID", ABS_MT_BLOB_ID, 0 },
+#endif
+#ifdef ABS_MT_TRACKING_ID
+	{ "ABS_MT_TRACKING_ID", ABS_MT_TRACKING_ID, 0 },
+#endif
+#ifdef ABS_MT_PRESSURE
+	{ "ABS_MT_PRESSURE", ABS_MT_PRESSURE, 0 },
+#endif
+#ifdef ABS_MT_DISTANCE
+	{ "ABS_MT_DISTANCE", ABS_MT_DISTANCE, 0 },
+#endif
+#ifdef ABS_MT_TOOL_X
+	{ "ABS_MT_TOOL_X", ABS_MT_TOOL_X, 0 },
+#endif
+#ifdef ABS_MT_TOOL_Y
+	{ "ABS_MT_TOOL_Y", ABS_MT_TOOL_Y, 0 },
+#endif
+#ifdef ABS_MAX
+	{ "ABS_MAX", ABS_MAX, 1 },
+#endif
+#ifdef ABS_CNT
+	{ "ABS_CNT", ABS_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Miscellaneous Events */
+static const struct evdevConstant evdevConstants_MSC[] = {
+#ifdef MSC_SERIAL
+	{ "MSC_SERIAL", MSC_SERIAL, 0 },
+#endif
+#ifdef MSC_PULSELED
+	{ "MSC_PULSELED", MSC_PULSELED, 0 },
+#endif
+#ifdef MSC_GESTURE
+	{ "MSC_GESTURE", MSC_GESTURE, 0 },
+#endif
+#ifdef MSC_RAW
+	{ "MSC_RAW", MSC_RAW, 0 },
+#endif
+#ifdef MSC_SCAN
+	{ "MSC_SCAN", MSC_SCAN, 0 },
+#endif
+#ifdef MSC_TIMESTAMP
+	{ "MSC_TIMESTAMP", MSC_TIMESTAMP, 0 },
+#endif
+#ifdef MSC_MAX
+	{ "MSC_MAX", MSC_MAX, 1 },
+#endif
+#ifdef MSC_CNT
+	{ "MSC_CNT", MSC_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Switches */
+static const struct evdevConstant evdevConstants_SW[] = {
+#ifdef SW_LID
+	{ "SW_LID", SW_LID, 0 },
+#endif
+#ifdef SW_TABLET_MODE
+	{ "SW_TABLET_MODE", SW_TABLET_MODE, 0 },
+#endif
+#ifdef SW_HEADPHONE_INSERT
+	{ "SW_HEADPHONE_INSERT", SW_HEADPHONE_INSERT, 0 },
+#endif
+#ifdef SW_RFKILL_ALL
+	{ "SW_RFKILL_ALL", SW_RFKILL_ALL, 0 },
+#endif
+#ifdef SW_RADIO
+	{ "SW_RADIO", SW_RADIO, 1 },
+#endif
+#ifdef SW_MICROPHONE_INSERT
+	{ "SW_MICROPHONE_INSERT", SW_MICROPHONE_INSERT, 0 },
+#endif
+#ifdef SW_DOCK
+	{ "SW_DOCK", SW_DOCK, 0 },
+#endif
+#ifdef SW_LINEOUT_INSERT
+	{ "SW_LINEOUT_INSERT", SW_LINEOUT_INSERT, 0 },
+#endif
+#ifdef SW_JACK_PHYSICAL_INSERT
+	{ "SW_JACK_PHYSICAL_INSERT", SW_JACK_PHYSICAL_INSERT, 0 },
+#endif
+#ifdef SW_VIDEOOUT_INSERT
+	{ "SW_VIDEOOUT_INSERT", SW_VIDEOOUT_INSERT, 0 },
+#endif
+#ifdef SW_CAMERA_LENS_COVER
+	{ "SW_CAMERA_LENS_COVER", SW_CAMERA_LENS_COVER, 0 },
+#endif
+#ifdef SW_KEYPAD_SLIDE
+	{ "SW_KEYPAD_SLIDE", SW_KEYPAD_SLIDE, 0 },
+#endif
+#ifdef SW_FRONT_PROXIMITY
+	{ "SW_FRONT_PROXIMITY", SW_FRONT_PROXIMITY, 0 },
+#endif
+#ifdef SW_ROTATE_LOCK
+	{ "SW_ROTATE_LOCK", SW_ROTATE_LOCK, 0 },
+#endif
+#ifdef SW_LINEIN_INSERT
+	{ "SW_LINEIN_INSERT", SW_LINEIN_INSERT, 0 },
+#endif
+#ifdef SW_MUTE_DEVICE
+	{ "SW_MUTE_DEVICE", SW_MUTE_DEVICE, 0 },
+#endif
+#ifdef SW_PEN_INSERTED
+	{ "SW_PEN_INSERTED", SW_PEN_INSERTED, 0 },
+#endif
+#ifdef SW_MACHINE_COVER
+	{ "SW_MACHINE_COVER", SW_MACHINE_COVER, 1 },
+#endif
+#ifdef SW_MAX
+	{ "SW_MAX", SW_MAX, 1 },
+#endif
+#ifdef SW_CNT
+	{ "SW_CNT", SW_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* LEDs */
+static const struct evdevConstant evdevConstants_LED[] = {
+#ifdef LED_NUML
+	{ "LED_NUML", LED_NUML, 0 },
+#endif
+#ifdef LED_CAPSL
+	{ "LED_CAPSL", LED_CAPSL, 0 },
+#endif
+#ifdef LED_SCROLLL
+	{ "LED_SCROLLL", LED_SCROLLL, 0 },
+#endif
+#ifdef LED_COMPOSE
+	{ "LED_COMPOSE", LED_COMPOSE, 0 },
+#endif
+#ifdef LED_KANA
+	{ "LED_KANA", LED_KANA, 0 },
+#endif
+#ifdef LED_SLEEP
+	{ "LED_SLEEP", LED_SLEEP, 0 },
+#endif
+#ifdef LED_SUSPEND
+	{ "LED_SUSPEND", LED_SUSPEND, 0 },
+#endif
+#ifdef LED_MUTE
+	{ "LED_MUTE", LED_MUTE, 0 },
+#endif
+#ifdef LED_MISC
+	{ "LED_MISC", LED_MISC, 0 },
+#endif
+#ifdef LED_MAIL
+	{ "LED_MAIL", LED_MAIL, 0 },
+#endif
+#ifdef LED_CHARGING
+	{ "LED_CHARGING", LED_CHARGING, 0 },
+#endif
+#ifdef LED_MAX
+	{ "LED_MAX", LED_MAX, 1 },
+#endif
+#ifdef LED_CNT
+	{ "LED_CNT", LED_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Sounds */
+static const struct evdevConstant evdevConstants_SND[] = {
+#ifdef SND_CLICK
+	{ "SND_CLICK", SND_CLICK, 0 },
+#endif
+#ifdef SND_BELL
+	{ "SND_BELL", SND_BELL, 0 },
+#endif
+#ifdef SND_TONE
+	{ "SND_TONE", SND_TONE, 0 },
+#endif
+#ifdef SND_MAX
+	{ "SND_MAX", SND_MAX, 1 },
+#endif
+#ifdef SND_CNT
+	{ "SND_CNT", SND_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Autorepeat */
+static const struct evdevConstant evdevConstants_REP[] = {
+#ifdef REP_DELAY
+	{ "REP_DELAY", REP_DELAY, 0 },
+#endif
+#ifdef REP_PERIOD
+	{ "REP_PERIOD", REP_PERIOD, 1 },
+#endif
+#ifdef REP_MAX
+	{ "REP_MAX", REP_MAX, 1 },
+#endif
+#ifdef REP_CNT
+	{ "REP_CNT", REP_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Force Feedback Status */
+static const struct evdevConstant evdevConstants_FF_STATUS[] = {
+#ifdef FF_STATUS_STOPPED
+	{ "FF_STATUS_STOPPED", FF_STATUS_STOPPED, 0 },
+#endif
+#ifdef FF_STATUS_PLAYING
+	{ "FF_STATUS_PLAYING", FF_STATUS_PLAYING, 1 },
+#endif
+#ifdef FF_STATUS_MAX
+	{ "FF_STATUS_MAX", FF_STATUS_MAX, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Force Feedback */
+static const struct evdevConstant evdevConstants_FF[] = {
+#ifdef FF_RUMBLE
+	{ "FF_RUMBLE", FF_RUMBLE, 0 },
+#endif
+#ifdef FF_PERIODIC
+	{ "FF_PERIODIC", FF_PERIODIC, 0 },
+#endif
+#ifdef FF_CONSTANT
+	{ "FF_CONSTANT", FF_CONSTANT, 0 },
+#endif
+#ifdef FF_SPRING
+	{ "FF_SPRING", FF_SPRING, 0 },
+#endif
+#ifdef FF_FRICTION
+	{ "FF_FRICTION", FF_FRICTION, 0 },
+#endif
+#ifdef FF_DAMPER
+	{ "FF_DAMPER", FF_DAMPER, 0 },
+#endif
+#ifdef FF_INERTIA
+	{ "FF_INERTIA", FF_INERTIA, 0 },
+#endif
+#ifdef FF_RAMP
+	{ "FF_RAMP", FF_RAMP, 0 },
+#endif
+#ifdef FF_EFFECT_MIN
+	{ "FF_EFFECT_MIN", FF_EFFECT_MIN, 1 },
+#endif
+#ifdef FF_EFFECT_MAX
+	{ "FF_EFFECT_MAX", FF_EFFECT_MAX, 1 },
+#endif
+#ifdef FF_SQUARE
+	{ "FF_SQUARE", FF_SQUARE, 0 },
+#endif
+#ifdef FF_TRIANGLE
+	{ "FF_TRIANGLE", FF_TRIANGLE, 0 },
+#endif
+#ifdef FF_SINE
+	{ "FF_SINE", FF_SINE, 0 },
+#endif
+#ifdef FF_SAW_UP
+	{ "FF_SAW_UP", FF_SAW_UP, 0 },
+#endif
+#ifdef FF_SAW_DOWN
+	{ "FF_SAW_DOWN", FF_SAW_DOWN, 0 },
+#endif
+#ifdef FF_CUSTOM
+	{ "FF_CUSTOM", FF_CUSTOM, 0 },
+#endif
+#ifdef FF_WAVEFORM_MIN
+	{ "FF_WAVEFORM_MIN", FF_WAVEFORM_MIN, 1 },
+#endif
+#ifdef FF_WAVEFORM_MAX
+	{ "FF_WAVEFORM_MAX", FF_WAVEFORM_MAX, 1 },
+#endif
+#ifdef FF_GAIN
+	{ "FF_GAIN", FF_GAIN, 0 },
+#endif
+#ifdef FF_AUTOCENTER
+	{ "FF_AUTOCENTER", FF_AUTOCENTER, 0 },
+#endif
+#ifdef FF_MAX_EFFECTS
+	{ "FF_MAX_EFFECTS", FF_MAX_EFFECTS, 1 },
+#endif
+#ifdef FF_MAX
+	{ "FF_MAX", FF_MAX, 1 },
+#endif
+#ifdef FF_CNT
+	{ "FF_CNT", FF_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Input Properties */
+static const struct evdevConstant evdevConstants_INPUT_PROP[] = {
+#ifdef INPUT_PROP_POINTER
+	{ "INPUT_PROP_POINTER", INPUT_PROP_POINTER, 0 },
+#endif
+#ifdef INPUT_PROP_DIRECT
+	{ "INPUT_PROP_DIRECT", INPUT_PROP_DIRECT, 0 },
+#endif
+#ifdef INPUT_PROP_BUTTONPAD
+	{ "INPUT_PROP_BUTTONPAD", INPUT_PROP_BUTTONPAD, 0 },
+#endif
+#ifdef INPUT_PROP_SEMI_MT
+	{ "INPUT_PROP_SEMI_MT", INPUT_PROP_SEMI_MT, 0 },
+#endif
+#ifdef INPUT_PROP_TOPBUTTONPAD
+	{ "INPUT_PROP_TOPBUTTONPAD", INPUT_PROP_TOPBUTTONPAD, 0 },
+#endif
+#ifdef INPUT_PROP_POINTING_STICK
+	{ "INPUT_PROP_POINTING_STICK", INPUT_PROP_POINTING_STICK, 0 },
+#endif
+#ifdef INPUT_PROP_ACCELEROMETER
+	{ "INPUT_PROP_ACCELEROMETER", INPUT_PROP_ACCELEROMETER, 0 },
+#endif
+#ifdef INPUT_PROP_MAX
+	{ "INPUT_PROP_MAX", INPUT_PROP_MAX, 1 },
+#endif
+#ifdef INPUT_PROP_CNT
+	{ "INPUT_PROP_CNT", INPUT_PROP_CNT, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Device ID Fields */
+static const struct evdevConstant evdevConstants_ID[] = {
+#ifdef ID_BUS
+	{ "ID_BUS", ID_BUS, 0 },
+#endif
+#ifdef ID_VENDOR
+	{ "ID_VENDOR", ID_VENDOR, 0 },
+#endif
+#ifdef ID_PRODUCT
+	{ "ID_PRODUCT", ID_PRODUCT, 0 },
+#endif
+#ifdef ID_VERSION
+	{ "ID_VERSION", ID_VERSION, 0 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Bus Types */
+static const struct evdevConstant evdevConstants_BUS[] = {
+#ifdef BUS_PCI
+	{ "BUS_PCI", BUS_PCI, 0 },
+#endif
+#ifdef BUS_ISAPNP
+	{ "BUS_ISAPNP", BUS_ISAPNP, 0 },
+#endif
+#ifdef BUS_USB
+	{ "BUS_USB", BUS_USB, 0 },
+#endif
+#ifdef BUS_HIL
+	{ "BUS_HIL", BUS_HIL, 0 },
+#endif
+#ifdef BUS_BLUETOOTH
+	{ "BUS_BLUETOOTH", BUS_BLUETOOTH, 0 },
+#endif
+#ifdef BUS_VIRTUAL
+	{ "BUS_VIRTUAL", BUS_VIRTUAL, 0 },
+#endif
+#ifdef BUS_ISA
+	{ "BUS_ISA", BUS_ISA, 0 },
+#endif
+#ifdef BUS_I8042
+	{ "BUS_I8042", BUS_I8042, 0 },
+#endif
+#ifdef BUS_XTKBD
+	{ "BUS_XTKBD", BUS_XTKBD, 0 },
+#endif
+#ifdef BUS_RS232
+	{ "BUS_RS232", BUS_RS232, 0 },
+#endif
+#ifdef BUS_GAMEPORT
+	{ "BUS_GAMEPORT", BUS_GAMEPORT, 0 },
+#endif
+#ifdef BUS_PARPORT
+	{ "BUS_PARPORT", BUS_PARPORT, 0 },
+#endif
+#ifdef BUS_AMIGA
+	{ "BUS_AMIGA", BUS_AMIGA, 0 },
+#endif
+#ifdef BUS_ADB
+	{ "BUS_ADB", BUS_ADB, 0 },
+#endif
+#ifdef BUS_I2C
+	{ "BUS_I2C", BUS_I2C, 0 },
+#endif
+#ifdef BUS_HOST
+	{ "BUS_HOST", BUS_HOST, 0 },
+#endif
+#ifdef BUS_GSC
+	{ "BUS_GSC", BUS_GSC, 0 },
+#endif
+#ifdef BUS_ATARI
+	{ "BUS_ATARI", BUS_ATARI, 0 },
+#endif
+#ifdef BUS_SPI
+	{ "BUS_SPI", BUS_SPI, 0 },
+#endif
+#ifdef BUS_RMI
+	{ "BUS_RMI", BUS_RMI, 0 },
+#endif
+#ifdef BUS_CEC
+	{ "BUS_CEC", BUS_CEC, 0 },
+#endif
+#ifdef BUS_INTEL_ISHTP
+	{ "BUS_INTEL_ISHTP", BUS_INTEL_ISHTP, 0 },
+#endif
+#ifdef BUS_AMD_SFH
+	{ "BUS_AMD_SFH", BUS_AMD_SFH, 0 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+/* Multitouch Tools */
+static const struct evdevConstant evdevConstants_MT_TOOL[] = {
+#ifdef MT_TOOL_FINGER
+	{ "MT_TOOL_FINGER", MT_TOOL_FINGER, 0 },
+#endif
+#ifdef MT_TOOL_PEN
+	{ "MT_TOOL_PEN", MT_TOOL_PEN, 0 },
+#endif
+#ifdef MT_TOOL_PALM
+	{ "MT_TOOL_PALM", MT_TOOL_PALM, 0 },
+#endif
+#ifdef MT_TOOL_DIAL
+	{ "MT_TOOL_DIAL", MT_TOOL_DIAL, 0 },
+#endif
+#ifdef MT_TOOL_MAX
+	{ "MT_TOOL_MAX", MT_TOOL_MAX, 1 },
+#endif
+	{ NULL, 0, 0 }
+};
+
+static const struct evdevConstantSection evdevConstantSections[] = {
+	{ "EV_", evdevConstants_EV, sizeof(evdevConstants_EV) / sizeof(struct evdevConstant) - 1 },
+	{ "SYN_", evdevConstants_SYN, sizeof(evdevConstants_SYN) / sizeof(struct evdevConstant) - 1 },
+	{ "KEY_", evdevConstants_KEY, sizeof(evdevConstants_KEY) / sizeof(struct evdevConstant) - 1 },
+	{ "BTN_", evdevConstants_BTN, sizeof(evdevConstants_BTN) / sizeof(struct evdevConstant) - 1 },
+	{ "REL_", evdevConstants_REL, sizeof(evdevConstants_REL) / sizeof(struct evdevConstant) - 1 },
+	{ "ABS_", evdevConstants_ABS, sizeof(evdevConstants_ABS) / sizeof(struct evdevConstant) - 1 },
+	{ "MSC_", evdevConstants_MSC, sizeof(evdevConstants_MSC) / sizeof(struct evdevConstant) - 1 },
+	{ "SW_", evdevConstants_SW, sizeof(evdevConstants_SW) / sizeof(struct evdevConstant) - 1 },
+	{ "LED_", evdevConstants_LED, sizeof(evdevConstants_LED) / sizeof(struct evdevConstant) - 1 },
+	{ "SND_", evdevConstants_SND, sizeof(evdevConstants_SND) / sizeof(struct evdevConstant) - 1 },
+	{ "REP_", evdevConstants_REP, sizeof(evdevConstants_REP) / sizeof(struct evdevConstant) - 1 },
+	{ "FF_STATUS_", evdevConstants_FF_STATUS, sizeof(evdevConstants_FF_STATUS) / sizeof(struct evdevConstant) - 1 },
+	{ "FF_", evdevConstants_FF, sizeof(evdevConstants_FF) / sizeof(struct evdevConstant) - 1 },
+	{ "INPUT_PROP_", evdevConstants_INPUT_PROP, sizeof(evdevConstants_INPUT_PROP) / sizeof(struct evdevConstant) - 1 },
+	{ "ID_", evdevConstants_ID, sizeof(evdevConstants_ID) / sizeof(struct evdevConstant) - 1 },
+	{ "BUS_", evdevConstants_BUS, sizeof(evdevConstants_BUS) / sizeof(struct evdevConstant) - 1 },
+	{ "MT_TOOL_", evdevConstants_MT_TOOL, sizeof(evdevConstants_MT_TOOL) / sizeof(struct evdevConstant) - 1 },
+	{ NULL, NULL, 0 }
+};
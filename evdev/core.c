@@ -31,273 +31,8904 @@ THE SOFTWARE.
 #endif
 
 #include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <math.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
 #include <linux/input.h>
 #include <linux/uinput.h>
 
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define EVDEV_HAVE_IO_URING 1
+#endif
+#endif
+
 #include <lua.h>
 #include <lauxlib.h>
 
-/* Evdev wrappers */
+#include "constants.h"
+
+/* Clock helpers */
+
+static uint64_t monotonic_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/* now on the clock the kernel stamps input events with */
+static struct timeval event_now(void) {
+	struct timespec now;
+	struct timeval tv;
+	clock_gettime(CLOCK_REALTIME, &now);
+	tv.tv_sec = now.tv_sec;
+	tv.tv_usec = now.tv_nsec / 1000;
+	return tv;
+}
+
+static uint64_t seconds_to_ns(lua_Number seconds) {
+	if(seconds <= 0) {
+		return 0;
+	}
+	return (uint64_t) (seconds * 1e9);
+}
+
+static double evdev_timestamp(const struct input_event *evt) {
+	return evt->time.tv_sec + evt->time.tv_usec/1000000.0;
+}
+
+static int evdev_monotonic(lua_State *L) {
+	lua_pushnumber(L, monotonic_ns() / 1e9);
+	return 1;
+}
+
+/* Event code ranges */
+
+/* number of distinct codes for an event type, or 0 if not tracked */
+static int event_codeCount(int type) {
+	switch(type) {
+	case EV_SYN: return SYN_CNT;
+	case EV_KEY: return KEY_CNT;
+	case EV_REL: return REL_CNT;
+	case EV_ABS: return ABS_CNT;
+	case EV_MSC: return MSC_CNT;
+	case EV_SW: return SW_CNT;
+	case EV_LED: return LED_CNT;
+	case EV_SND: return SND_CNT;
+	case EV_REP: return REP_CNT;
+	case EV_FF: return FF_CNT;
+	default: return 0;
+	}
+}
+
+/* Option table helpers */
+
+static double option_number(lua_State *L, int index, const char *key, double def) {
+	lua_getfield(L, index, key);
+	double value = luaL_optnumber(L, -1, def);
+	lua_pop(L, 1);
+	return value;
+}
+
+/* Axis filters
+ * 
+ * Per-axis smoothing applied to EV_ABS values in C, so noisy axes can be
+ * cleaned up before they ever reach Lua. Stages run in a fixed order:
+ * deadzone, exponential moving average, One-Euro, then hysteresis; an
+ * event whose filtered value doesn't change the output is suppressed. */
+
+struct axisFilter {
+	int enabled;
+
+	double center, deadzone; // values within deadzone of center snap to it
+	double ema; // smoothing factor in (0, 1]; 0 disables
+	double minCutoff, beta, dCutoff; // One-Euro parameters; minCutoff 0 disables
+	double hysteresis; // minimum change needed to move the output
+
+	/* state */
+	int primed;
+	double lastTime, smoothed, euro, euroDeriv;
+	int output;
+};
+
+#define PI 3.14159265358979323846
+
+static double filter_abs(double x) {
+	return x < 0 ? -x : x;
+}
+
+static int filter_round(double x) {
+	return x < 0 ? (int) (x - 0.5) : (int) (x + 0.5);
+}
+
+/* smoothing factor of a first-order low-pass at cutoff Hz over dt seconds */
+static double filter_alpha(double cutoff, double dt) {
+	double tau = 1.0 / (2 * PI * cutoff);
+	return 1.0 / (1.0 + tau / dt);
+}
+
+/* returns 1 and rewrites *value if the event should pass, 0 to drop it */
+static int filter_apply(struct axisFilter *f, int *value, double time) {
+	double x = *value;
+
+	if(f->deadzone > 0 && filter_abs(x - f->center) <= f->deadzone) {
+		x = f->center;
+	}
+
+	if(!f->primed) {
+		f->primed = 1;
+		f->lastTime = time;
+		f->smoothed = f->euro = x;
+		f->euroDeriv = 0;
+		f->output = filter_round(x);
+		*value = f->output;
+		return 1;
+	}
+
+	if(f->ema > 0) {
+		f->smoothed += f->ema * (x - f->smoothed);
+		x = f->smoothed;
+	}
+
+	if(f->minCutoff > 0) {
+		double dt = time - f->lastTime;
+		if(dt <= 0) {
+			/* same timestamp (or clock went backwards); assume ~1kHz */
+			dt = 0.001;
+		}
+		double deriv = (x - f->euro) / dt;
+		f->euroDeriv += filter_alpha(f->dCutoff, dt) * (deriv - f->euroDeriv);
+		double cutoff = f->minCutoff + f->beta * filter_abs(f->euroDeriv);
+		f->euro += filter_alpha(cutoff, dt) * (x - f->euro);
+		x = f->euro;
+	}
+
+	f->lastTime = time;
+
+	int rounded = filter_round(x);
+	if(rounded == f->output || filter_abs(rounded - f->output) < f->hysteresis) {
+		return 0;
+	}
+
+	f->output = rounded;
+	*value = rounded;
+	return 1;
+}
+
+/* shared by Device:filterAxis() and Uinput:filterAxis(); the axis is
+ * argument 2 and the options table (or nil to remove) argument 3 */
+static int filter_configure(lua_State *L, struct axisFilter **filters) {
+	int axis = luaL_checkinteger(L, 2);
+	luaL_argcheck(L, axis >= 0 && axis < ABS_CNT, 2, "not an absolute axis");
+
+	if(lua_isnoneornil(L, 3)) {
+		if(*filters != NULL) {
+			memset(&(*filters)[axis], 0, sizeof(struct axisFilter));
+		}
+		return 0;
+	}
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	struct axisFilter f;
+	memset(&f, 0, sizeof(f));
+	f.enabled = 1;
+	f.center = option_number(L, 3, "center", 0);
+	f.deadzone = option_number(L, 3, "deadzone", 0);
+	f.ema = option_number(L, 3, "ema", 0);
+	f.minCutoff = option_number(L, 3, "minCutoff", 0);
+	f.beta = option_number(L, 3, "beta", 0);
+	f.dCutoff = option_number(L, 3, "derivativeCutoff", 1);
+	f.hysteresis = option_number(L, 3, "hysteresis", 0);
+
+	if(f.ema < 0 || f.ema > 1) {
+		return luaL_error(L, "ema must be between 0 and 1.");
+	}
+	if(f.minCutoff < 0 || f.dCutoff <= 0 || f.beta < 0) {
+		return luaL_error(L, "One-Euro cutoffs must be positive.");
+	}
+
+	if(*filters == NULL) {
+		*filters = calloc(ABS_CNT, sizeof(struct axisFilter));
+		if(*filters == NULL) {
+			return luaL_error(L, "Out of memory allocating axis filters.");
+		}
+	}
+	(*filters)[axis] = f;
+
+	return 0;
+}
+
+/* Key state bitmaps */
+
+#define KEY_WORDS ((KEY_CNT + 63) / 64)
+
+static int bit_test(const uint64_t *bits, int bit) {
+	return (bits[bit / 64] >> (bit % 64)) & 1;
+}
+
+static void bit_set(uint64_t *bits, int bit, int on) {
+	if(on) {
+		bits[bit / 64] |= (uint64_t) 1 << (bit % 64);
+	} else {
+		bits[bit / 64] &= ~((uint64_t) 1 << (bit % 64));
+	}
+}
+
+/* splitmix64 finalizer; gives each key code a fixed random-looking
+ * 64-bit value, and mixes hash table keys */
+static uint64_t hash_mix(uint64_t x) {
+	x += 0x9e3779b97f4a7c15ull;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+
+/* Pressed keys of a device; the hash is the XOR of hash_mix(code) over
+ * the pressed set (Zobrist hashing), so it updates in O(1) per event
+ * and identifies the whole set for chord lookup. */
+struct keyState {
+	uint64_t pressed[KEY_WORDS];
+	uint64_t hash;
+	int count;
+};
+
+static void keys_update(struct keyState *keys, int code, int value) {
+	if(code >= KEY_CNT || value == 2) {
+		return;
+	}
+	if(bit_test(keys->pressed, code) != (value != 0)) {
+		bit_set(keys->pressed, code, value != 0);
+		keys->hash ^= hash_mix(code);
+		keys->count += value != 0 ? 1 : -1;
+	}
+}
+
+/* Hotkey matching
+ * 
+ * Chords are looked up by the Zobrist hash of the pressed set, and
+ * sequences walk a trie whose edges are keyed by (node, code) in a hash
+ * table, so the cost per key press doesn't grow with the number of
+ * bindings. Each trie node has a failure link to the longest proper
+ * suffix of its path that is also in the trie, as in Aho-Corasick, so a
+ * key that breaks a partial match carries on from there rather than from
+ * the root. Callbacks live in the Hotkeys uservalue, indexed by binding. */
+
+#define HOTKEYS_USERDATA "us.tropi.evdev.struct.hotkeys"
+#define HOTKEY_MAX_KEYS 8
+
+struct hotkeyTable {
+	uint64_t *keys;
+	int *values; // 0 marks an empty slot
+	size_t cap, count;
+};
+
+struct hotkeyBinding {
+	int swallow;
+	int sequence;
+	int keyCount;
+	int keys[HOTKEY_MAX_KEYS];
+};
+
+struct hotkeys {
+	struct hotkeyBinding *bindings;
+	int bindingCount, bindingCap;
+	struct hotkeyTable chords; // pressed-set hash -> binding + 1
+	struct hotkeyTable edges; // (node, code) -> child node
+	int *nodeBinding; // binding + 1 completed at each trie node
+	double *nodeTimeout; // allowed gap before the next key
+	int *nodeDepth;
+	int *nodeFail; // failure link
+	int nodeCount, nodeCap;
+};
+
+/* per-device matching progress */
+struct hotkeyState {
+	int node;
+	double time;
+	uint64_t swallowed[KEY_WORDS]; // keys whose repeats and release are eaten
+};
+
+static int *hotkeyTable_find(struct hotkeyTable *table, uint64_t key) {
+	if(table->cap == 0) {
+		return NULL;
+	}
+	size_t mask = table->cap - 1;
+	size_t i = hash_mix(key) & mask;
+	while(table->values[i]) {
+		if(table->keys[i] == key) {
+			return &table->values[i];
+		}
+		i = (i + 1) & mask;
+	}
+	return NULL;
+}
+
+static int hotkeyTable_put(struct hotkeyTable *table, uint64_t key, int value) {
+	int *existing = hotkeyTable_find(table, key);
+	if(existing != NULL) {
+		*existing = value;
+		return 0;
+	}
+
+	/* keep the load factor under one half */
+	if((table->count + 1) * 2 > table->cap) {
+		struct hotkeyTable grown;
+		grown.cap = table->cap ? table->cap * 2 : 64;
+		grown.count = 0;
+		grown.keys = calloc(grown.cap, sizeof(uint64_t));
+		grown.values = calloc(grown.cap, sizeof(int));
+		if(grown.keys == NULL || grown.values == NULL) {
+			free(grown.keys);
+			free(grown.values);
+			return -1;
+		}
+		size_t i;
+		for(i = 0; i < table->cap; i++) {
+			if(table->values[i]) {
+				hotkeyTable_put(&grown, table->keys[i], table->values[i]);
+			}
+		}
+		free(table->keys);
+		free(table->values);
+		*table = grown;
+	}
+
+	size_t mask = table->cap - 1;
+	size_t i = hash_mix(key) & mask;
+	while(table->values[i]) {
+		i = (i + 1) & mask;
+	}
+	table->keys[i] = key;
+	table->values[i] = value;
+	table->count++;
+	return 0;
+}
+
+static uint64_t hotkeys_edgeKey(int node, int code) {
+	return ((uint64_t) node << 16) | code;
+}
+
+/* a chord matches when the pressed set is exactly its keys */
+static int hotkeys_chordMatches(struct hotkeyBinding *binding, const struct keyState *keys) {
+	int i;
+	if(keys->count != binding->keyCount) {
+		return 0;
+	}
+	for(i = 0; i < binding->keyCount; i++) {
+		if(!bit_test(keys->pressed, binding->keys[i])) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Feed a key press (after the key state was updated); returns the
+ * matched binding, or -1. */
+static int hotkeys_press(struct hotkeys *hk, struct hotkeyState *state,
+		const struct keyState *keys, int code, double time) {
+	int *chord = hotkeyTable_find(&hk->chords, keys->hash);
+	if(chord != NULL && hotkeys_chordMatches(&hk->bindings[*chord - 1], keys)) {
+		state->node = 0;
+		return *chord - 1;
+	}
+
+	if(state->node != 0 && time - state->time > hk->nodeTimeout[state->node]) {
+		state->node = 0;
+	}
+
+	/* on a mismatch, fall back to the longest suffix that can go on */
+	int node = state->node;
+	int *next;
+	while((next = hotkeyTable_find(&hk->edges, hotkeys_edgeKey(node, code))) == NULL && node != 0) {
+		node = hk->nodeFail[node];
+	}
+	if(next == NULL) {
+		state->node = 0;
+		return -1;
+	}
+
+	/* the sequence ending here, or failing that one ending in a suffix */
+	for(node = *next; node != 0; node = hk->nodeFail[node]) {
+		if(hk->nodeBinding[node]) {
+			state->node = 0;
+			return hk->nodeBinding[node] - 1;
+		}
+	}
+
+	state->node = *next;
+	state->time = time;
+	return -1;
+}
+
+static int hotkeys_open(lua_State *L) {
+	struct hotkeys *hk = lua_newuserdata(L, sizeof(struct hotkeys));
+	memset(hk, 0, sizeof(struct hotkeys));
+	luaL_setmetatable(L, HOTKEYS_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	return 1;
+}
+
+/* read the key list (argument 2) and callback (argument 3) into a new
+ * binding, raising before anything is added if a key is invalid or, when
+ * `unique`, repeated; returns its index */
+static int hotkeys_bind(lua_State *L, struct hotkeys *hk, int unique) {
+	luaL_checktype(L, 2, LUA_TTABLE);
+	luaL_checktype(L, 3, LUA_TFUNCTION);
+	if(!lua_isnoneornil(L, 4)) {
+		luaL_checktype(L, 4, LUA_TTABLE);
+	}
+
+	struct hotkeyBinding binding;
+	memset(&binding, 0, sizeof(binding));
+
+	size_t count = lua_rawlen(L, 2);
+	if(count == 0 || count > HOTKEY_MAX_KEYS) {
+		luaL_error(L, "A hotkey needs between 1 and %d keys.", HOTKEY_MAX_KEYS);
+	}
+	size_t i;
+	for(i = 0; i < count; i++) {
+		lua_rawgeti(L, 2, i + 1);
+		int isnum;
+		int code = lua_tointegerx(L, -1, &isnum);
+		lua_pop(L, 1);
+		if(!isnum || code < 0 || code >= KEY_CNT) {
+			luaL_error(L, "Hotkey keys must be key codes.");
+		}
+		if(unique) {
+			int j;
+			for(j = 0; j < binding.keyCount; j++) {
+				if(binding.keys[j] == code) {
+					luaL_error(L, "A chord can't repeat a key.");
+				}
+			}
+		}
+		binding.keys[binding.keyCount++] = code;
+	}
+
+	if(!lua_isnoneornil(L, 4)) {
+		lua_getfield(L, 4, "swallow");
+		binding.swallow = lua_toboolean(L, -1);
+		lua_pop(L, 1);
+	}
+
+	if(hk->bindingCount == hk->bindingCap) {
+		int cap = hk->bindingCap ? hk->bindingCap * 2 : 16;
+		struct hotkeyBinding *bindings = realloc(hk->bindings, cap * sizeof(struct hotkeyBinding));
+		if(bindings == NULL) {
+			luaL_error(L, "Out of memory adding hotkey.");
+		}
+		hk->bindings = bindings;
+		hk->bindingCap = cap;
+	}
+	hk->bindings[hk->bindingCount] = binding;
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 3);
+	lua_rawseti(L, -2, hk->bindingCount + 1);
+	lua_pop(L, 1);
+
+	return hk->bindingCount++;
+}
+
+/* take back the binding hotkeys_bind just added */
+static void hotkeys_unbind(lua_State *L, struct hotkeys *hk, int index) {
+	hk->bindingCount--;
+	lua_getuservalue(L, 1);
+	lua_pushnil(L);
+	lua_rawseti(L, -2, index + 1);
+	lua_pop(L, 1);
+}
+
+static int hotkeys_sameChord(const struct hotkeyBinding *a, const struct hotkeyBinding *b) {
+	int i, j;
+	if(a->keyCount != b->keyCount) {
+		return 0;
+	}
+	for(i = 0; i < a->keyCount; i++) {
+		for(j = 0; j < b->keyCount && b->keys[j] != a->keys[i]; j++);
+		if(j == b->keyCount) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* chord(keys, callback[, options]) */
+static int hotkeys_chord(lua_State *L) {
+	struct hotkeys *hk = luaL_checkudata(L, 1, HOTKEYS_USERDATA);
+	int index = hotkeys_bind(L, hk, 1);
+	struct hotkeyBinding *binding = &hk->bindings[index];
+
+	uint64_t hash = 0;
+	int i;
+	for(i = 0; i < binding->keyCount; i++) {
+		hash ^= hash_mix(binding->keys[i]);
+	}
+
+	int *existing = hotkeyTable_find(&hk->chords, hash);
+	if(existing != NULL && hotkeys_sameChord(&hk->bindings[*existing - 1], binding)) {
+		hotkeys_unbind(L, hk, index);
+		return luaL_error(L, "That chord is already bound.");
+	}
+
+	if(hotkeyTable_put(&hk->chords, hash, index + 1) < 0) {
+		/* take the binding back out rather than leave it unreachable */
+		hotkeys_unbind(L, hk, index);
+		return luaL_error(L, "Out of memory adding hotkey.");
+	}
+
+	return 0;
+}
+
+static int hotkeys_addNode(struct hotkeys *hk, double timeout, int depth) {
+	if(hk->nodeCount == hk->nodeCap) {
+		int cap = hk->nodeCap ? hk->nodeCap * 2 : 64;
+		int *nodeBinding = realloc(hk->nodeBinding, cap * sizeof(int));
+		if(nodeBinding == NULL) {
+			return -1;
+		}
+		hk->nodeBinding = nodeBinding;
+		double *nodeTimeout = realloc(hk->nodeTimeout, cap * sizeof(double));
+		if(nodeTimeout == NULL) {
+			return -1;
+		}
+		hk->nodeTimeout = nodeTimeout;
+		int *nodeDepth = realloc(hk->nodeDepth, cap * sizeof(int));
+		if(nodeDepth == NULL) {
+			return -1;
+		}
+		hk->nodeDepth = nodeDepth;
+		int *nodeFail = realloc(hk->nodeFail, cap * sizeof(int));
+		if(nodeFail == NULL) {
+			return -1;
+		}
+		hk->nodeFail = nodeFail;
+		hk->nodeCap = cap;
+	}
+	hk->nodeBinding[hk->nodeCount] = 0;
+	hk->nodeTimeout[hk->nodeCount] = timeout;
+	hk->nodeDepth[hk->nodeCount] = depth;
+	hk->nodeFail[hk->nodeCount] = 0;
+	return hk->nodeCount++;
+}
+
+/* Recompute every failure link, shallowest nodes first so a parent's
+ * link is ready before its children need it. A new sequence can give
+ * existing nodes a longer suffix to fall back on, so this reruns after
+ * each one; the edge table is walked once per depth. */
+static void hotkeys_link(struct hotkeys *hk) {
+	int depth;
+	size_t i;
+
+	for(depth = 1; depth <= HOTKEY_MAX_KEYS; depth++) {
+		for(i = 0; i < hk->edges.cap; i++) {
+			int child = hk->edges.values[i];
+			if(child == 0 || hk->nodeDepth[child] != depth) {
+				continue;
+			}
+			int parent = hk->edges.keys[i] >> 16;
+			int code = hk->edges.keys[i] & 0xffff;
+
+			int fail = 0;
+			if(parent != 0) {
+				int node = hk->nodeFail[parent];
+				int *next;
+				while((next = hotkeyTable_find(&hk->edges, hotkeys_edgeKey(node, code))) == NULL && node != 0) {
+					node = hk->nodeFail[node];
+				}
+				fail = next != NULL ? *next : 0;
+			}
+			hk->nodeFail[child] = fail;
+		}
+	}
+}
+
+/* Would `a` complete partway through `b`, so that `b` could never
+ * match? Identical sequences count; `a` being a suffix of `b` doesn't,
+ * as the longer match wins there. */
+static int hotkeys_hides(const struct hotkeyBinding *a, const struct hotkeyBinding *b) {
+	int start, i;
+	for(start = 0; start + a->keyCount <= b->keyCount; start++) {
+		if(start > 0 && start + a->keyCount == b->keyCount) {
+			break;
+		}
+		for(i = 0; i < a->keyCount && a->keys[i] == b->keys[start + i]; i++);
+		if(i == a->keyCount) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* sequence(keys, callback[, options]) */
+static int hotkeys_sequence(lua_State *L) {
+	struct hotkeys *hk = luaL_checkudata(L, 1, HOTKEYS_USERDATA);
+	int index = hotkeys_bind(L, hk, 0);
+	struct hotkeyBinding *binding = &hk->bindings[index];
+
+	binding->sequence = 1;
+
+	double timeout = 1;
+	if(!lua_isnoneornil(L, 4)) {
+		timeout = option_number(L, 4, "timeout", timeout);
+	}
+
+	int i;
+	for(i = 0; i < index; i++) {
+		struct hotkeyBinding *other = &hk->bindings[i];
+		if(other->sequence && (hotkeys_hides(binding, other) || hotkeys_hides(other, binding))) {
+			hotkeys_unbind(L, hk, index);
+			return luaL_error(L, "Sequences can't repeat, or contain one another except at the end.");
+		}
+	}
+
+	if(hk->nodeCount == 0 && hotkeys_addNode(hk, 0, 0) < 0) {
+		hotkeys_unbind(L, hk, index);
+		return luaL_error(L, "Out of memory adding hotkey.");
+	}
+
+	int node = 0;
+	for(i = 0; i < binding->keyCount; i++) {
+		uint64_t edge = hotkeys_edgeKey(node, binding->keys[i]);
+		int *next = hotkeyTable_find(&hk->edges, edge);
+		if(next != NULL) {
+			node = *next;
+			continue;
+		}
+		int child = hotkeys_addNode(hk, timeout, i + 1);
+		if(child < 0 || hotkeyTable_put(&hk->edges, edge, child) < 0) {
+			/* the nodes added so far lead nowhere, which is harmless */
+			hotkeys_unbind(L, hk, index);
+			return luaL_error(L, "Out of memory adding hotkey.");
+		}
+		node = child;
+	}
+	hk->nodeBinding[node] = index + 1;
+	hotkeys_link(hk);
+
+	return 0;
+}
+
+static int hotkeys_gc(lua_State *L) {
+	struct hotkeys *hk = luaL_checkudata(L, 1, HOTKEYS_USERDATA);
+
+	free(hk->bindings);
+	free(hk->chords.keys);
+	free(hk->chords.values);
+	free(hk->edges.keys);
+	free(hk->edges.values);
+	free(hk->nodeBinding);
+	free(hk->nodeTimeout);
+	free(hk->nodeDepth);
+	free(hk->nodeFail);
+	memset(hk, 0, sizeof(struct hotkeys));
+
+	return 0;
+}
+
+/* Multitouch gestures
+ * 
+ * Follows type B multitouch slots across SYN_REPORT frames and, once
+ * every contact has lifted, classifies the session as a tap, pinch,
+ * rotation or swipe. Only the recognized gesture reaches Lua; the raw
+ * ABS_MT_* events are consumed unless passthrough is asked for. */
+
+#define GESTURE_MAX_CONTACTS 16
+
+struct gestureContact {
+	int active;
+	int joined; // order of arrival within the session, from 1
+	double x, y, startX, startY;
+};
+
+struct gestureState {
+	/* options */
+	double tapTime, tapDistance, swipeDistance, pinchThreshold, rotateThreshold;
+	int passthrough;
+
+	/* state */
+	int slot;
+	int dirty; // contacts changed during this frame
+	struct gestureContact contacts[GESTURE_MAX_CONTACTS];
+	int active, fingers, joined;
+	double startTime, maxMove;
+	double moveX, moveY; // mean travel of the contacts, as of the last frame
+	int pairA, pairB; // first two contacts, for pinch and rotation; -1 if unset
+	double pairDistance, pairAngle; // at the time the pair formed
+	double scale, angle; // latest pinch scale and rotation of the pair
+};
+
+/* what a finished session turned out to be */
+struct gesture {
+	const char *name;
+	int fingers;
+	double a, b;
+};
+
+/* start a new session; positions stay, since a slot's next contact only
+ * reports the axes that change */
+static void gesture_reset(struct gestureState *g) {
+	int i;
+	for(i = 0; i < GESTURE_MAX_CONTACTS; i++) {
+		g->contacts[i].active = g->contacts[i].joined = 0;
+		g->contacts[i].startX = g->contacts[i].startY = 0;
+	}
+	g->active = g->fingers = g->joined = 0;
+	g->maxMove = g->moveX = g->moveY = 0;
+	g->pairA = g->pairB = -1;
+	g->scale = 1;
+	g->angle = 0;
+}
+
+/* pick up the positions the kernel holds for each slot */
+static void gesture_loadSlots(struct gestureState *g, int fd) {
+	struct {
+		uint32_t code;
+		int32_t values[GESTURE_MAX_CONTACTS];
+	} slots;
+	int i;
+
+	slots.code = ABS_MT_POSITION_X;
+	if(ioctl(fd, EVIOCGMTSLOTS(sizeof(slots)), &slots) == 0) {
+		for(i = 0; i < GESTURE_MAX_CONTACTS; i++) {
+			g->contacts[i].x = slots.values[i];
+		}
+	}
+	slots.code = ABS_MT_POSITION_Y;
+	if(ioctl(fd, EVIOCGMTSLOTS(sizeof(slots)), &slots) == 0) {
+		for(i = 0; i < GESTURE_MAX_CONTACTS; i++) {
+			g->contacts[i].y = slots.values[i];
+		}
+	}
+}
+
+static void gesture_event(struct gestureState *g, struct input_event *evt) {
+	struct gestureContact *c;
+
+	if(evt->code == ABS_MT_SLOT) {
+		g->slot = evt->value;
+		return;
+	}
+	if(g->slot < 0 || g->slot >= GESTURE_MAX_CONTACTS) {
+		return;
+	}
+	c = &g->contacts[g->slot];
+
+	switch(evt->code) {
+	case ABS_MT_TRACKING_ID:
+		if(evt->value >= 0 && !c->active) {
+			c->active = 1;
+			c->joined = 0; // position arrives later in the frame
+		} else if(evt->value < 0) {
+			c->active = 0;
+		}
+		g->dirty = 1;
+		break;
+	case ABS_MT_POSITION_X:
+		c->x = evt->value;
+		g->dirty = 1;
+		break;
+	case ABS_MT_POSITION_Y:
+		c->y = evt->value;
+		g->dirty = 1;
+		break;
+	}
+}
+
+static void gesture_pair(struct gestureState *g, double *distance, double *angle) {
+	struct gestureContact *a = &g->contacts[g->pairA], *b = &g->contacts[g->pairB];
+	*distance = hypot(b->x - a->x, b->y - a->y);
+	*angle = atan2(b->y - a->y, b->x - a->x);
+}
+
+static void gesture_classify(struct gestureState *g, double duration, struct gesture *out) {
+	double dx = g->moveX, dy = g->moveY;
+
+	out->name = NULL;
+	out->fingers = g->fingers;
+
+	if(duration <= g->tapTime && g->maxMove <= g->tapDistance) {
+		out->name = "tap";
+		out->a = dx;
+		out->b = dy;
+	} else if(g->fingers >= 2 && fabs(g->scale - 1) >= g->pinchThreshold) {
+		out->name = "pinch";
+		out->a = g->scale;
+		out->b = 0;
+	} else if(g->fingers >= 2 && fabs(g->angle) >= g->rotateThreshold) {
+		out->name = "rotate";
+		out->a = g->angle;
+		out->b = 0;
+	} else if(hypot(dx, dy) >= g->swipeDistance) {
+		out->name = "swipe";
+		out->a = dx;
+		out->b = dy;
+	}
+}
+
+/* Called at SYN_REPORT; returns 1 and fills *out when a session ends
+ * in a recognized gesture. */
+static int gesture_frame(struct gestureState *g, double time, struct gesture *out) {
+	int i, active = 0;
+	double moveX = 0, moveY = 0;
+
+	if(!g->dirty) {
+		return 0;
+	}
+	g->dirty = 0;
+
+	for(i = 0; i < GESTURE_MAX_CONTACTS; i++) {
+		struct gestureContact *c = &g->contacts[i];
+		if(!c->active) {
+			continue;
+		}
+		if(c->joined == 0) {
+			if(g->joined == 0) {
+				g->startTime = time;
+			}
+			c->joined = ++g->joined;
+			c->startX = c->x;
+			c->startY = c->y;
+			if(g->pairA < 0) {
+				g->pairA = i;
+			} else if(g->pairB < 0) {
+				g->pairB = i;
+				gesture_pair(g, &g->pairDistance, &g->pairAngle);
+			}
+		}
+		active++;
+		double move = hypot(c->x - c->startX, c->y - c->startY);
+		if(move > g->maxMove) {
+			g->maxMove = move;
+		}
+		moveX += c->x - c->startX;
+		moveY += c->y - c->startY;
+	}
+
+	if(active > g->fingers) {
+		g->fingers = active;
+	}
+
+	if(g->pairB >= 0 && g->contacts[g->pairA].active && g->contacts[g->pairB].active) {
+		double distance, angle;
+		gesture_pair(g, &distance, &angle);
+		if(g->pairDistance > 0) {
+			g->scale = distance / g->pairDistance;
+		}
+		g->angle = angle - g->pairAngle;
+		if(g->angle > PI) {
+			g->angle -= 2 * PI;
+		} else if(g->angle < -PI) {
+			g->angle += 2 * PI;
+		}
+	}
+
+	if(active > 0) {
+		g->active = active;
+		g->moveX = moveX / active;
+		g->moveY = moveY / active;
+		return 0;
+	}
+
+	if(g->joined == 0) {
+		return 0;
+	}
+
+	gesture_classify(g, time - g->startTime, out);
+	gesture_reset(g);
+	return out->name != NULL;
+}
+
+/* Debouncing
+ * 
+ * Chattering switches produce bursts of toggles; after a transition is
+ * delivered, further transitions of that code within its window are
+ * suppressed, using the kernel timestamps. A later event that merely
+ * repeats the delivered state is suppressed too, so a trailing bounce
+ * can't leave a duplicate press or release behind. If the code's real
+ * state settled on something else within the window, that trailing
+ * transition is delivered once the window is over: ahead of the device's
+ * next event, or on its own frame if the device stays quiet, since
+ * reads wait for the earliest window to run out (debounce_remaining())
+ * as well as for the fd. */
+
+struct debounceCode {
+	double window; // seconds; 0 when not debounced
+	double lastEdge, lastSeen;
+	int known, delivered, actual;
+	int trailing; // a settling transition is queued and must pass
+};
+
+#define DEBOUNCE_QUEUE_SIZE (KEY_CNT + SW_CNT + 1)
+
+struct debounceState {
+	struct debounceCode *key; // KEY_CNT entries, or NULL
+	struct debounceCode *sw; // SW_CNT entries, or NULL
+	unsigned long suppressed;
+	int unsettled; // some code's real state differs from the delivered one
+
+	/* settling transitions, then the event that revealed them */
+	struct input_event *queue;
+	int queueHead, queueCount;
+};
+
+/* returns 1 if the event should pass */
+static int debounce_apply(struct debounceState *state, struct input_event *evt) {
+	struct debounceCode *codes = evt->type == EV_KEY ? state->key : state->sw;
+
+	if(codes == NULL || evt->code >= event_codeCount(evt->type)) {
+		return 1;
+	}
+
+	struct debounceCode *c = &codes[evt->code];
+	if(c->trailing) {
+		c->trailing = 0;
+		return 1;
+	} else if(c->window <= 0) {
+		return 1;
+	}
+
+	if(evt->type == EV_KEY && evt->value == 2) {
+		/* autorepeat follows whatever was last delivered */
+		return !c->known || c->delivered;
+	}
+
+	double time = evdev_timestamp(evt);
+	if(c->known && (evt->value == c->delivered || time - c->lastEdge < c->window)) {
+		state->suppressed++;
+		c->actual = evt->value;
+		c->lastSeen = time;
+		state->unsettled |= c->actual != c->delivered;
+		return 0;
+	}
+
+	c->known = 1;
+	c->delivered = c->actual = evt->value;
+	c->lastEdge = time;
+	return 1;
+}
+
+static void debounce_settleCodes(struct debounceState *state, struct debounceCode *codes, int count,
+		int type, const struct input_event *evt, int *unsettled) {
+	double time = evdev_timestamp(evt);
+	int code;
+
+	if(codes == NULL) {
+		return;
+	}
+
+	for(code = 0; code < count; code++) {
+		struct debounceCode *c = &codes[code];
+		if(!c->known || c->actual == c->delivered) {
+			continue;
+		} else if(time - c->lastEdge < c->window) {
+			*unsettled = 1;
+			continue;
+		}
+
+		struct input_event *out = &state->queue[state->queueCount++];
+		out->time = evt->time;
+		out->type = type;
+		out->code = code;
+		out->value = c->actual;
+
+		/* the real transition happened when it was last seen */
+		c->delivered = c->actual;
+		c->lastEdge = c->lastSeen;
+		c->trailing = 1;
+	}
+}
+
+/* Queue the transitions whose window has passed without the code
+ * returning to its delivered state, followed by `evt`; returns 1 if
+ * anything was queued. */
+static int debounce_settle(struct debounceState *state, const struct input_event *evt) {
+	int unsettled = 0;
+
+	state->queueHead = state->queueCount = 0;
+	debounce_settleCodes(state, state->key, KEY_CNT, EV_KEY, evt, &unsettled);
+	debounce_settleCodes(state, state->sw, SW_CNT, EV_SW, evt, &unsettled);
+	state->unsettled = unsettled;
+
+	if(state->queueCount == 0) {
+		return 0;
+	}
+	state->queue[state->queueCount++] = *evt;
+	return 1;
+}
+
+/* seconds from `now` until the earliest unsettled code's window is over,
+ * 0 if one already is; -1 if none is unsettled */
+static double debounce_remaining(struct debounceState *state, double now) {
+	struct debounceCode *tables[2] = { state->key, state->sw };
+	int counts[2] = { KEY_CNT, SW_CNT };
+	double remaining = -1;
+	int t, code;
+
+	if(!state->unsettled) {
+		return -1;
+	}
+
+	for(t = 0; t < 2; t++) {
+		for(code = 0; tables[t] != NULL && code < counts[t]; code++) {
+			struct debounceCode *c = &tables[t][code];
+			if(!c->known || c->actual == c->delivered) {
+				continue;
+			}
+			double left = c->lastEdge + c->window - now;
+			if(left < 0) {
+				left = 0;
+			}
+			if(remaining < 0 || left < remaining) {
+				remaining = left;
+			}
+		}
+	}
+
+	return remaining;
+}
+
+static void debounce_free(struct debounceState *state) {
+	free(state->key);
+	free(state->sw);
+	free(state->queue);
+	state->key = state->sw = NULL;
+	state->queue = NULL;
+	state->queueHead = state->queueCount = 0;
+	state->unsettled = 0;
+}
+
+/* Rate limiting
+ * 
+ * Token buckets guard against runaway devices: one per device counting
+ * frames, and optionally one per event type counting events. Over-limit
+ * events are coalesced (relative motion summed, other values keeping
+ * their latest state) and delivered just before the next admitted
+ * SYN_REPORT, or simply dropped. Tripping the limit can also release
+ * the device's grab, or close it outright. The action is armed again once
+ * every bucket has refilled, so a device grabbed again after a flood is
+ * released by the next one too. */
+
+enum { LIMIT_COALESCE, LIMIT_DROP, LIMIT_UNGRAB, LIMIT_CLOSE };
+static const char *const limit_actions[] = { "coalesce", "drop", "ungrab", "close", NULL };
+
+enum { LIMIT_PASS, LIMIT_SUPPRESS, LIMIT_INJECT };
+
+struct tokenBucket {
+	double rate, burst; // rate 0 means unlimited
+	double tokens, last;
+};
+
+#define LIMIT_QUEUE_SIZE (REL_CNT + ABS_CNT + KEY_CNT + SW_CNT + 1)
+
+struct rateLimit {
+	struct tokenBucket frames;
+	struct tokenBucket types[EV_CNT];
+	int action;
+	int tripped; // action to take, or negated once taken until refilled
+	int taken; // the last action taken, or 0
+	int frameStart, frameLimited;
+
+	unsigned long limitedFrames, limitedEvents[EV_CNT];
+
+	/* coalesced values awaiting the next admitted frame */
+	int pending;
+	int rel[REL_CNT], abs[ABS_CNT];
+	uint64_t relDirty, absDirty;
+	uint64_t keyDirty[KEY_WORDS], keyValue[KEY_WORDS];
+	uint64_t swDirty, swValue;
+
+	/* events to deliver ahead of reading the device again */
+	struct input_event queue[LIMIT_QUEUE_SIZE];
+	int queueHead, queueCount;
+};
+
+static int bucket_take(struct tokenBucket *bucket, double time) {
+	if(bucket->rate <= 0) {
+		return 1;
+	}
+
+	if(time > bucket->last) {
+		bucket->tokens += (time - bucket->last) * bucket->rate;
+		if(bucket->tokens > bucket->burst) {
+			bucket->tokens = bucket->burst;
+		}
+	}
+	bucket->last = time;
+
+	if(bucket->tokens < 1) {
+		return 0;
+	}
+	bucket->tokens -= 1;
+	return 1;
+}
+
+/* every bucket would be full at `time` */
+static int limit_refilled(struct rateLimit *lim, double time) {
+	int type;
+
+	for(type = -1; type < EV_CNT; type++) {
+		struct tokenBucket *bucket = type < 0 ? &lim->frames : &lim->types[type];
+		if(bucket->rate > 0 && bucket->tokens + (time - bucket->last) * bucket->rate < bucket->burst) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void limit_trip(struct rateLimit *lim) {
+	if(lim->tripped == 0 && (lim->action == LIMIT_UNGRAB || lim->action == LIMIT_CLOSE)) {
+		lim->tripped = lim->action;
+	}
+}
+
+static void limit_coalesce(struct rateLimit *lim, struct input_event *evt) {
+	if(lim->action == LIMIT_DROP) {
+		return;
+	}
+
+	switch(evt->type) {
+	case EV_REL:
+		if(evt->code < REL_CNT) {
+			lim->rel[evt->code] += evt->value;
+			lim->relDirty |= (uint64_t) 1 << evt->code;
+			lim->pending = 1;
+		}
+		break;
+	case EV_ABS:
+		if(evt->code < ABS_CNT) {
+			lim->abs[evt->code] = evt->value;
+			lim->absDirty |= (uint64_t) 1 << evt->code;
+			lim->pending = 1;
+		}
+		break;
+	case EV_KEY:
+		/* repeats carry no state worth keeping */
+		if(evt->code < KEY_CNT && evt->value != 2) {
+			bit_set(lim->keyDirty, evt->code, 1);
+			bit_set(lim->keyValue, evt->code, evt->value);
+			lim->pending = 1;
+		}
+		break;
+	case EV_SW:
+		if(evt->code < SW_CNT) {
+			lim->swDirty |= (uint64_t) 1 << evt->code;
+			if(evt->value) {
+				lim->swValue |= (uint64_t) 1 << evt->code;
+			} else {
+				lim->swValue &= ~((uint64_t) 1 << evt->code);
+			}
+			lim->pending = 1;
+		}
+		break;
+	}
+}
+
+static void limit_push(struct rateLimit *lim, const struct input_event *syn, int type, int code, int value) {
+	struct input_event *evt = &lim->queue[lim->queueCount++];
+	evt->time = syn->time;
+	evt->type = type;
+	evt->code = code;
+	evt->value = value;
+}
+
+/* queue the coalesced events, followed by the SYN_REPORT that admits them */
+static void limit_flush(struct rateLimit *lim, const struct input_event *syn) {
+	int code;
+
+	lim->queueHead = lim->queueCount = 0;
+
+	for(code = 0; code < REL_CNT; code++) {
+		if(lim->relDirty >> code & 1) {
+			limit_push(lim, syn, EV_REL, code, lim->rel[code]);
+			lim->rel[code] = 0;
+		}
+	}
+	for(code = 0; code < ABS_CNT; code++) {
+		if(lim->absDirty >> code & 1) {
+			limit_push(lim, syn, EV_ABS, code, lim->abs[code]);
+		}
+	}
+	for(code = 0; code < KEY_CNT; code++) {
+		if(bit_test(lim->keyDirty, code)) {
+			limit_push(lim, syn, EV_KEY, code, bit_test(lim->keyValue, code));
+		}
+	}
+	for(code = 0; code < SW_CNT; code++) {
+		if(lim->swDirty >> code & 1) {
+			limit_push(lim, syn, EV_SW, code, lim->swValue >> code & 1);
+		}
+	}
+	limit_push(lim, syn, syn->type, syn->code, syn->value);
+
+	lim->relDirty = lim->absDirty = lim->swDirty = 0;
+	memset(lim->keyDirty, 0, sizeof(lim->keyDirty));
+	lim->pending = 0;
+}
+
+/* Decide the fate of a freshly-read event: LIMIT_PASS to process it,
+ * LIMIT_SUPPRESS to drop it, or LIMIT_INJECT when it and coalesced
+ * events were moved to the queue. */
+static int limit_apply(struct rateLimit *lim, struct input_event *evt) {
+	double time = evdev_timestamp(evt);
+
+	if(lim->frameStart) {
+		lim->frameStart = 0;
+		if(lim->tripped < 0 && limit_refilled(lim, time)) {
+			lim->tripped = 0;
+		}
+		lim->frameLimited = !bucket_take(&lim->frames, time);
+		if(lim->frameLimited) {
+			lim->limitedFrames++;
+			limit_trip(lim);
+		}
+	}
+
+	if(evt->type == EV_SYN && evt->code == SYN_REPORT) {
+		lim->frameStart = 1;
+		if(lim->frameLimited) {
+			lim->frameLimited = 0;
+			return LIMIT_SUPPRESS;
+		}
+
+		if(lim->pending) {
+			limit_flush(lim, evt);
+			return LIMIT_INJECT;
+		}
+		return LIMIT_PASS;
+	}
+
+	if(lim->frameLimited) {
+		limit_coalesce(lim, evt);
+		return LIMIT_SUPPRESS;
+	}
+
+	if(evt->type < EV_CNT && !bucket_take(&lim->types[evt->type], time)) {
+		lim->limitedEvents[evt->type]++;
+		limit_trip(lim);
+		limit_coalesce(lim, evt);
+		return LIMIT_SUPPRESS;
+	}
+
+	return LIMIT_PASS;
+}
+
+/* Flight recorder
+ * 
+ * An overwrite-oldest ring of the raw events a Device has read, kept so
+ * they can be dumped after something goes wrong. Live rings are linked
+ * into a list a signal handler can walk; the list is only changed with
+ * signals blocked. */
+
+struct flightRing {
+	struct input_event *events;
+	size_t cap, head, count;
+	int id; // the device's fd, naming its signal dumps
+	struct flightRing *next;
+};
+
+static struct flightRing *flightRings = NULL;
+
+static void flight_record(struct flightRing *ring, const struct input_event *evt) {
+	memcpy(&ring->events[ring->head], evt, sizeof(struct input_event));
+	ring->head = ring->head + 1 == ring->cap ? 0 : ring->head + 1;
+	if(ring->count < ring->cap) {
+		ring->count++;
+	}
+}
+
+static void flight_blockSignals(sigset_t *saved) {
+	sigset_t all;
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, saved);
+}
+
+static struct flightRing *flight_new(size_t cap, int id) {
+	struct flightRing *ring = calloc(1, sizeof(struct flightRing));
+	if(ring == NULL) {
+		return NULL;
+	}
+	ring->events = calloc(cap, sizeof(struct input_event));
+	if(ring->events == NULL) {
+		free(ring);
+		return NULL;
+	}
+	ring->cap = cap;
+	ring->id = id;
+
+	sigset_t saved;
+	flight_blockSignals(&saved);
+	ring->next = flightRings;
+	flightRings = ring;
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+
+	return ring;
+}
+
+static void flight_free(struct flightRing *ring) {
+	struct flightRing **link;
+	sigset_t saved;
+
+	if(ring == NULL) {
+		return;
+	}
+
+	flight_blockSignals(&saved);
+	for(link = &flightRings; *link != NULL; link = &(*link)->next) {
+		if(*link == ring) {
+			*link = ring->next;
+			break;
+		}
+	}
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+
+	free(ring->events);
+	free(ring);
+}
+
+/* Counters
+ * 
+ * Each Device and Uinput keeps I/O counters, updated with a few adds per
+ * syscall, and links them into a list of live objects for metrics(). */
+
+struct ioStats {
+	uint64_t events[EV_CNT]; // read or written, by type
+	uint64_t bytes, syscalls;
+	uint64_t synDropped, shortReads;
+	uint64_t writeAgain, writeIO, writeFailed;
+
+	const char *kind; // "device" or "uinput"
+	char *path;
+	char name[UINPUT_MAX_NAME_SIZE];
+	const int *grabbed; // NULL where grabbing doesn't apply
+	struct ioStats *prev, *next;
+};
+
+static struct ioStats *liveStats = NULL;
+
+static void io_register(struct ioStats *stats, const char *kind, const char *path) {
+	stats->kind = kind;
+	stats->path = strdup(path);
+	stats->prev = NULL;
+	stats->next = liveStats;
+	if(liveStats != NULL) {
+		liveStats->prev = stats;
+	}
+	liveStats = stats;
+}
+
+static void io_unregister(struct ioStats *stats) {
+	if(stats->kind == NULL) {
+		return;
+	}
+
+	if(stats->prev != NULL) {
+		stats->prev->next = stats->next;
+	} else {
+		liveStats = stats->next;
+	}
+	if(stats->next != NULL) {
+		stats->next->prev = stats->prev;
+	}
+
+	free(stats->path);
+	stats->path = NULL;
+	stats->kind = NULL;
+}
+
+/* `count` is read()'s result for the buffer `evts` */
+static void io_countRead(struct ioStats *stats, const struct input_event *evts, ssize_t count) {
+	ssize_t i;
+
+	stats->syscalls++;
+	if(count <= 0) {
+		return;
+	}
+
+	stats->bytes += count;
+	stats->shortReads += count % sizeof(struct input_event) != 0;
+	for(i = 0; i < count / (ssize_t) sizeof(struct input_event); i++) {
+		stats->events[evts[i].type & (EV_CNT - 1)]++;
+		stats->synDropped += evts[i].type == EV_SYN && evts[i].code == SYN_DROPPED;
+	}
+}
+
+/* `written` is write()'s result, with errno still set on failure */
+static void io_countWrite(struct ioStats *stats, const struct input_event *evts, ssize_t written) {
+	ssize_t i;
+
+	stats->syscalls++;
+	if(written < 0) {
+		if(errno == EAGAIN || errno == EWOULDBLOCK) {
+			stats->writeAgain++;
+		} else if(errno == EIO) {
+			stats->writeIO++;
+		} else if(errno != EINTR) {
+			stats->writeFailed++;
+		}
+		return;
+	}
+
+	stats->bytes += written;
+	for(i = 0; i < written / (ssize_t) sizeof(struct input_event); i++) {
+		stats->events[evts[i].type & (EV_CNT - 1)]++;
+	}
+}
+
+/* add the counters to the table on top of the stack */
+static void io_pushStats(lua_State *L, struct ioStats *stats) {
+	int type;
+
+	lua_newtable(L);
+	for(type = 0; type < EV_CNT; type++) {
+		if(stats->events[type]) {
+			lua_pushinteger(L, stats->events[type]);
+			lua_rawseti(L, -2, type);
+		}
+	}
+	lua_setfield(L, -2, "events");
+
+#define IO_FIELD(field) \
+	lua_pushinteger(L, stats->field); \
+	lua_setfield(L, -2, #field);
+
+	IO_FIELD(bytes)
+	IO_FIELD(syscalls)
+	IO_FIELD(synDropped)
+	IO_FIELD(shortReads)
+	IO_FIELD(writeAgain)
+	IO_FIELD(writeIO)
+	IO_FIELD(writeFailed)
+
+#undef IO_FIELD
+
+	if(stats->grabbed != NULL) {
+		lua_pushboolean(L, *stats->grabbed);
+		lua_setfield(L, -2, "grabbed");
+	}
+}
+
+/* Force-feedback effects
+ * 
+ * Effects cross into Lua as tables with a `type` (FF_RUMBLE, FF_PERIODIC
+ * or FF_CONSTANT; others keep only the common fields), `id`, `length` and
+ * `delay` in seconds, `direction`, and the type's parameters:
+ * `strong` and `weak` for rumble, `waveform`, `period` (seconds),
+ * `magnitude` and `offset` for periodic, `level` for constant. */
+
+static void effect_push(lua_State *L, const struct ff_effect *effect) {
+	lua_newtable(L);
+
+	lua_pushinteger(L, effect->type);
+	lua_setfield(L, -2, "type");
+	lua_pushinteger(L, effect->id);
+	lua_setfield(L, -2, "id");
+	lua_pushinteger(L, effect->direction);
+	lua_setfield(L, -2, "direction");
+	lua_pushnumber(L, effect->replay.length / 1000.0);
+	lua_setfield(L, -2, "length");
+	lua_pushnumber(L, effect->replay.delay / 1000.0);
+	lua_setfield(L, -2, "delay");
+
+	switch(effect->type) {
+	case FF_RUMBLE:
+		lua_pushinteger(L, effect->u.rumble.strong_magnitude);
+		lua_setfield(L, -2, "strong");
+		lua_pushinteger(L, effect->u.rumble.weak_magnitude);
+		lua_setfield(L, -2, "weak");
+		break;
+	case FF_PERIODIC:
+		lua_pushinteger(L, effect->u.periodic.waveform);
+		lua_setfield(L, -2, "waveform");
+		lua_pushnumber(L, effect->u.periodic.period / 1000.0);
+		lua_setfield(L, -2, "period");
+		lua_pushinteger(L, effect->u.periodic.magnitude);
+		lua_setfield(L, -2, "magnitude");
+		lua_pushinteger(L, effect->u.periodic.offset);
+		lua_setfield(L, -2, "offset");
+		break;
+	case FF_CONSTANT:
+		lua_pushinteger(L, effect->u.constant.level);
+		lua_setfield(L, -2, "level");
+		break;
+	}
+}
+
+/* fill an effect from a table shaped like effect_push's, for uploading */
+static void effect_check(lua_State *L, int index, struct ff_effect *effect) {
+	luaL_checktype(L, index, LUA_TTABLE);
+	memset(effect, 0, sizeof(struct ff_effect));
+
+	lua_getfield(L, index, "type");
+	effect->type = luaL_checkinteger(L, -1);
+	lua_pop(L, 1);
+	effect->id = -1;
+	effect->direction = option_number(L, index, "direction", 0);
+	effect->replay.length = option_number(L, index, "length", 0) * 1000;
+	effect->replay.delay = option_number(L, index, "delay", 0) * 1000;
+
+	switch(effect->type) {
+	case FF_RUMBLE:
+		effect->u.rumble.strong_magnitude = option_number(L, index, "strong", 0);
+		effect->u.rumble.weak_magnitude = option_number(L, index, "weak", 0);
+		break;
+	case FF_PERIODIC:
+		effect->u.periodic.waveform = option_number(L, index, "waveform", FF_SINE);
+		effect->u.periodic.period = option_number(L, index, "period", 0) * 1000;
+		effect->u.periodic.magnitude = option_number(L, index, "magnitude", 0);
+		effect->u.periodic.offset = option_number(L, index, "offset", 0);
+		break;
+	case FF_CONSTANT:
+		effect->u.constant.level = option_number(L, index, "level", 0);
+		break;
+	default:
+		luaL_argerror(L, index, "unsupported effect type");
+	}
+}
+
+/* Evdev wrappers */
+
+#define EVDEV_USERDATA "us.tropi.evdev.struct.inputDevice"
+struct inputDevice {
+	int fd; /* file descriptor */
+	int grabbed;
+	struct axisFilter *filters; /* per ABS axis; NULL until configured */
+	int frameKept, frameDropped; /* events passed/suppressed since SYN_REPORT */
+	struct keyState keys;
+	struct hotkeys *hotkeys; /* kept alive by the device's uservalue */
+	struct hotkeyState hotkeyState;
+	struct gestureState *gestures; /* NULL unless recognizing gestures */
+	struct debounceState debounce;
+	struct rateLimit *limit; /* NULL unless rate limited */
+	struct flightRing *flight; /* NULL unless recording */
+	struct ioStats stats;
+	struct input_event *batch, *batchRaw; /* readBatch() output and input */
+	size_t batchCap, batchCount;
+	struct effectCache *effects; /* NULL until an effect is uploaded */
+	int ended; /* why reads stopped, or EVDEV_LIVE */
+	int revoked; /* revoke() was called on this device */
+	dev_t endedDev; /* for telling EVDEV_ENDED_NODEV apart later */
+	uint64_t endedAt;
+};
+
+#define CHECK_EVDEV(dev, index) \
+struct inputDevice *dev = luaL_checkudata(L, index, EVDEV_USERDATA); \
+if(dev->fd == -1) { \
+	return luaL_error(L, "Trying to use closed device event node."); \
+}
+
+static int evdev_open(lua_State *L) {
+	const char *path = luaL_checkstring(L, 1);
+	int writeMode = lua_toboolean(L, 2);
+
+	/* create userdata */
+	struct inputDevice *dev = lua_newuserdata(L, sizeof(struct inputDevice));
+	memset(dev, 0, sizeof(struct inputDevice));
+	dev->fd = -1;
+
+	luaL_setmetatable(L, EVDEV_USERDATA);
+
+	/* holds objects attached to the device */
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+	
+	if(writeMode) {
+		// if requested, attempt opening for writing so we can send LED events and such
+		dev->fd = open(path, O_RDWR | O_CLOEXEC);
+	}
+	
+	if(dev->fd < 0) {
+		// writing mode not requested or not allowed,
+		// try falling back to reading events only
+		dev->fd = open(path, O_RDONLY | O_CLOEXEC);
+	}
+
+	if(dev->fd < 0) {
+		// still couldn't open, nothing to be done.
+		return luaL_error(L, "Couldn't open device node.");
+	}
+
+	io_register(&dev->stats, "device", path);
+	dev->stats.grabbed = &dev->grabbed;
+	ioctl(dev->fd, EVIOCGNAME(sizeof(dev->stats.name) - 1), dev->stats.name);
+
+	return 1;
+}
+
+/* push a Device around an fd opened elsewhere, such as one handed off by
+ * another process or the read end of a generator's pipe */
+static struct inputDevice *evdev_wrap(lua_State *L, int fd, const char *path) {
+	struct inputDevice *dev = lua_newuserdata(L, sizeof(struct inputDevice));
+	memset(dev, 0, sizeof(struct inputDevice));
+	dev->fd = fd;
+	luaL_setmetatable(L, EVDEV_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	io_register(&dev->stats, "device", path);
+	dev->stats.grabbed = &dev->grabbed;
+	ioctl(dev->fd, EVIOCGNAME(sizeof(dev->stats.name) - 1), dev->stats.name);
+
+	return dev;
+}
+
+/* a hotkey matched; the device is at stack index `index` */
+static void evdev_fireHotkey(lua_State *L, int index, int binding, double time) {
+	lua_getuservalue(L, index);
+	lua_getfield(L, -1, "hotkeys");
+	lua_getuservalue(L, -1);
+	lua_rawgeti(L, -1, binding + 1);
+	lua_pushnumber(L, time);
+	lua_pushvalue(L, index);
+	lua_call(L, 2, 0);
+	lua_pop(L, 3);
+}
+
+static int evdev_key(lua_State *L, int index, struct inputDevice *dev, struct input_event *evt) {
+	if(evt->code >= KEY_CNT) {
+		return 1;
+	}
+
+	keys_update(&dev->keys, evt->code, evt->value);
+
+	if(dev->hotkeys == NULL) {
+		return 1;
+	}
+
+	struct hotkeyState *state = &dev->hotkeyState;
+	if(bit_test(state->swallowed, evt->code)) {
+		/* repeats and release of a swallowed hotkey go with it */
+		if(evt->value == 0) {
+			bit_set(state->swallowed, evt->code, 0);
+		}
+		return 0;
+	}
+
+	if(evt->value != 1) {
+		return 1;
+	}
+
+	double time = evdev_timestamp(evt);
+	int binding = hotkeys_press(dev->hotkeys, state, &dev->keys, evt->code, time);
+	if(binding < 0) {
+		return 1;
+	}
+
+	/* only swallow when grabbed; otherwise everyone else saw it anyway */
+	int swallow = dev->grabbed && dev->hotkeys->bindings[binding].swallow;
+	if(swallow) {
+		bit_set(state->swallowed, evt->code, 1);
+	}
+
+	evdev_fireHotkey(L, index, binding, time);
+
+	return !swallow;
+}
+
+static void evdev_fireGesture(lua_State *L, int index, struct gesture *g, double time) {
+	lua_getuservalue(L, index);
+	lua_getfield(L, -1, "gestures");
+	lua_pushstring(L, g->name);
+	lua_pushinteger(L, g->fingers);
+	lua_pushnumber(L, g->a);
+	lua_pushnumber(L, g->b);
+	lua_pushnumber(L, time);
+	lua_pushvalue(L, index);
+	lua_call(L, 6, 0);
+	lua_pop(L, 1);
+}
+
+/* Run one freshly-read event through the device's C-side stages;
+ * returns 1 if it should be delivered, 0 if it was suppressed.
+ * The device's userdata is at stack index `index`, for callbacks. */
+static int evdev_process(lua_State *L, int index, struct inputDevice *dev, struct input_event *evt) {
+	int keep = 1;
+
+	if(evt->type == EV_SYN && evt->code == SYN_REPORT) {
+		struct gesture recognized;
+		if(dev->gestures != NULL && gesture_frame(dev->gestures, evdev_timestamp(evt), &recognized)) {
+			evdev_fireGesture(L, index, &recognized, evdev_timestamp(evt));
+		}
+
+		/* a frame whose every event was suppressed is suppressed too */
+		keep = dev->frameKept > 0 || dev->frameDropped == 0;
+		dev->frameKept = dev->frameDropped = 0;
+		return keep;
+	}
+
+	if(evt->type == EV_ABS && dev->gestures != NULL && evt->code >= ABS_MT_SLOT) {
+		gesture_event(dev->gestures, evt);
+		keep = dev->gestures->passthrough;
+	} else if(evt->type == EV_ABS && dev->filters != NULL && evt->code < ABS_CNT
+		&& dev->filters[evt->code].enabled) {
+		keep = filter_apply(&dev->filters[evt->code], &evt->value, evdev_timestamp(evt));
+	} else if(evt->type == EV_KEY) {
+		keep = debounce_apply(&dev->debounce, evt) && evdev_key(L, index, dev, evt);
+	} else if(evt->type == EV_SW) {
+		keep = debounce_apply(&dev->debounce, evt);
+	}
+
+	if(keep) {
+		dev->frameKept++;
+	} else {
+		dev->frameDropped++;
+	}
+	return keep;
+}
+
+static int evdev_readable(int fd) {
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 0) > 0;
+}
+
+static int evdev_pendingEvents(struct inputDevice *dev) {
+	int pending = dev->debounce.queueCount - dev->debounce.queueHead;
+	if(dev->limit != NULL) {
+		pending += dev->limit->queueCount - dev->limit->queueHead;
+	}
+	return pending;
+}
+
+/* take the next event queued by debouncing or the rate limit */
+static void evdev_nextPending(struct inputDevice *dev, struct input_event *evt) {
+	if(dev->debounce.queueHead < dev->debounce.queueCount) {
+		*evt = dev->debounce.queue[dev->debounce.queueHead++];
+	} else {
+		*evt = dev->limit->queue[dev->limit->queueHead++];
+	}
+}
+
+/* nanoseconds until one of the device's debounced transitions settles,
+ * 0 if one is due; -1 if none is waiting to */
+static int64_t evdev_settleWait(struct inputDevice *dev) {
+	struct timeval now = event_now();
+	double remaining = debounce_remaining(&dev->debounce, now.tv_sec + now.tv_usec / 1000000.0);
+	return remaining < 0 ? -1 : (int64_t) ceil(remaining * 1e9);
+}
+
+/* Queue the debounced transitions whose window ran out while the device
+ * stayed quiet, closed by a SYN_REPORT of their own; returns 1 if any
+ * were. */
+static int evdev_settleDue(struct inputDevice *dev) {
+	struct input_event syn;
+
+	if(!dev->debounce.unsettled || evdev_pendingEvents(dev) > 0 || evdev_readable(dev->fd)) {
+		return 0;
+	}
+
+	memset(&syn, 0, sizeof(syn));
+	syn.time = event_now();
+	syn.type = EV_SYN;
+	syn.code = SYN_REPORT;
+	return debounce_settle(&dev->debounce, &syn);
+}
+
+/* Block until the device is readable or one of its debounced transitions
+ * settles; returns 1 if one did, leaving it queued. */
+static int evdev_awaitSettle(struct inputDevice *dev) {
+	for(;;) {
+		int64_t wait = evdev_settleWait(dev);
+		if(wait < 0) {
+			return 0;
+		} else if(wait == 0) {
+			return evdev_settleDue(dev);
+		}
+
+		struct pollfd pfd = { dev->fd, POLLIN, 0 };
+		int ready = poll(&pfd, 1, (int) ((wait + 999999) / 1000000));
+		if(ready > 0 || (ready < 0 && errno != EINTR)) {
+			return 0;
+		}
+	}
+}
+
+/* act on a tripped rate limit; returns 0 if the device was closed */
+static int evdev_limitAction(struct inputDevice *dev) {
+	struct rateLimit *lim = dev->limit;
+
+	if(lim->tripped == LIMIT_UNGRAB && dev->grabbed) {
+		ioctl(dev->fd, EVIOCGRAB, 0);
+		dev->grabbed = 0;
+	} else if(lim->tripped == LIMIT_CLOSE) {
+		close(dev->fd);
+		dev->fd = -1;
+	}
+	if(lim->tripped > 0) {
+		lim->taken = lim->tripped;
+		lim->tripped = -lim->tripped;
+	}
+
+	return dev->fd != -1;
+}
+
+/* End of stream
+ * 
+ * A revoked fd (EVIOCREVOKE) and an unplugged device both fail reads with
+ * ENODEV. They differ in what's left: unplugging deletes the device, and
+ * with it /sys/dev/char/<major>:<minor>, while revocation leaves both in
+ * place. The kernel wakes readers before it deletes the device, so the
+ * read can't wait for the answer: the end is noted as EVDEV_ENDED_NODEV
+ * and resolved whenever it's asked about, as unplugged once the sysfs
+ * entry is gone or revoked if it's still there a quarter second later.
+ * Until then, and without sysfs, a device not revoked through this handle
+ * counts as unplugged. */
+
+enum { EVDEV_LIVE, EVDEV_ENDED_EOF, EVDEV_ENDED_UNPLUGGED, EVDEV_ENDED_REVOKED, EVDEV_ENDED_CLOSED, EVDEV_ENDED_FAILED, EVDEV_ENDED_NODEV };
+static const char *const evdev_endReasons[] = { "live", "eof", "unplugged", "revoked", "closed", "failed", "unplugged", NULL };
+
+#define EVDEV_UNPLUG_WAIT_NS 250000000 // for an unplug to delete the device
+
+/* classify a read on `fd` that returned `count`, with errno as left by
+ * it, without waiting; `path` may be NULL. EVDEV_ENDED_NODEV leaves the
+ * device number in *rdev, for evdev_resolveEnd(). */
+static int evdev_endReason(int fd, const char *path, ssize_t count, dev_t *rdev) {
+	struct stat opened, named;
+
+	if(count == 0) {
+		return EVDEV_ENDED_EOF;
+	} else if(errno != ENODEV) {
+		return EVDEV_ENDED_FAILED;
+	}
+
+	if(fstat(fd, &opened) < 0 || opened.st_nlink == 0) {
+		return EVDEV_ENDED_UNPLUGGED;
+	}
+
+	if(!S_ISCHR(opened.st_mode)) {
+		/* not a device node; all there is to go by is the path */
+		if(path != NULL && (stat(path, &named) < 0
+			|| named.st_rdev != opened.st_rdev || named.st_ino != opened.st_ino)) {
+			return EVDEV_ENDED_UNPLUGGED;
+		}
+		return EVDEV_ENDED_REVOKED;
+	}
+
+	if(access("/sys/dev/char", F_OK) < 0) {
+		return EVDEV_ENDED_UNPLUGGED;
+	}
+
+	*rdev = opened.st_rdev;
+	return EVDEV_ENDED_NODEV;
+}
+
+/* settle EVDEV_ENDED_NODEV for a read that ended at `since`
+ * (CLOCK_MONOTONIC nanoseconds), if it can be yet */
+static int evdev_resolveEnd(int reason, dev_t rdev, uint64_t since) {
+	char entry[64];
+
+	if(reason != EVDEV_ENDED_NODEV) {
+		return reason;
+	}
+
+	snprintf(entry, sizeof(entry), "/sys/dev/char/%u:%u", major(rdev), minor(rdev));
+	if(access(entry, F_OK) < 0) {
+		return EVDEV_ENDED_UNPLUGGED;
+	} else if(monotonic_ns() - since >= EVDEV_UNPLUG_WAIT_NS) {
+		return EVDEV_ENDED_REVOKED;
+	}
+	return EVDEV_ENDED_NODEV;
+}
+
+static void evdev_end(struct inputDevice *dev, ssize_t count) {
+	if(dev->ended == EVDEV_LIVE) {
+		dev->ended = dev->revoked ? EVDEV_ENDED_REVOKED : evdev_endReason(dev->fd, dev->stats.path, count, &dev->endedDev);
+		dev->endedAt = monotonic_ns();
+	}
+}
+
+/* Longest run of fully suppressed frames one read will skip over before
+ * handing back a SYN_REPORT, so a flooding device can't monopolize the
+ * caller. */
+#define EVDEV_MAX_SKIPPED_FRAMES 64
+
+enum { EVDEV_DROP, EVDEV_KEEP, EVDEV_INJECTED, EVDEV_CLOSED };
+
+/* Take a freshly-read event through the flight recorder, rate limit and
+ * processing stages. EVDEV_INJECTED means it now waits, behind coalesced
+ * events or settling debounced transitions, in a queue. */
+static int evdev_accept(lua_State *L, int index, struct inputDevice *dev, struct input_event *evt) {
+	if(dev->flight != NULL) {
+		flight_record(dev->flight, evt);
+	}
+
+	int verdict = dev->limit != NULL ? limit_apply(dev->limit, evt) : LIMIT_PASS;
+
+	if(dev->limit != NULL && dev->limit->tripped > 0 && !evdev_limitAction(dev)) {
+		return EVDEV_CLOSED;
+	}
+
+	if(verdict == LIMIT_INJECT) {
+		return EVDEV_INJECTED;
+	} else if(verdict == LIMIT_SUPPRESS) {
+		if(evt->type == EV_SYN && evt->code == SYN_REPORT) {
+			dev->frameKept = dev->frameDropped = 0;
+		}
+		return EVDEV_DROP;
+	}
+
+	if(dev->debounce.unsettled && debounce_settle(&dev->debounce, evt)) {
+		return EVDEV_INJECTED;
+	}
+
+	return evdev_process(L, index, dev, evt) ? EVDEV_KEEP : EVDEV_DROP;
+}
+
+/* Read the next event that survives processing; returns 0 on EOF.
+ * The device's userdata must be at stack index `index`. */
+static int evdev_fetch(lua_State *L, int index, struct inputDevice *dev, struct input_event *evt) {
+	const size_t evt_size = sizeof(struct input_event);
+	int skipped = 0;
+
+	for(;;) {
+		int keep;
+
+		if(evdev_pendingEvents(dev) == 0 && dev->debounce.unsettled) {
+			evdev_awaitSettle(dev);
+		}
+
+		if(evdev_pendingEvents(dev) > 0) {
+			evdev_nextPending(dev, evt);
+			keep = evdev_process(L, index, dev, evt);
+		} else {
+			memset(evt, 0, evt_size);
+
+			int count = read(dev->fd, evt, evt_size);
+			io_countRead(&dev->stats, evt, count);
+
+			if(count <= 0) {
+				/* unplugged, revoked, or the end of a pipe or file */
+				evdev_end(dev, count);
+				return 0;
+			} else if((unsigned int) count < evt_size) {
+				return luaL_error(L, "Failure reading input event.");
+			}
+
+			int result = evdev_accept(L, index, dev, evt);
+			if(result == EVDEV_CLOSED) {
+				dev->ended = EVDEV_ENDED_CLOSED;
+				return 0;
+			} else if(result == EVDEV_INJECTED) {
+				continue;
+			}
+			keep = result == EVDEV_KEEP;
+		}
+
+		if(keep) {
+			return 1;
+		}
+
+		/* Suppressed events inside a frame are always followed by the
+		 * rest of it, but don't block on whatever comes after a fully
+		 * suppressed frame; deliver its SYN_REPORT instead. */
+		if(evt->type == EV_SYN && evdev_pendingEvents(dev) == 0
+			&& (!evdev_readable(dev->fd) || ++skipped >= EVDEV_MAX_SKIPPED_FRAMES)) {
+			return 1;
+		}
+	}
+}
+
+/* the nil, reason returned when reads come to an end */
+static int evdev_pushEnd(lua_State *L, struct inputDevice *dev) {
+	dev->ended = evdev_resolveEnd(dev->ended, dev->endedDev, dev->endedAt);
+	int reason = dev->ended;
+	if(reason == EVDEV_LIVE) {
+		reason = dev->revoked ? EVDEV_ENDED_REVOKED : EVDEV_ENDED_CLOSED;
+	}
+
+	lua_pushnil(L);
+	lua_pushstring(L, evdev_endReasons[reason]);
+	return 2;
+}
+
+static int evdev_tryRead(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	struct input_event evt;
+
+	if(!evdev_fetch(L, 1, dev, &evt)) {
+		return evdev_pushEnd(L, dev);
+	}
+
+	/* return: timestamp, event type, event code, event value */
+	lua_pushnumber(L, evdev_timestamp(&evt));
+	lua_pushinteger(L, evt.type);
+	lua_pushinteger(L, evt.code);
+	lua_pushinteger(L, evt.value);
+	
+	return 4;
+}
+
+static int evdev_read(lua_State *L) {
+	int count = evdev_tryRead(L);
+
+	if(lua_isnil(L, -count)) {
+		return luaL_error(L, "End of input event stream (%s).", lua_tostring(L, -1));
+	}
+
+	return count;
+}
+
+/* ended() - nil while events can still be read; afterwards why they
+ * stopped: "eof" for the end of a pipe or file, "unplugged", "revoked",
+ * "closed" by a rate limit or close(), or "failed" */
+static int evdev_ended(lua_State *L) {
+	struct inputDevice *dev = luaL_checkudata(L, 1, EVDEV_USERDATA);
+
+	if(dev->ended == EVDEV_LIVE && dev->fd != -1) {
+		lua_pushnil(L);
+	} else {
+		evdev_pushEnd(L, dev);
+		lua_remove(L, -2);
+	}
+
+	return 1;
+}
+
+/* readAsync() - like tryRead(), but inside a coroutine, yield the device
+ * to evdev.run() instead of blocking; run() resumes the coroutine with
+ * the event once the device is readable. */
+static int evdev_readAsync(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	lua_settop(L, 1);
+	int isMain = lua_pushthread(L);
+	lua_pop(L, 1);
+
+	if(isMain || evdev_pendingEvents(dev) > 0 || evdev_readable(dev->fd) || evdev_settleWait(dev) == 0) {
+		return evdev_tryRead(L);
+	}
+
+	return lua_yield(L, 1);
+}
+
+/* Batched reads
+ * 
+ * readBatch() takes up to `max` events in a single read(), runs them
+ * through the same stages as read(), and leaves the survivors in an
+ * array of struct input_event that the FFI binding can walk directly.
+ * The output has room for the rate limit's whole coalescing queue and
+ * every settling debounced transition on top of `max`, which bounds what
+ * they can inject. */
+
+#define EVDEV_BATCH_DEFAULT 64
+#define EVDEV_BATCH_MAX 4096
+
+/* drain the rate limit's queue into the batch */
+static void evdev_batchInjected(lua_State *L, struct inputDevice *dev) {
+	while(evdev_pendingEvents(dev) > 0) {
+		struct input_event *evt = &dev->batch[dev->batchCount];
+		evdev_nextPending(dev, evt);
+		dev->batchCount += evdev_process(L, 1, dev, evt);
+	}
+}
+
+/* readBatch([max]) returns the number of events kept and a light userdata
+ * pointing at them, valid until the next readBatch(); nil on EOF */
+static int evdev_readBatch(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	lua_Integer max = luaL_optinteger(L, 2, EVDEV_BATCH_DEFAULT);
+
+	luaL_argcheck(L, max >= 1 && max <= EVDEV_BATCH_MAX, 2, "batch size out of range");
+
+	if(dev->batchCap != (size_t) max) {
+		struct input_event *batch = realloc(dev->batch, (max + LIMIT_QUEUE_SIZE + DEBOUNCE_QUEUE_SIZE) * sizeof(struct input_event));
+		if(batch == NULL) {
+			return luaL_error(L, "Out of memory allocating event batch.");
+		}
+		dev->batch = batch;
+		batch = realloc(dev->batchRaw, max * sizeof(struct input_event));
+		if(batch == NULL) {
+			return luaL_error(L, "Out of memory allocating event batch.");
+		}
+		dev->batchRaw = batch;
+		dev->batchCap = max;
+	}
+
+	dev->batchCount = 0;
+	evdev_batchInjected(L, dev);
+
+	/* a quiet device can still owe settling transitions */
+	if(dev->batchCount == 0 && evdev_awaitSettle(dev)) {
+		evdev_batchInjected(L, dev);
+	}
+
+	/* don't block behind events that are already here */
+	if(dev->batchCount == 0 || evdev_readable(dev->fd)) {
+		ssize_t count = read(dev->fd, dev->batchRaw, max * sizeof(struct input_event));
+		io_countRead(&dev->stats, dev->batchRaw, count);
+
+		if(count <= 0) {
+			/* unplugged, revoked, or the end of a pipe or file */
+			evdev_end(dev, count);
+			if(dev->batchCount == 0) {
+				return evdev_pushEnd(L, dev);
+			}
+			count = 0;
+		} else if(count % sizeof(struct input_event) != 0) {
+			return luaL_error(L, "Failure reading input event.");
+		}
+
+		size_t i;
+		for(i = 0; i < count / sizeof(struct input_event); i++) {
+			struct input_event *evt = &dev->batch[dev->batchCount];
+			*evt = dev->batchRaw[i];
+
+			int result = evdev_accept(L, 1, dev, evt);
+			if(result == EVDEV_KEEP) {
+				dev->batchCount++;
+			} else if(result == EVDEV_INJECTED) {
+				evdev_batchInjected(L, dev);
+			} else if(result == EVDEV_CLOSED) {
+				dev->ended = EVDEV_ENDED_CLOSED;
+				if(dev->batchCount == 0) {
+					return evdev_pushEnd(L, dev);
+				}
+				break;
+			}
+		}
+	}
+
+	lua_pushinteger(L, dev->batchCount);
+	lua_pushlightuserdata(L, dev->batch);
+	return 2;
+}
+
+/* event(i) returns the i-th event of the last batch, like read() */
+static int evdev_event(lua_State *L) {
+	struct inputDevice *dev = luaL_checkudata(L, 1, EVDEV_USERDATA);
+	lua_Integer i = luaL_checkinteger(L, 2);
+
+	luaL_argcheck(L, i >= 1 && (size_t) i <= dev->batchCount, 2, "no such event in batch");
+
+	struct input_event *evt = &dev->batch[i - 1];
+	lua_pushnumber(L, evdev_timestamp(evt));
+	lua_pushinteger(L, evt->type);
+	lua_pushinteger(L, evt->code);
+	lua_pushinteger(L, evt->value);
+
+	return 4;
+}
+
+static int evdev_grab(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	int wantGrab = lua_isnone(L, 2) || lua_toboolean(L, 2);
+
+	if(ioctl(dev->fd, EVIOCGRAB, wantGrab) < 0) {
+		/* Presuming any error here means a failed grab;
+		 * not sure if any error besides EBUSY is possible. */
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+	
+	dev->grabbed = wantGrab;
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+/* revoke() - cut off this open file for good (EVIOCREVOKE), including
+ * every copy of the fd handed to other processes, which then read
+ * "revoked"; unlike close(), it doesn't wait for them. Returns true, or
+ * false and an error message. */
+static int evdev_revoke(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	if(ioctl(dev->fd, EVIOCREVOKE, NULL) < 0) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(errno));
+		return 2;
+	}
+
+	/* the kernel releases the grab along with the client */
+	dev->revoked = 1;
+	dev->grabbed = 0;
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int evdev_write(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	
+	struct input_event evt;
+	memset(&evt, 0, sizeof(struct input_event));
+	
+	evt.type = luaL_checkinteger(L, 2);
+	evt.code = luaL_checkinteger(L, 3);
+	evt.value = luaL_checkinteger(L, 4);
+	
+	ssize_t written = write(dev->fd, &evt, sizeof(struct input_event));
+	io_countWrite(&dev->stats, &evt, written);
+	if(written != sizeof(struct input_event)) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(errno));
+		return 2;
+	}
+	
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int evdev_filterAxis(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	return filter_configure(L, &dev->filters);
+}
+
+/* gestures(callback[, options]) starts recognizing; nil stops */
+static int evdev_gestures(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	if(lua_isnoneornil(L, 2)) {
+		free(dev->gestures);
+		dev->gestures = NULL;
+		lua_getuservalue(L, 1);
+		lua_pushnil(L);
+		lua_setfield(L, -2, "gestures");
+		return 0;
+	}
+
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	if(lua_isnoneornil(L, 3)) {
+		lua_settop(L, 2);
+		lua_newtable(L);
+	}
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	struct gestureState *g = dev->gestures;
+	if(g == NULL) {
+		g = calloc(1, sizeof(struct gestureState));
+		if(g == NULL) {
+			return luaL_error(L, "Out of memory allocating gesture state.");
+		}
+	}
+
+	g->tapTime = option_number(L, 3, "tapTime", 0.25);
+	g->tapDistance = option_number(L, 3, "tapDistance", 50);
+	g->swipeDistance = option_number(L, 3, "swipeDistance", 200);
+	g->pinchThreshold = option_number(L, 3, "pinchThreshold", 0.2);
+	g->rotateThreshold = option_number(L, 3, "rotateThreshold", 0.35);
+	lua_getfield(L, 3, "passthrough");
+	g->passthrough = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+
+	if(dev->gestures == NULL) {
+		/* pick up the slot the kernel left selected */
+		struct input_absinfo slot;
+		g->slot = ioctl(dev->fd, EVIOCGABS(ABS_MT_SLOT), &slot) == 0 ? slot.value : 0;
+		gesture_reset(g);
+		gesture_loadSlots(g, dev->fd);
+		dev->gestures = g;
+	}
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_setfield(L, -2, "gestures");
+
+	return 0;
+}
+
+/* debounce(type, code, window); a nil code covers every code of the
+ * type, and a nil or zero window turns debouncing off */
+static int evdev_debounce(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	int type = luaL_checkinteger(L, 2);
+	int code = luaL_opt(L, luaL_checkinteger, 3, -1);
+	double window = luaL_optnumber(L, 4, 0);
+
+	luaL_argcheck(L, type == EV_KEY || type == EV_SW, 2, "only EV_KEY and EV_SW can be debounced");
+	int count = event_codeCount(type);
+	luaL_argcheck(L, code < count, 3, "event code out of range for its type");
+
+	struct debounceCode **codes = type == EV_KEY ? &dev->debounce.key : &dev->debounce.sw;
+	if(*codes == NULL) {
+		if(window <= 0) {
+			return 0;
+		}
+		if(dev->debounce.queue == NULL) {
+			dev->debounce.queue = malloc(DEBOUNCE_QUEUE_SIZE * sizeof(struct input_event));
+		}
+		*codes = calloc(count, sizeof(struct debounceCode));
+		if(*codes == NULL || dev->debounce.queue == NULL) {
+			return luaL_error(L, "Out of memory allocating debounce state.");
+		}
+	}
+
+	int first = code < 0 ? 0 : code;
+	int last = code < 0 ? count - 1 : code;
+	for(code = first; code <= last; code++) {
+		(*codes)[code].window = window;
+	}
+
+	return 0;
+}
+
+/* limit(type, rate, burst[, action]); a nil type limits whole frames,
+ * and a nil or zero rate removes the limit. The action is the device's,
+ * so it's only changed when given. */
+static int evdev_limit(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	int whole = lua_isnoneornil(L, 2);
+	lua_Integer type = whole ? -1 : luaL_checkinteger(L, 2);
+	double rate = luaL_optnumber(L, 3, 0);
+	double burst = luaL_optnumber(L, 4, rate);
+	int action = lua_isnoneornil(L, 5) ? -1 : luaL_checkoption(L, 5, NULL, limit_actions);
+
+	luaL_argcheck(L, whole || (type >= 0 && type < EV_CNT), 2, "event type out of range");
+	luaL_argcheck(L, burst >= 1 || rate <= 0, 4, "burst must allow at least one");
+
+	if(dev->limit == NULL) {
+		if(rate <= 0) {
+			return 0;
+		}
+		dev->limit = calloc(1, sizeof(struct rateLimit));
+		if(dev->limit == NULL) {
+			return luaL_error(L, "Out of memory allocating rate limit.");
+		}
+		dev->limit->frameStart = 1;
+	}
+
+	struct tokenBucket *bucket = type < 0 ? &dev->limit->frames : &dev->limit->types[type];
+	bucket->rate = rate > 0 ? rate : 0;
+	bucket->burst = burst;
+	bucket->tokens = burst;
+	bucket->last = 0;
+	if(action >= 0) {
+		dev->limit->action = action;
+	}
+
+	return 0;
+}
+
+/* 0 when events are already waiting, so cqueues doesn't sleep on them,
+ * or the seconds until a debounced transition settles */
+static int evdev_timeout(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	int64_t wait = evdev_pendingEvents(dev) > 0 ? 0 : evdev_settleWait(dev);
+	if(wait < 0) {
+		return 0;
+	}
+
+	lua_pushnumber(L, wait / 1e9);
+	return 1;
+}
+
+static int evdev_pending(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	lua_pushinteger(L, evdev_pendingEvents(dev));
+	return 1;
+}
+
+static int evdev_stats(lua_State *L) {
+	/* still readable after the device closes, to see why it did */
+	struct inputDevice *dev = luaL_checkudata(L, 1, EVDEV_USERDATA);
+
+	lua_newtable(L);
+	io_pushStats(L, &dev->stats);
+	lua_pushinteger(L, dev->debounce.suppressed);
+	lua_setfield(L, -2, "debounced");
+
+	if(dev->limit != NULL) {
+		struct rateLimit *lim = dev->limit;
+		unsigned long total = 0;
+		int type;
+
+		lua_pushinteger(L, lim->limitedFrames);
+		lua_setfield(L, -2, "limitedFrames");
+
+		lua_newtable(L);
+		for(type = 0; type < EV_CNT; type++) {
+			if(lim->limitedEvents[type]) {
+				lua_pushinteger(L, lim->limitedEvents[type]);
+				lua_rawseti(L, -2, type);
+				total += lim->limitedEvents[type];
+			}
+		}
+		lua_setfield(L, -2, "limitedByType");
+
+		lua_pushinteger(L, total);
+		lua_setfield(L, -2, "limitedEvents");
+
+		if(lim->taken) {
+			lua_pushstring(L, limit_actions[lim->taken]);
+			lua_setfield(L, -2, "limitAction");
+		}
+	}
+
+	return 1;
+}
+
+/* attach a Hotkeys matcher, or detach with nil */
+static int evdev_hotkeys(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	struct hotkeys *hk = NULL;
+
+	if(!lua_isnoneornil(L, 2)) {
+		hk = luaL_checkudata(L, 2, HOTKEYS_USERDATA);
+	}
+	lua_settop(L, 2);
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_setfield(L, -2, "hotkeys");
+
+	dev->hotkeys = hk;
+	memset(&dev->hotkeyState, 0, sizeof(struct hotkeyState));
+
+	return 0;
+}
+
+/* Effect cache
+ * 
+ * Force-feedback effects are uploaded once and played by handle, so
+ * playing one is a single write. The device only holds a few effects at
+ * a time (EVIOCGEFFECTS), so the least recently used one is erased to make
+ * room, and re-uploaded if played again. Handles index the cache and
+ * stay valid until eraseEffect(); uploading an effect equal to a cached
+ * one returns its handle. */
+
+struct cachedEffect {
+	struct ff_effect effect; // id is the device's, or -1 if not uploaded
+	struct ff_effect spec; // id always -1, for comparison
+	uint64_t used;
+	int live; // 0 once erased; the handle can be reused
+};
+
+struct effectCache {
+	int slots, resident;
+	struct cachedEffect *entries;
+	size_t count, cap;
+	uint64_t tick;
+	unsigned long uploads, evictions, plays;
+};
+
+static struct effectCache *effectCache_get(lua_State *L, struct inputDevice *dev) {
+	if(dev->effects == NULL) {
+		int slots = 0;
+		if(ioctl(dev->fd, EVIOCGEFFECTS, &slots) < 0 || slots <= 0) {
+			luaL_error(L, "Device doesn't support force feedback.");
+		}
+		dev->effects = calloc(1, sizeof(struct effectCache));
+		if(dev->effects == NULL) {
+			luaL_error(L, "Out of memory allocating effect cache.");
+		}
+		dev->effects->slots = slots;
+	}
+	return dev->effects;
+}
+
+static void effectCache_free(struct effectCache *cache) {
+	if(cache != NULL) {
+		free(cache->entries);
+		free(cache);
+	}
+}
+
+static int effectCache_evict(struct inputDevice *dev, struct effectCache *cache) {
+	struct cachedEffect *victim = NULL;
+	size_t i;
+
+	for(i = 0; i < cache->count; i++) {
+		struct cachedEffect *entry = &cache->entries[i];
+		if(entry->live && entry->effect.id != -1 && (victim == NULL || entry->used < victim->used)) {
+			victim = entry;
+		}
+	}
+	if(victim == NULL) {
+		return -1;
+	}
+
+	ioctl(dev->fd, EVIOCRMFF, victim->effect.id);
+	victim->effect.id = -1;
+	cache->resident--;
+	cache->evictions++;
+
+	return 0;
+}
+
+/* make sure an entry is on the device, evicting as needed */
+static int effectCache_load(struct inputDevice *dev, struct effectCache *cache, struct cachedEffect *entry) {
+	entry->used = ++cache->tick;
+
+	if(entry->effect.id != -1) {
+		return 0;
+	}
+
+	for(;;) {
+		if(cache->resident >= cache->slots && effectCache_evict(dev, cache) < 0) {
+			errno = ENOSPC;
+			return -1;
+		}
+		if(ioctl(dev->fd, EVIOCSFF, &entry->effect) == 0) {
+			break;
+		}
+		/* slots can also be taken by other clients */
+		entry->effect.id = -1;
+		if(errno != ENOSPC || effectCache_evict(dev, cache) < 0) {
+			return -1;
+		}
+	}
+
+	cache->resident++;
+	cache->uploads++;
+
+	return 0;
+}
+
+static struct cachedEffect *effectCache_check(lua_State *L, struct inputDevice *dev, int index) {
+	lua_Integer handle = luaL_checkinteger(L, index);
+
+	if(dev->effects == NULL || handle < 1 || (size_t) handle > dev->effects->count
+		|| !dev->effects->entries[handle - 1].live) {
+		luaL_argerror(L, index, "no such effect");
+	}
+
+	return &dev->effects->entries[handle - 1];
+}
+
+/* uploadEffect(spec) - returns a handle for playEffect() */
+static int evdev_uploadEffect(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	struct ff_effect spec;
+	size_t i, slot;
+
+	effect_check(L, 2, &spec);
+	struct effectCache *cache = effectCache_get(L, dev);
+
+	/* already cached? */
+	slot = cache->count;
+	for(i = 0; i < cache->count; i++) {
+		struct cachedEffect *entry = &cache->entries[i];
+		if(entry->live && memcmp(&entry->spec, &spec, sizeof(spec)) == 0) {
+			break;
+		} else if(!entry->live && slot == cache->count) {
+			slot = i;
+		}
+	}
+
+	int created = i == cache->count;
+	if(created) {
+		if(slot == cache->count) {
+			if(cache->count == cache->cap) {
+				size_t cap = cache->cap ? cache->cap * 2 : 16;
+				struct cachedEffect *entries = realloc(cache->entries, cap * sizeof(struct cachedEffect));
+				if(entries == NULL) {
+					return luaL_error(L, "Out of memory allocating effect cache.");
+				}
+				cache->entries = entries;
+				cache->cap = cap;
+			}
+			cache->count++;
+		}
+		i = slot;
+		cache->entries[i].effect = spec;
+		cache->entries[i].spec = spec;
+		cache->entries[i].live = 1;
+	}
+
+	if(effectCache_load(dev, cache, &cache->entries[i]) < 0) {
+		/* a cached handle stays valid; it may load next time */
+		if(created) {
+			cache->entries[i].live = 0;
+		}
+		return luaL_error(L, "Couldn't upload effect: %s", strerror(errno));
+	}
+
+	lua_pushinteger(L, i + 1);
+	return 1;
+}
+
+static int effect_write(struct inputDevice *dev, int id, int value) {
+	struct input_event evt;
+	memset(&evt, 0, sizeof(evt));
+	evt.type = EV_FF;
+	evt.code = id;
+	evt.value = value;
+
+	ssize_t written = write(dev->fd, &evt, sizeof(evt));
+	io_countWrite(&dev->stats, &evt, written);
+	return written == sizeof(evt) ? 0 : -1;
+}
+
+/* playEffect(handle[, count]) - play an effect `count` times (default 1),
+ * uploading it again first if it was evicted */
+static int evdev_playEffect(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	struct cachedEffect *entry = effectCache_check(L, dev, 2);
+	lua_Integer count = luaL_optinteger(L, 3, 1);
+
+	if(effectCache_load(dev, dev->effects, entry) < 0
+		|| effect_write(dev, entry->effect.id, count) < 0) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(errno));
+		return 2;
+	}
+	dev->effects->plays++;
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+/* stopEffect(handle) */
+static int evdev_stopEffect(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	struct cachedEffect *entry = effectCache_check(L, dev, 2);
+
+	if(entry->effect.id != -1 && effect_write(dev, entry->effect.id, 0) < 0) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(errno));
+		return 2;
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+/* eraseEffect(handle) - remove an effect from the device and the cache */
+static int evdev_eraseEffect(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	struct cachedEffect *entry = effectCache_check(L, dev, 2);
+
+	if(entry->effect.id != -1) {
+		ioctl(dev->fd, EVIOCRMFF, entry->effect.id);
+		entry->effect.id = -1;
+		dev->effects->resident--;
+	}
+	entry->live = 0;
+
+	return 0;
+}
+
+/* effects() - a table of the cache's counters */
+static int evdev_effects(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	struct effectCache *cache = effectCache_get(L, dev);
+	size_t i, cached = 0;
+
+	for(i = 0; i < cache->count; i++) {
+		cached += cache->entries[i].live;
+	}
+
+	lua_newtable(L);
+	lua_pushinteger(L, cache->slots);
+	lua_setfield(L, -2, "slots");
+	lua_pushinteger(L, cache->resident);
+	lua_setfield(L, -2, "resident");
+	lua_pushinteger(L, cached);
+	lua_setfield(L, -2, "cached");
+	lua_pushinteger(L, cache->uploads);
+	lua_setfield(L, -2, "uploads");
+	lua_pushinteger(L, cache->evictions);
+	lua_setfield(L, -2, "evictions");
+	lua_pushinteger(L, cache->plays);
+	lua_setfield(L, -2, "plays");
+
+	return 1;
+}
+
+static int evdev_close(lua_State *L) {
+	struct inputDevice *dev = luaL_checkudata(L, 1, EVDEV_USERDATA);
+	
+	if(dev->fd != -1) {
+		close(dev->fd);
+		dev->fd = -1;
+	}
+
+	free(dev->filters);
+	dev->filters = NULL;
+	dev->hotkeys = NULL;
+	free(dev->gestures);
+	dev->gestures = NULL;
+	debounce_free(&dev->debounce);
+	free(dev->limit);
+	dev->limit = NULL;
+	flight_free(dev->flight);
+	dev->flight = NULL;
+	io_unregister(&dev->stats);
+	free(dev->batch);
+	free(dev->batchRaw);
+	dev->batch = dev->batchRaw = NULL;
+	dev->batchCap = dev->batchCount = 0;
+	/* the kernel drops a client's effects when it closes */
+	effectCache_free(dev->effects);
+	dev->effects = NULL;
+
+	return 0;
+}
+
+static int evdev_pollfd(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+
+	lua_pushinteger(L, dev->fd);
+
+	return 1;
+}
+
+/* Uinput wrappers */
+
+#define UINPUT_USERDATA "us.tropi.evdev.struct.userdev"
+struct scheduledFrame {
+	uint64_t deadline; // CLOCK_MONOTONIC, in nanoseconds
+	size_t count;
+	struct input_event *events;
+};
+
+struct userdev {
+       int fd; // file descriptor
+       int init; // 0 if not initialized, 1 if initialized
+       struct uinput_user_dev dev;
+       int timerfd; // -1 until frames are scheduled
+       struct scheduledFrame *frames; // pending frames, sorted by deadline
+       size_t frameHead, frameCount, frameCap;
+       int epfd; // -1 until pollfd() is asked for
+       struct input_event *queue; // events the kernel hasn't accepted yet
+       size_t queueHead, queueCount, queueLimit;
+       unsigned long dropped; // events discarded because the queue was full
+       struct axisFilter *filters; // per ABS axis; NULL until configured
+       struct keyState keys; // pressed as far as the kernel has seen
+       struct ioStats stats;
+       int readable; // opened read-write, for read()
+       struct inputDevice *relay; // feedback mirrored here; NULL if none
+       int *effects; // virtual effect id -> relay's; NULL until relaying
+};
+
+#define UINPUT_DEFAULT_QUEUE_LIMIT 1024
+
+#define CHECK_UINPUT(dev, index, isInit) \
+struct userdev *dev = luaL_checkudata(L, index, UINPUT_USERDATA); \
+if(dev->fd == -1) { \
+	return luaL_error(L, "Trying to use closed uinput device node."); \
+} \
+if(isInit == 1) { \
+	if(dev->init == 0 ) \
+		return luaL_error(L, "Trying to use uninitialized uinput device node."); \
+} else if(isInit == 0) { \
+	if(dev->init == 1) \
+		return luaL_error(L, "Trying to configure initialized uinput device node."); \
+} else if(isInit == 2) { \
+	/* Don't care about initialization state */ \
+} else { \
+	/* Should never happen */ \
+	return luaL_error(L, "Logic error in CHECK_UINPUT"); \
+}
+
+
+static int uinput_open(lua_State *L) {
+	const char *path = luaL_optstring(L, 1, "/dev/uinput");
+	int readMode = lua_toboolean(L, 2);
+	
+	/* create userdata */
+	struct userdev *dev = lua_newuserdata(L, sizeof(struct userdev));
+	memset(dev, 0, sizeof(struct userdev));
+	dev->fd = -1;
+	dev->timerfd = -1;
+	dev->epfd = -1;
+	dev->queueLimit = UINPUT_DEFAULT_QUEUE_LIMIT;
+
+	luaL_setmetatable(L, UINPUT_USERDATA);
+
+	/* holds objects attached to the device */
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+	
+	/* read-write mode gets LED, force-feedback and uinput requests back */
+	dev->readable = readMode;
+	dev->fd = open(path, (readMode ? O_RDWR : O_WRONLY) | O_NONBLOCK | O_CLOEXEC);
+	if(dev->fd < 0) {
+		return luaL_error(L, "Couldn't open uinput device node.");
+	}
+	io_register(&dev->stats, "uinput", path);
+	
+	/* init dummy device description */
+	dev->dev.id.bustype = BUS_VIRTUAL;
+	
+	return 1;
+}
+
+#define BIT_TYPES(action, axisAction) \
+action(useEvent, UI_SET_EVBIT) \
+action(useKey, UI_SET_KEYBIT) \
+action(useLED, UI_SET_LEDBIT) \
+axisAction(useRelAxis, UI_SET_RELBIT) \
+axisAction(useAbsAxis, UI_SET_ABSBIT)
+
+
+#define DECLARE_BIT_SETTER(name, type) \
+static int uinput_ ## name (lua_State *L) { \
+	CHECK_UINPUT(dev, 1, 0) \
+	int bit = luaL_checkinteger(L, 2); \
+	ioctl(dev->fd, type, bit); \
+	return 0; \
+}
+
+#define DECLARE_AXIS_BIT_SETTER(name, type) \
+static int uinput_ ## name (lua_State *L) { \
+	CHECK_UINPUT(dev, 1, 0) \
+	int bit = luaL_checkinteger(L, 2); \
+	int minVal = luaL_checkinteger(L, 3); \
+	int maxVal = luaL_checkinteger(L, 4); \
+	ioctl(dev->fd, type, bit); \
+	dev->dev.absmin[bit] = minVal; \
+	dev->dev.absmax[bit] = maxVal; \
+	return 0; \
+}
+
+BIT_TYPES(DECLARE_BIT_SETTER, DECLARE_AXIS_BIT_SETTER)
+
+static int uinput_init(lua_State *L) {
+	
+	CHECK_UINPUT(dev, 1, 0)
+	
+	/* Give device human-friendly description */
+	const char *name = luaL_optstring(L, 2, "Lua-Powered Virtual Input Device");
+	strncpy(dev->dev.name, name, UINPUT_MAX_NAME_SIZE);
+	strncpy(dev->stats.name, name, UINPUT_MAX_NAME_SIZE - 1);
+	
+	// register device
+	if(write(dev->fd, &dev->dev, sizeof(struct uinput_user_dev)) != sizeof(struct uinput_user_dev)) {
+		return luaL_error(L, "Couldn't register uinput device description.");
+	}
+	
+	if(ioctl(dev->fd, UI_DEV_CREATE)) {
+		return luaL_error(L, "Couldn't create uinput device node.");
+	}
+	
+	dev->init = 1;
+	
+	return 0;
+}
+
+/* Write queue
+ * 
+ * The uinput node is non-blocking, so a write may be refused (EAGAIN)
+ * or only partly accepted. Rather than lose events, and with them key
+ * releases, the remainder waits in a bounded per-device queue that is
+ * retried before anything newer is written. */
+
+/* keep EPOLLOUT interest only while there is something to retry */
+static void uinput_watchWrites(struct userdev *dev) {
+	if(dev->epfd != -1) {
+		struct epoll_event watch;
+		memset(&watch, 0, sizeof(watch));
+		watch.events = (dev->queueCount > dev->queueHead ? EPOLLOUT : 0) | (dev->readable ? EPOLLIN : 0);
+		watch.data.fd = dev->fd;
+		epoll_ctl(dev->epfd, EPOLL_CTL_MOD, dev->fd, &watch);
+	}
+}
+
+/* write as much of evts as the kernel accepts; returns the number of
+ * events written, or -1 on a real error */
+static ssize_t uinput_writeSome(struct userdev *dev, const struct input_event *evts, size_t count) {
+	ssize_t written;
+
+	do {
+		written = write(dev->fd, evts, count * sizeof(struct input_event));
+		io_countWrite(&dev->stats, evts, written);
+	} while(written < 0 && errno == EINTR);
+
+	if(written < 0) {
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+	}
+
+	size_t i, done = written / sizeof(struct input_event);
+	for(i = 0; i < done; i++) {
+		if(evts[i].type == EV_KEY) {
+			keys_update(&dev->keys, evts[i].code, evts[i].value);
+		}
+	}
+
+	return done;
+}
+
+/* retry queued events; returns -1 on a real error */
+static int uinput_flushQueue(struct userdev *dev) {
+	size_t waiting = dev->queueCount - dev->queueHead;
+
+	if(waiting == 0) {
+		return 0;
+	}
+
+	ssize_t written = uinput_writeSome(dev, dev->queue + dev->queueHead, waiting);
+	if(written < 0) {
+		return -1;
+	}
+
+	dev->queueHead += written;
+	if(dev->queueHead == dev->queueCount) {
+		dev->queueHead = dev->queueCount = 0;
+		uinput_watchWrites(dev);
+	}
+
+	return 0;
+}
+
+/* run EV_ABS events through any axis filters, compacting in place */
+static size_t uinput_filter(struct userdev *dev, struct input_event *evts, size_t count) {
+	double now = monotonic_ns() / 1e9;
+	size_t in, out = 0;
+
+	for(in = 0; in < count; in++) {
+		struct input_event *evt = &evts[in];
+		if(evt->type == EV_ABS && evt->code < ABS_CNT && dev->filters[evt->code].enabled) {
+			double time = evt->time.tv_sec ? evdev_timestamp(evt) : now;
+			if(!filter_apply(&dev->filters[evt->code], &evt->value, time)) {
+				continue;
+			}
+		}
+		evts[out++] = *evt;
+	}
+
+	return out;
+}
+
+/* write a batch of events in order behind anything already queued;
+ * returns the number of events dropped for lack of queue space,
+ * or -1 on a real error */
+static ssize_t uinput_emit(struct userdev *dev, struct input_event *evts, size_t count) {
+	size_t waiting;
+	int wasEmpty;
+
+	if(dev->filters != NULL) {
+		count = uinput_filter(dev, evts, count);
+	}
+
+	if(uinput_flushQueue(dev) < 0) {
+		return -1;
+	}
+
+	waiting = dev->queueCount - dev->queueHead;
+	wasEmpty = waiting == 0;
+
+	if(count == 0) {
+		return 0;
+	}
+
+	/* a partial frame is worse than none, so make sure whatever the
+	 * kernel refuses can be queued before writing any of it */
+	if(dev->queue == NULL) {
+		dev->queue = malloc(dev->queueLimit * sizeof(struct input_event));
+	}
+	if(waiting + count > dev->queueLimit || dev->queue == NULL) {
+		dev->dropped += count;
+		return count;
+	}
+
+	if(wasEmpty) {
+		ssize_t written = uinput_writeSome(dev, evts, count);
+		if(written < 0) {
+			return -1;
+		}
+		evts += written;
+		count -= written;
+	}
+
+	if(count == 0) {
+		return 0;
+	}
+
+	if(dev->queueCount + count > dev->queueLimit) {
+		memmove(dev->queue, dev->queue + dev->queueHead, waiting * sizeof(struct input_event));
+		dev->queueHead = 0;
+		dev->queueCount = waiting;
+	}
+
+	memcpy(dev->queue + dev->queueCount, evts, count * sizeof(struct input_event));
+	dev->queueCount += count;
+
+	if(wasEmpty) {
+		uinput_watchWrites(dev);
+	}
+
+	return 0;
+}
+
+static int uinput_write(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 1)
+	
+	struct input_event evt;
+	memset(&evt, 0, sizeof(struct input_event));
+	
+	evt.type = luaL_checkinteger(L, 2);
+	evt.code = luaL_checkinteger(L, 3);
+	evt.value = luaL_checkinteger(L, 4);
+	
+	ssize_t dropped = uinput_emit(dev, &evt, 1);
+	if(dropped < 0) {
+		return luaL_error(L, "Failure writing input event: %s", strerror(errno));
+	}
+	
+	/* true if written or queued, false if the queue was full */
+	lua_pushboolean(L, dropped == 0);
+	return 1;
+}
+
+static int uinput_flush(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 1)
+
+	if(uinput_flushQueue(dev) < 0) {
+		return luaL_error(L, "Failure writing input event: %s", strerror(errno));
+	}
+
+	lua_pushinteger(L, dev->queueCount - dev->queueHead);
+	return 1;
+}
+
+static int uinput_queued(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+
+	lua_pushinteger(L, dev->queueCount - dev->queueHead);
+	lua_pushinteger(L, dev->dropped);
+	return 2;
+}
+
+static int uinput_stats(lua_State *L) {
+	struct userdev *dev = luaL_checkudata(L, 1, UINPUT_USERDATA);
+
+	lua_newtable(L);
+	io_pushStats(L, &dev->stats);
+	lua_pushinteger(L, dev->dropped);
+	lua_setfield(L, -2, "dropped");
+	lua_pushinteger(L, dev->queueCount - dev->queueHead);
+	lua_setfield(L, -2, "queued");
+
+	return 1;
+}
+
+static int uinput_setQueueLimit(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+	lua_Integer limit = luaL_checkinteger(L, 2);
+	size_t waiting = dev->queueCount - dev->queueHead;
+
+	luaL_argcheck(L, limit > 0, 2, "queue limit must be positive");
+	if((size_t) limit < waiting) {
+		return luaL_error(L, "Can't shrink the queue below the events already waiting.");
+	}
+
+	struct input_event *queue = malloc(limit * sizeof(struct input_event));
+	if(queue == NULL) {
+		return luaL_error(L, "Out of memory resizing write queue.");
+	}
+	if(dev->queue != NULL) {
+		memcpy(queue, dev->queue + dev->queueHead, waiting * sizeof(struct input_event));
+		free(dev->queue);
+	}
+	dev->queue = queue;
+	dev->queueHead = 0;
+	dev->queueCount = waiting;
+	dev->queueLimit = limit;
+
+	return 0;
+}
+
+/* Scheduled injection
+ * 
+ * Frames are queued in C with an absolute CLOCK_MONOTONIC deadline,
+ * and a timerfd armed for the earliest one lets an event loop sleep
+ * until something is due. */
+
+static int uinput_armTimer(struct userdev *dev) {
+	struct itimerspec spec;
+	memset(&spec, 0, sizeof(spec));
+
+	if(dev->frameHead < dev->frameCount) {
+		uint64_t deadline = dev->frames[dev->frameHead].deadline;
+		/* a zero it_value disarms, so never ask for time zero */
+		if(deadline == 0) {
+			deadline = 1;
+		}
+		spec.it_value.tv_sec = deadline / 1000000000u;
+		spec.it_value.tv_nsec = deadline % 1000000000u;
+	}
+
+	return timerfd_settime(dev->timerfd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+static int uinput_openTimer(lua_State *L, struct userdev *dev) {
+	if(dev->timerfd == -1) {
+		dev->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		if(dev->timerfd < 0) {
+			dev->timerfd = -1;
+			return luaL_error(L, "Couldn't create scheduling timer.");
+		}
+	}
+	return 0;
+}
+
+static void uinput_freeFrames(struct userdev *dev) {
+	size_t i;
+	for(i = dev->frameHead; i < dev->frameCount; i++) {
+		free(dev->frames[i].events);
+	}
+	free(dev->frames);
+	dev->frames = NULL;
+	dev->frameHead = dev->frameCount = dev->frameCap = 0;
+}
+
+/* make room for `more` frames, so queueing them can't fail */
+static int uinput_reserveFrames(struct userdev *dev, size_t more) {
+	size_t live = dev->frameCount - dev->frameHead;
+
+	if(dev->frameHead > 0) {
+		memmove(dev->frames, dev->frames + dev->frameHead, live * sizeof(struct scheduledFrame));
+		dev->frameCount = live;
+		dev->frameHead = 0;
+	}
+
+	if(live + more > dev->frameCap) {
+		size_t cap = dev->frameCap ? dev->frameCap : 16;
+		while(cap < live + more) {
+			cap *= 2;
+		}
+		struct scheduledFrame *frames = realloc(dev->frames, cap * sizeof(struct scheduledFrame));
+		if(frames == NULL) {
+			return -1;
+		}
+		dev->frames = frames;
+		dev->frameCap = cap;
+	}
+
+	return 0;
+}
+
+/* insert keeping deadline order; in-order appends are O(1) */
+static int uinput_queueFrame(struct userdev *dev, struct scheduledFrame *frame) {
+	size_t pos;
+
+	if(dev->frameHead > 0 && dev->frameHead == dev->frameCount) {
+		dev->frameHead = dev->frameCount = 0;
+	}
+
+	if(dev->frameCount == dev->frameCap) {
+		if(dev->frameHead > 0) {
+			/* reclaim slots of already-sent frames */
+			memmove(dev->frames, dev->frames + dev->frameHead,
+				(dev->frameCount - dev->frameHead) * sizeof(struct scheduledFrame));
+			dev->frameCount -= dev->frameHead;
+			dev->frameHead = 0;
+		} else {
+			size_t cap = dev->frameCap ? dev->frameCap * 2 : 16;
+			struct scheduledFrame *frames = realloc(dev->frames, cap * sizeof(struct scheduledFrame));
+			if(frames == NULL) {
+				return -1;
+			}
+			dev->frames = frames;
+			dev->frameCap = cap;
+		}
+	}
+
+	pos = dev->frameCount;
+	while(pos > dev->frameHead && dev->frames[pos - 1].deadline > frame->deadline) {
+		pos--;
+	}
+	memmove(dev->frames + pos + 1, dev->frames + pos,
+		(dev->frameCount - pos) * sizeof(struct scheduledFrame));
+	dev->frames[pos] = *frame;
+	dev->frameCount++;
+
+	return 0;
+}
+
+/* read one {type, code, value} entry from the table on top of the stack */
+static void uinput_checkEvent(lua_State *L, struct input_event *evt) {
+	if(!lua_istable(L, -1)) {
+		luaL_error(L, "Scheduled events must be {type, code, value} tables.");
+	}
+	int typeOk, codeOk, valueOk;
+	lua_rawgeti(L, -1, 1);
+	lua_rawgeti(L, -2, 2);
+	lua_rawgeti(L, -3, 3);
+	memset(evt, 0, sizeof(struct input_event));
+	evt->type = lua_tointegerx(L, -3, &typeOk);
+	evt->code = lua_tointegerx(L, -2, &codeOk);
+	evt->value = lua_tointegerx(L, -1, &valueOk);
+	lua_pop(L, 3);
+	if(!typeOk || !codeOk || !valueOk) {
+		luaL_error(L, "Scheduled events must be {type, code, value} tables.");
+	}
+}
+
+static int uinput_schedule(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 1)
+	luaL_checktype(L, 2, LUA_TTABLE);
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	size_t frameCount = lua_rawlen(L, 2);
+	if(lua_rawlen(L, 3) != frameCount) {
+		return luaL_error(L, "Need exactly one timestamp per scheduled frame.");
+	}
+
+	/* check everything first, so an error neither leaks a frame nor
+	 * leaves the earlier ones of this call queued */
+	size_t i, j;
+	for(i = 1; i <= frameCount; i++) {
+		struct input_event evt;
+
+		lua_rawgeti(L, 3, i);
+		if(!lua_isnumber(L, -1)) {
+			return luaL_error(L, "Scheduled timestamps must be numbers.");
+		}
+		lua_pop(L, 1);
+
+		lua_rawgeti(L, 2, i);
+		if(!lua_istable(L, -1)) {
+			return luaL_error(L, "Scheduled frames must be tables of events.");
+		}
+		size_t eventCount = lua_rawlen(L, -1);
+		for(j = 1; j <= eventCount; j++) {
+			lua_rawgeti(L, -1, j);
+			uinput_checkEvent(L, &evt);
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+	}
+
+	uinput_openTimer(L, dev);
+
+	/* likewise allocate everything before queueing anything, so running
+	 * out of memory leaves the schedule as it was */
+	struct scheduledFrame *frames = calloc(frameCount ? frameCount : 1, sizeof(struct scheduledFrame));
+	if(frames == NULL || uinput_reserveFrames(dev, frameCount) < 0) {
+		free(frames);
+		return luaL_error(L, "Out of memory scheduling frames.");
+	}
+	for(i = 0; i < frameCount; i++) {
+		lua_rawgeti(L, 2, i + 1);
+		/* leave room for a terminating SYN_REPORT */
+		frames[i].events = calloc(lua_rawlen(L, -1) + 1, sizeof(struct input_event));
+		lua_pop(L, 1);
+		if(frames[i].events == NULL) {
+			while(i > 0) {
+				free(frames[--i].events);
+			}
+			free(frames);
+			return luaL_error(L, "Out of memory scheduling frames.");
+		}
+	}
+
+	for(i = 0; i < frameCount; i++) {
+		struct scheduledFrame *frame = &frames[i];
+
+		lua_rawgeti(L, 3, i + 1);
+		frame->deadline = seconds_to_ns(lua_tonumber(L, -1));
+		lua_pop(L, 1);
+
+		lua_rawgeti(L, 2, i + 1);
+		size_t eventCount = lua_rawlen(L, -1);
+		frame->count = 0;
+
+		for(j = 1; j <= eventCount; j++) {
+			lua_rawgeti(L, -1, j);
+			uinput_checkEvent(L, &frame->events[frame->count++]);
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+
+		if(frame->count == 0
+			|| frame->events[frame->count - 1].type != EV_SYN
+			|| frame->events[frame->count - 1].code != SYN_REPORT) {
+			frame->events[frame->count++].type = EV_SYN;
+		}
+
+		/* room was reserved above, so this can't fail */
+		uinput_queueFrame(dev, frame);
+	}
+	free(frames);
+
+	if(uinput_armTimer(dev) < 0) {
+		return luaL_error(L, "Couldn't arm scheduling timer.");
+	}
+
+	lua_pushinteger(L, dev->frameCount - dev->frameHead);
+	return 1;
+}
+
+static int uinput_dispatch(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 1)
+
+	/* frames due within `slack` seconds are waited for here,
+	 * so a tight burst costs one wakeup rather than one per frame */
+	uint64_t slack = seconds_to_ns(luaL_optnumber(L, 2, 0));
+	int sent = 0;
+
+	if(uinput_flushQueue(dev) < 0) {
+		return luaL_error(L, "Failure writing input event: %s", strerror(errno));
+	}
+
+	if(dev->timerfd != -1) {
+		uint64_t expirations;
+		/* just clearing readability; EAGAIN is fine */
+		if(read(dev->timerfd, &expirations, sizeof(expirations)) < 0) {
+			expirations = 0;
+		}
+	}
+
+	while(dev->frameHead < dev->frameCount) {
+		struct scheduledFrame *frame = &dev->frames[dev->frameHead];
+		uint64_t now = monotonic_ns();
+
+		if(frame->deadline > now) {
+			if(frame->deadline - now > slack) {
+				break;
+			}
+			struct timespec until;
+			until.tv_sec = frame->deadline / 1000000000u;
+			until.tv_nsec = frame->deadline % 1000000000u;
+			while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR)
+				;
+		}
+
+		ssize_t dropped = uinput_emit(dev, frame->events, frame->count);
+
+		free(frame->events);
+		dev->frameHead++;
+
+		if(dropped < 0) {
+			uinput_armTimer(dev);
+			return luaL_error(L, "Failure writing scheduled frame: %s", strerror(errno));
+		}
+		if(dropped == 0) {
+			sent++;
+		}
+	}
+
+	if(dev->timerfd != -1 && uinput_armTimer(dev) < 0) {
+		return luaL_error(L, "Couldn't arm scheduling timer.");
+	}
+
+	lua_pushinteger(L, sent);
+	return 1;
+}
+
+static int uinput_scheduled(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+
+	lua_pushinteger(L, dev->frameCount - dev->frameHead);
+	return 1;
+}
+
+static int uinput_cancel(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+
+	uinput_freeFrames(dev);
+	if(dev->timerfd != -1) {
+		uinput_armTimer(dev);
+	}
+
+	return 0;
+}
+
+/* one epoll fd covering the timer, queued-write retries and, in read
+ * mode, incoming requests; readable whenever dispatch() or read() has
+ * something to do */
+static int uinput_pollfd(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+
+	if(dev->epfd == -1) {
+		uinput_openTimer(L, dev);
+
+		int epfd = epoll_create1(EPOLL_CLOEXEC);
+		if(epfd < 0) {
+			return luaL_error(L, "Couldn't create uinput poll set.");
+		}
+
+		struct epoll_event watch;
+		memset(&watch, 0, sizeof(watch));
+		watch.events = EPOLLIN;
+		watch.data.fd = dev->timerfd;
+		epoll_ctl(epfd, EPOLL_CTL_ADD, dev->timerfd, &watch);
+
+		watch.events = 0;
+		watch.data.fd = dev->fd;
+		epoll_ctl(epfd, EPOLL_CTL_ADD, dev->fd, &watch);
+
+		dev->epfd = epfd;
+		uinput_watchWrites(dev);
+	}
+
+	lua_pushinteger(L, dev->epfd);
+
+	return 1;
+}
+
+static int uinput_filterAxis(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+
+	return filter_configure(L, &dev->filters);
+}
+
+/* Feedback
+ * 
+ * A Uinput opened for reading gets back what clients send its virtual
+ * device: EV_LED and EV_FF events, and EV_UINPUT requests to upload or
+ * erase force-feedback effects. read() answers each request in C as soon
+ * as it's read, and with a relay Device set, mirrors LEDs, effects and
+ * playback onto it; the virtual device's effect ids are mapped to the
+ * ones the relay assigned. The relay is kept in the uservalue table. */
+
+static int uinput_effectSlot(struct userdev *dev, int id) {
+	if(dev->effects == NULL && dev->dev.ff_effects_max > 0) {
+		int i;
+		dev->effects = malloc(dev->dev.ff_effects_max * sizeof(int));
+		if(dev->effects == NULL) {
+			return -1;
+		}
+		for(i = 0; i < (int) dev->dev.ff_effects_max; i++) {
+			dev->effects[i] = -1;
+		}
+	}
+	return dev->effects != NULL && id >= 0 && id < (int) dev->dev.ff_effects_max ? id : -1;
+}
+
+static int uinput_relaying(struct userdev *dev) {
+	return dev->relay != NULL && dev->relay->fd != -1;
+}
+
+/* returns the retval for UI_END_FF_UPLOAD */
+static int uinput_relayUpload(struct userdev *dev, const struct ff_effect *effect) {
+	if(!uinput_relaying(dev)) {
+		return 0;
+	}
+
+	int slot = uinput_effectSlot(dev, effect->id);
+	if(slot < 0) {
+		return -EINVAL;
+	}
+
+	struct ff_effect copy = *effect;
+	copy.id = dev->effects[slot];
+	if(ioctl(dev->relay->fd, EVIOCSFF, &copy) < 0) {
+		return -errno;
+	}
+	dev->effects[slot] = copy.id;
+
+	return 0;
+}
+
+static int uinput_relayErase(struct userdev *dev, int id) {
+	int slot = uinput_effectSlot(dev, id);
+
+	if(!uinput_relaying(dev) || slot < 0 || dev->effects[slot] == -1) {
+		return 0;
+	}
+
+	int result = ioctl(dev->relay->fd, EVIOCRMFF, dev->effects[slot]) < 0 ? -errno : 0;
+	dev->effects[slot] = -1;
+
+	return result;
+}
+
+/* erase everything uploaded to the relay */
+static void uinput_dropEffects(struct userdev *dev) {
+	int i;
+
+	if(dev->effects != NULL) {
+		for(i = 0; i < (int) dev->dev.ff_effects_max; i++) {
+			uinput_relayErase(dev, i);
+		}
+	}
+	free(dev->effects);
+	dev->effects = NULL;
+}
+
+static void uinput_relayEvent(struct userdev *dev, const struct input_event *evt) {
+	struct input_event out[2];
+
+	if(!uinput_relaying(dev)) {
+		return;
+	}
+
+	memset(out, 0, sizeof(out));
+	out[0].type = evt->type;
+	out[0].code = evt->code;
+	out[0].value = evt->value;
+
+	if(evt->type == EV_FF && evt->code < FF_GAIN) {
+		/* playback: address the relay's copy of the effect */
+		int slot = uinput_effectSlot(dev, evt->code);
+		if(slot < 0 || dev->effects[slot] == -1) {
+			return;
+		}
+		out[0].code = dev->effects[slot];
+	}
+
+	/* LED changes take effect on SYN_REPORT */
+	out[1].type = EV_SYN;
+	out[1].code = SYN_REPORT;
+	while(write(dev->relay->fd, out, (evt->type == EV_LED ? 2 : 1) * sizeof(struct input_event)) < 0 && errno == EINTR)
+		;
+}
+
+/* read() - return the next event sent to the virtual device, like
+ * Device:read(), or nothing if none is waiting. Upload and erase requests
+ * come back as EV_UINPUT events, already answered, whose value is the
+ * effect id; an upload is followed by a table describing the effect. */
+static int uinput_read(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 1)
+	struct input_event evt;
+	ssize_t count;
+
+	if(!dev->readable) {
+		return luaL_error(L, "Uinput wasn't opened for reading.");
+	}
+
+	do {
+		count = read(dev->fd, &evt, sizeof(evt));
+	} while(count < 0 && errno == EINTR);
+
+	if(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return 0;
+	} else if(count != sizeof(evt)) {
+		return luaL_error(L, "Failure reading uinput request.");
+	}
+
+	lua_pushnumber(L, evdev_timestamp(&evt));
+	lua_pushinteger(L, evt.type);
+	lua_pushinteger(L, evt.code);
+
+	if(evt.type == EV_UINPUT && evt.code == UI_FF_UPLOAD) {
+		struct uinput_ff_upload upload;
+		memset(&upload, 0, sizeof(upload));
+		upload.request_id = evt.value;
+		if(ioctl(dev->fd, UI_BEGIN_FF_UPLOAD, &upload) < 0) {
+			return luaL_error(L, "Couldn't begin effect upload: %s", strerror(errno));
+		}
+		upload.retval = uinput_relayUpload(dev, &upload.effect);
+		if(ioctl(dev->fd, UI_END_FF_UPLOAD, &upload) < 0) {
+			return luaL_error(L, "Couldn't end effect upload: %s", strerror(errno));
+		}
+		lua_pushinteger(L, upload.effect.id);
+		effect_push(L, &upload.effect);
+		return 5;
+	} else if(evt.type == EV_UINPUT && evt.code == UI_FF_ERASE) {
+		struct uinput_ff_erase erase;
+		memset(&erase, 0, sizeof(erase));
+		erase.request_id = evt.value;
+		if(ioctl(dev->fd, UI_BEGIN_FF_ERASE, &erase) < 0) {
+			return luaL_error(L, "Couldn't begin effect erase: %s", strerror(errno));
+		}
+		erase.retval = uinput_relayErase(dev, erase.effect_id);
+		if(ioctl(dev->fd, UI_END_FF_ERASE, &erase) < 0) {
+			return luaL_error(L, "Couldn't end effect erase: %s", strerror(errno));
+		}
+		lua_pushinteger(L, erase.effect_id);
+		return 4;
+	} else if(evt.type == EV_LED || evt.type == EV_FF) {
+		uinput_relayEvent(dev, &evt);
+	}
+
+	lua_pushinteger(L, evt.value);
+	return 4;
+}
+
+/* relay([device]) - mirror LEDs and force feedback onto a Device opened
+ * for writing; nil stops, erasing the effects uploaded to it */
+static int uinput_relay(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 2)
+	struct inputDevice *relay = NULL;
+
+	if(!lua_isnoneornil(L, 2)) {
+		CHECK_EVDEV(target, 2)
+		relay = target;
+	}
+
+	uinput_dropEffects(dev);
+	dev->relay = relay;
+
+	lua_settop(L, 2);
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_setfield(L, -2, "relay");
+
+	return 0;
+}
+
+/* return a device to a clean state: nothing scheduled or queued, no
+ * filters or relay, and every key the kernel has seen pressed released;
+ * the Uinput is at stack index `index` */
+static int uinput_clear(lua_State *L, struct userdev *dev, int index) {
+	struct input_event evt;
+	int code;
+
+	/* stop relaying, and forget the relay and anything else attached */
+	uinput_dropEffects(dev);
+	dev->relay = NULL;
+	lua_newtable(L);
+	lua_setuservalue(L, index);
+
+	uinput_freeFrames(dev);
+	if(dev->timerfd != -1) {
+		uinput_armTimer(dev);
+	}
+	if(uinput_flushQueue(dev) < 0) {
+		return -1;
+	}
+	dev->queueHead = dev->queueCount = 0;
+	uinput_watchWrites(dev);
+	free(dev->filters);
+	dev->filters = NULL;
+
+	if(dev->keys.count == 0) {
+		return 0;
+	}
+
+	memset(&evt, 0, sizeof(evt));
+	evt.type = EV_KEY;
+	for(code = 0; code < KEY_CNT; code++) {
+		if(bit_test(dev->keys.pressed, code)) {
+			evt.code = code;
+			if(uinput_emit(dev, &evt, 1) < 0) {
+				return -1;
+			}
+		}
+	}
+	evt.type = EV_SYN;
+	evt.code = SYN_REPORT;
+	return uinput_emit(dev, &evt, 1) < 0 ? -1 : 0;
+}
+
+static int uinput_reset(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 1)
+
+	if(uinput_clear(L, dev, 1) < 0) {
+		return luaL_error(L, "Failure writing input event: %s", strerror(errno));
+	}
+
+	return 0;
+}
+
+/* useFF(code[, maxEffects]) - declare a force-feedback capability such
+ * as FF_RUMBLE, and how many effects may be uploaded at once (default 16) */
+static int uinput_useFF(lua_State *L) {
+	CHECK_UINPUT(dev, 1, 0)
+	int bit = luaL_checkinteger(L, 2);
+	lua_Integer maxEffects = luaL_optinteger(L, 3, dev->dev.ff_effects_max > 0 ? dev->dev.ff_effects_max : 16);
+
+	luaL_argcheck(L, maxEffects >= 1 && maxEffects <= 1024, 3, "maxEffects out of range");
+
+	ioctl(dev->fd, UI_SET_EVBIT, EV_FF);
+	ioctl(dev->fd, UI_SET_FFBIT, bit);
+	dev->dev.ff_effects_max = maxEffects;
+
+	return 0;
+}
+
+/* free everything; `destroy` is 0 when the fd lives on in another process */
+static void uinput_release(struct userdev *dev, int destroy) {
+	uinput_dropEffects(dev);
+	dev->relay = NULL;
+
+	/* uinput device destroys on close anyways, but being explicit: */
+	if(destroy) {
+		ioctl(dev->fd, UI_DEV_DESTROY);
+	}
+	close(dev->fd);
+
+	if(dev->timerfd != -1) {
+		close(dev->timerfd);
+		dev->timerfd = -1;
+	}
+	if(dev->epfd != -1) {
+		close(dev->epfd);
+		dev->epfd = -1;
+	}
+	uinput_freeFrames(dev);
+	free(dev->queue);
+	dev->queue = NULL;
+	dev->queueHead = dev->queueCount = 0;
+	free(dev->filters);
+	dev->filters = NULL;
+	io_unregister(&dev->stats);
+	
+	/* mark resource released */
+	dev->fd = -1;
+}
+
+static int uinput_close(lua_State *L) {
+
+	struct userdev *dev = luaL_checkudata(L, 1, UINPUT_USERDATA);
+	
+	/* explicit double-closes are poor practice,
+	 * but don't make them errors because we always close on __gc  */
+	if(dev->fd == -1) {
+		return 0;
+	}
+
+	uinput_release(dev, 1);
+	
+	return 0;
+}
+
+/* Trackpad conversion
+ * 
+ * Turns an absolute pointing device (a tablet) into a relative one:
+ * while the touch key is held, per-frame ABS_X/ABS_Y motion is scaled
+ * by an acceleration curve and written to a Uinput as one REL frame. */
+
+#define TRACKPAD_USERDATA "us.tropi.evdev.struct.trackpad"
+#define TRACKPAD_MAX_BUTTONS 16
+struct trackpad {
+	struct inputDevice *input;
+	struct userdev *output;
+
+	int touchKey, absX, absY, relX, relY;
+	double scale;
+	double *curve; // gain at each multiple of curveStep units/second
+	size_t curveLength;
+	double curveStep;
+	int buttonFrom[TRACKPAD_MAX_BUTTONS], buttonTo[TRACKPAD_MAX_BUTTONS];
+	int buttonCount;
+
+	/* state */
+	int touching, moving; // moving: touch held since the previous frame
+	int x, y, lastX, lastY;
+	double lastTime, remainderX, remainderY;
+	struct input_event frame[TRACKPAD_MAX_BUTTONS + 3];
+	int frameLength;
+};
+
+#define CHECK_TRACKPAD(pad, index) \
+struct trackpad *pad = luaL_checkudata(L, index, TRACKPAD_USERDATA); \
+if(pad->input->fd == -1) { \
+	return luaL_error(L, "Trying to use closed device event node."); \
+} \
+if(pad->output->fd == -1) { \
+	return luaL_error(L, "Trying to use closed uinput device node."); \
+}
+
+static int trackpad_option(lua_State *L, const char *key, int def) {
+	return (int) option_number(L, 3, key, def);
+}
+
+static int trackpad_open(lua_State *L) {
+	luaL_checkudata(L, 1, EVDEV_USERDATA);
+	CHECK_UINPUT(output, 2, 1)
+	if(!lua_isnoneornil(L, 3)) {
+		luaL_checktype(L, 3, LUA_TTABLE);
+	} else {
+		lua_settop(L, 2);
+		lua_newtable(L);
+	}
+
+	struct trackpad *pad = lua_newuserdata(L, sizeof(struct trackpad));
+	memset(pad, 0, sizeof(struct trackpad));
+	luaL_setmetatable(L, TRACKPAD_USERDATA);
+
+	pad->input = lua_touserdata(L, 1);
+	pad->output = output;
+
+	/* keep the device and uinput alive as long as the converter is */
+	lua_createtable(L, 2, 0);
+	lua_pushvalue(L, 1);
+	lua_rawseti(L, -2, 1);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, 2);
+	lua_setuservalue(L, -2);
+
+	pad->touchKey = trackpad_option(L, "touch", BTN_TOUCH);
+	pad->absX = trackpad_option(L, "x", ABS_X);
+	pad->absY = trackpad_option(L, "y", ABS_Y);
+	pad->relX = trackpad_option(L, "relX", REL_X);
+	pad->relY = trackpad_option(L, "relY", REL_Y);
+	pad->scale = option_number(L, 3, "scale", 1);
+	pad->curveStep = option_number(L, 3, "curveStep", 100);
+
+	if(pad->curveStep <= 0) {
+		return luaL_error(L, "curveStep must be positive.");
+	}
+
+	lua_getfield(L, 3, "curve");
+	if(!lua_isnil(L, -1)) {
+		luaL_checktype(L, -1, LUA_TTABLE);
+		size_t length = lua_rawlen(L, -1);
+		if(length > 0) {
+			pad->curve = malloc(length * sizeof(double));
+			if(pad->curve == NULL) {
+				return luaL_error(L, "Out of memory building acceleration curve.");
+			}
+			size_t i;
+			for(i = 0; i < length; i++) {
+				lua_rawgeti(L, -1, i + 1);
+				pad->curve[i] = lua_tonumber(L, -1);
+				lua_pop(L, 1);
+			}
+			pad->curveLength = length;
+		}
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, 3, "buttons");
+	if(!lua_isnil(L, -1)) {
+		luaL_checktype(L, -1, LUA_TTABLE);
+		lua_pushnil(L);
+		while(lua_next(L, -2)) {
+			if(pad->buttonCount == TRACKPAD_MAX_BUTTONS) {
+				return luaL_error(L, "Too many button mappings.");
+			}
+			pad->buttonFrom[pad->buttonCount] = luaL_checkinteger(L, -2);
+			pad->buttonTo[pad->buttonCount] = luaL_checkinteger(L, -1);
+			pad->buttonCount++;
+			lua_pop(L, 1);
+		}
+	}
+	lua_pop(L, 1);
+
+	return 1;
+}
+
+/* linearly interpolated gain for a speed in device units/second */
+static double trackpad_gain(struct trackpad *pad, double speed) {
+	if(pad->curveLength == 0) {
+		return 1;
+	}
+
+	double position = speed / pad->curveStep;
+	size_t index = (size_t) position;
+	if(index + 1 >= pad->curveLength) {
+		return pad->curve[pad->curveLength - 1];
+	}
+
+	double fraction = position - index;
+	return pad->curve[index] + (pad->curve[index + 1] - pad->curve[index]) * fraction;
+}
+
+static void trackpad_push(struct trackpad *pad, int type, int code, int value) {
+	struct input_event *evt = &pad->frame[pad->frameLength++];
+	memset(evt, 0, sizeof(struct input_event));
+	evt->type = type;
+	evt->code = code;
+	evt->value = value;
+}
+
+/* move the whole part of an accumulated delta out of *remainder */
+static int trackpad_take(double *remainder) {
+	int whole = (int) *remainder;
+	*remainder -= whole;
+	return whole;
+}
+
+/* end the pending frame with SYN_REPORT and write it; returns 1 if a
+ * frame was written */
+static int trackpad_flush(lua_State *L, struct trackpad *pad) {
+	if(pad->frameLength == 0) {
+		return 0;
+	}
+
+	trackpad_push(pad, EV_SYN, SYN_REPORT, 0);
+	ssize_t dropped = uinput_emit(pad->output, pad->frame, pad->frameLength);
+	pad->frameLength = 0;
+
+	if(dropped < 0) {
+		return luaL_error(L, "Failure writing input event: %s", strerror(errno));
+	}
+	return dropped == 0;
+}
+
+/* returns the number of frames written */
+static int trackpad_event(lua_State *L, struct trackpad *pad, struct input_event *evt) {
+	int i, written = 0;
+
+	switch(evt->type) {
+	case EV_ABS:
+		if(evt->code == pad->absX) {
+			pad->x = evt->value;
+		} else if(evt->code == pad->absY) {
+			pad->y = evt->value;
+		}
+		return 0;
+	case EV_KEY:
+		if(evt->code == pad->touchKey) {
+			pad->touching = evt->value != 0;
+		}
+		for(i = 0; i < pad->buttonCount; i++) {
+			if(evt->code == pad->buttonFrom[i]) {
+				/* any number of button events can come before a SYN_REPORT;
+				 * keep room for the motion and the SYN_REPORT itself */
+				if(pad->frameLength >= TRACKPAD_MAX_BUTTONS) {
+					written += trackpad_flush(L, pad);
+				}
+				trackpad_push(pad, EV_KEY, pad->buttonTo[i], evt->value);
+			}
+		}
+		return written;
+	case EV_SYN:
+		if(evt->code != SYN_REPORT) {
+			return 0;
+		}
+		break;
+	default:
+		return 0;
+	}
+
+	double time = evdev_timestamp(evt);
+
+	if(pad->touching && pad->moving) {
+		double dx = pad->x - pad->lastX, dy = pad->y - pad->lastY;
+		double dt = time - pad->lastTime;
+		double ax = filter_abs(dx), ay = filter_abs(dy);
+		/* octagonal approximation of the distance moved, within ~8% */
+		double distance = ax > ay ? ax + ay * 0.5 : ay + ax * 0.5;
+		double gain = trackpad_gain(pad, dt > 0 ? distance / dt : 0);
+
+		pad->remainderX += dx * pad->scale * gain;
+		pad->remainderY += dy * pad->scale * gain;
+
+		int moveX = trackpad_take(&pad->remainderX);
+		int moveY = trackpad_take(&pad->remainderY);
+		if(moveX) {
+			trackpad_push(pad, EV_REL, pad->relX, moveX);
+		}
+		if(moveY) {
+			trackpad_push(pad, EV_REL, pad->relY, moveY);
+		}
+	} else {
+		/* a new touch starts from where it lands, not where the last ended */
+		pad->remainderX = pad->remainderY = 0;
+	}
+
+	pad->moving = pad->touching;
+	pad->lastX = pad->x;
+	pad->lastY = pad->y;
+	pad->lastTime = time;
+
+	return trackpad_flush(L, pad);
+}
+
+/* Convert everything the device has ready, blocking for the first event
+ * like Device:read(); returns frames written, or nil on EOF. */
+static int trackpad_pump(lua_State *L) {
+	CHECK_TRACKPAD(pad, 1)
+
+	struct input_event evt;
+	int frames = 0;
+
+	lua_settop(L, 1);
+	lua_getuservalue(L, 1);
+	lua_rawgeti(L, 2, 1);
+
+	do {
+		if(!evdev_fetch(L, 3, pad->input, &evt)) {
+			return 0;
+		}
+		frames += trackpad_event(L, pad, &evt);
+	} while(!(evt.type == EV_SYN && !evdev_readable(pad->input->fd)) || evdev_pendingEvents(pad->input) > 0);
+
+	lua_pushinteger(L, frames);
+	return 1;
+}
+
+static int trackpad_pollfd(lua_State *L) {
+	CHECK_TRACKPAD(pad, 1)
+
+	lua_pushinteger(L, pad->input->fd);
+
+	return 1;
+}
+
+static int trackpad_gc(lua_State *L) {
+	struct trackpad *pad = luaL_checkudata(L, 1, TRACKPAD_USERDATA);
+
+	free(pad->curve);
+	pad->curve = NULL;
+	pad->curveLength = 0;
+
+	return 0;
+}
+
+/* Aggregation
+ * 
+ * An Aggregate presents several grabbed Devices as one Uinput node. Each
+ * device's capabilities are copied onto the not-yet-initialized Uinput as
+ * it's added; afterwards every source's events are collected into its own
+ * frame buffer and written out whole, with one write per SYN_REPORT, so
+ * frames from different sources never interleave. The uservalue table
+ * holds the Uinput at [1] and the sources from [2]. */
+
+#define AGGREGATE_USERDATA "us.tropi.evdev.struct.aggregate"
+
+struct aggregateSource {
+	struct inputDevice *dev;
+	struct input_event *frame;
+	size_t count, cap;
+	int dropping; // discarding until SYN_REPORT after a SYN_DROPPED
+	int eof;
+};
+
+struct aggregate {
+	struct userdev *output;
+	struct aggregateSource *sources;
+	int sourceCount, sourceCap;
+	int epfd; // -1 until pollfd() is asked for
+	unsigned long frames, droppedFrames;
+};
+
+#define CHECK_AGGREGATE(agg, index) \
+struct aggregate *agg = luaL_checkudata(L, index, AGGREGATE_USERDATA); \
+if(agg->output->fd == -1) { \
+	return luaL_error(L, "Trying to use aggregate with closed uinput device node."); \
+}
+
+static int aggregate_open(lua_State *L) {
+	CHECK_UINPUT(output, 1, 2)
+
+	struct aggregate *agg = lua_newuserdata(L, sizeof(struct aggregate));
+	memset(agg, 0, sizeof(struct aggregate));
+	agg->output = output;
+	agg->epfd = -1;
+	luaL_setmetatable(L, AGGREGATE_USERDATA);
+
+	lua_newtable(L);
+	lua_pushvalue(L, 1);
+	lua_rawseti(L, -2, 1);
+	lua_setuservalue(L, -2);
+
+	return 1;
+}
+
+/* the uinput ioctl enabling codes of each type that can be forwarded;
+ * autorepeat and force feedback stay with the physical devices */
+static unsigned long aggregate_setBit(int type) {
+	switch(type) {
+	case EV_KEY: return UI_SET_KEYBIT;
+	case EV_REL: return UI_SET_RELBIT;
+	case EV_ABS: return UI_SET_ABSBIT;
+	case EV_MSC: return UI_SET_MSCBIT;
+	case EV_SW: return UI_SET_SWBIT;
+	case EV_LED: return UI_SET_LEDBIT;
+	case EV_SND: return UI_SET_SNDBIT;
+	default: return 0;
+	}
+}
+
+/* copy a device's event types, codes, axis ranges and properties */
+static void aggregate_copyCapabilities(struct inputDevice *dev, struct userdev *output) {
+	uint8_t types[EV_CNT / 8 + 1];
+	uint8_t codes[KEY_CNT / 8 + 1];
+	int type, code;
+
+	memset(types, 0, sizeof(types));
+	ioctl(dev->fd, EVIOCGBIT(0, sizeof(types)), types);
+
+	for(type = 1; type < EV_CNT; type++) {
+		unsigned long setBit = aggregate_setBit(type);
+		if(!(types[type / 8] >> (type % 8) & 1) || setBit == 0) {
+			continue;
+		}
+		ioctl(output->fd, UI_SET_EVBIT, type);
+
+		memset(codes, 0, sizeof(codes));
+		ioctl(dev->fd, EVIOCGBIT(type, sizeof(codes)), codes);
+
+		for(code = 0; code < event_codeCount(type); code++) {
+			if(!(codes[code / 8] >> (code % 8) & 1)) {
+				continue;
+			}
+			ioctl(output->fd, setBit, code);
+
+			if(type == EV_ABS) {
+				struct input_absinfo info;
+				if(ioctl(dev->fd, EVIOCGABS(code), &info) < 0) {
+					continue;
+				}
+				/* axes several devices share take the widest range */
+				int unset = output->dev.absmin[code] == 0 && output->dev.absmax[code] == 0;
+				if(unset || info.minimum < output->dev.absmin[code]) {
+					output->dev.absmin[code] = info.minimum;
+				}
+				if(unset || info.maximum > output->dev.absmax[code]) {
+					output->dev.absmax[code] = info.maximum;
+				}
+				output->dev.absfuzz[code] = info.fuzz;
+				output->dev.absflat[code] = info.flat;
+			}
+		}
+	}
+
+	memset(codes, 0, sizeof(codes));
+	if(ioctl(dev->fd, EVIOCGPROP(sizeof(codes)), codes) >= 0) {
+		for(code = 0; code < INPUT_PROP_CNT; code++) {
+			if(codes[code / 8] >> (code % 8) & 1) {
+				ioctl(output->fd, UI_SET_PROPBIT, code);
+			}
+		}
+	}
+}
+
+/* add(device[, grab]) - before the Uinput is initialized, take on the
+ * device's capabilities and grab it (unless `grab` is false) */
+static int aggregate_add(lua_State *L) {
+	CHECK_AGGREGATE(agg, 1)
+	CHECK_EVDEV(dev, 2)
+	int grab = lua_isnoneornil(L, 3) || lua_toboolean(L, 3);
+
+	if(agg->output->init) {
+		return luaL_error(L, "Trying to add to an aggregate whose uinput device is initialized.");
+	}
+
+	if(agg->sourceCount == agg->sourceCap) {
+		int cap = agg->sourceCap ? agg->sourceCap * 2 : 4;
+		struct aggregateSource *sources = realloc(agg->sources, cap * sizeof(struct aggregateSource));
+		if(sources == NULL) {
+			return luaL_error(L, "Out of memory adding aggregate source.");
+		}
+		agg->sources = sources;
+		agg->sourceCap = cap;
+	}
+
+	if(grab) {
+		if(ioctl(dev->fd, EVIOCGRAB, 1) < 0) {
+			return luaL_error(L, "Couldn't grab device: %s", strerror(errno));
+		}
+		dev->grabbed = 1;
+	}
+
+	aggregate_copyCapabilities(dev, agg->output);
+
+	struct aggregateSource *source = &agg->sources[agg->sourceCount++];
+	memset(source, 0, sizeof(struct aggregateSource));
+	source->dev = dev;
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, agg->sourceCount + 1);
+
+	if(agg->epfd != -1) {
+		struct epoll_event watch;
+		memset(&watch, 0, sizeof(watch));
+		watch.events = EPOLLIN;
+		watch.data.fd = dev->fd;
+		epoll_ctl(agg->epfd, EPOLL_CTL_ADD, dev->fd, &watch);
+	}
+
+	return 0;
+}
+
+/* Stop following a source that hit EOF or was closed. A closed fd left
+ * the poll set along with its file, unless the file is still open
+ * elsewhere; an open one at EOF would otherwise stay readable forever. */
+static void aggregate_end(struct aggregate *agg, struct aggregateSource *source) {
+	source->eof = 1;
+	if(agg->epfd != -1 && source->dev->fd != -1) {
+		epoll_ctl(agg->epfd, EPOLL_CTL_DEL, source->dev->fd, NULL);
+	}
+}
+
+/* buffer one event of a source's frame; returns 1 if a frame was written */
+static int aggregate_event(lua_State *L, struct aggregate *agg, struct aggregateSource *source, const struct input_event *evt) {
+	if(evt->type == EV_SYN && evt->code == SYN_DROPPED) {
+		source->count = 0;
+		source->dropping = 1;
+		agg->droppedFrames++;
+		return 0;
+	}
+
+	if(source->count == source->cap) {
+		size_t cap = source->cap ? source->cap * 2 : 16;
+		struct input_event *frame = realloc(source->frame, cap * sizeof(struct input_event));
+		if(frame == NULL) {
+			return luaL_error(L, "Out of memory buffering aggregate frame.");
+		}
+		source->frame = frame;
+		source->cap = cap;
+	}
+	source->frame[source->count++] = *evt;
+
+	if(!(evt->type == EV_SYN && evt->code == SYN_REPORT)) {
+		return 0;
+	}
+
+	size_t count = source->count;
+	source->count = 0;
+
+	/* the rest of a frame cut by SYN_DROPPED is stale */
+	if(source->dropping) {
+		source->dropping = 0;
+		return 0;
+	}
+
+	ssize_t dropped = uinput_emit(agg->output, source->frame, count);
+	if(dropped < 0) {
+		return luaL_error(L, "Failure writing input event: %s", strerror(errno));
+	} else if(dropped > 0) {
+		agg->droppedFrames++;
+		return 0;
+	}
+
+	agg->frames++;
+	return 1;
+}
+
+/* Forward everything the sources have ready, blocking until at least one
+ * has something; returns the number of frames written, or nil once every
+ * source has reached EOF. */
+static int aggregate_pump(lua_State *L) {
+	CHECK_AGGREGATE(agg, 1)
+
+	struct input_event evt;
+	int frames = 0, live = 0, ready = 0, i;
+
+	if(!agg->output->init) {
+		return luaL_error(L, "Trying to use uninitialized uinput device node.");
+	}
+
+	lua_settop(L, 1);
+	lua_getuservalue(L, 1);
+
+	/* wait for the first event from any source */
+	struct pollfd pfds[agg->sourceCount > 0 ? agg->sourceCount : 1];
+	for(i = 0; i < agg->sourceCount; i++) {
+		struct aggregateSource *source = &agg->sources[i];
+		if(source->eof) {
+			continue;
+		} else if(source->dev->fd == -1) {
+			aggregate_end(agg, source);
+			continue;
+		}
+		ready |= evdev_pendingEvents(source->dev) > 0;
+		pfds[live].fd = source->dev->fd;
+		pfds[live].events = POLLIN;
+		pfds[live].revents = 0;
+		live++;
+	}
+
+	if(live == 0) {
+		return 0;
+	}
+
+	if(!ready) {
+		while(poll(pfds, live, -1) < 0) {
+			if(errno != EINTR) {
+				return luaL_error(L, "Failure waiting on aggregate sources: %s", strerror(errno));
+			}
+		}
+	}
+
+	for(i = 0; i < agg->sourceCount; i++) {
+		struct aggregateSource *source = &agg->sources[i];
+		if(source->eof) {
+			continue;
+		}
+
+		lua_rawgeti(L, 2, i + 2);
+		while(evdev_pendingEvents(source->dev) > 0 || evdev_readable(source->dev->fd)) {
+			if(!evdev_fetch(L, 3, source->dev, &evt)) {
+				aggregate_end(agg, source);
+				break;
+			}
+			frames += aggregate_event(L, agg, source, &evt);
+			if(source->dev->fd == -1) {
+				aggregate_end(agg, source);
+				break;
+			}
+		}
+		lua_pop(L, 1);
+	}
+
+	lua_pushinteger(L, frames);
+	return 1;
+}
+
+/* an epoll fd over every source, for cqueues and other event loops */
+static int aggregate_pollfd(lua_State *L) {
+	CHECK_AGGREGATE(agg, 1)
+
+	if(agg->epfd == -1) {
+		int epfd = epoll_create1(EPOLL_CLOEXEC);
+		if(epfd < 0) {
+			return luaL_error(L, "Couldn't create aggregate poll set.");
+		}
+
+		int i;
+		for(i = 0; i < agg->sourceCount; i++) {
+			if(agg->sources[i].eof || agg->sources[i].dev->fd == -1) {
+				continue;
+			}
+			struct epoll_event watch;
+			memset(&watch, 0, sizeof(watch));
+			watch.events = EPOLLIN;
+			watch.data.fd = agg->sources[i].dev->fd;
+			epoll_ctl(epfd, EPOLL_CTL_ADD, agg->sources[i].dev->fd, &watch);
+		}
+
+		agg->epfd = epfd;
+	}
+
+	lua_pushinteger(L, agg->epfd);
+	return 1;
+}
+
+/* stats() - frames forwarded, and frames lost to SYN_DROPPED or a full
+ * uinput queue */
+static int aggregate_stats(lua_State *L) {
+	struct aggregate *agg = luaL_checkudata(L, 1, AGGREGATE_USERDATA);
+
+	lua_createtable(L, 0, 2);
+	lua_pushinteger(L, agg->frames);
+	lua_setfield(L, -2, "frames");
+	lua_pushinteger(L, agg->droppedFrames);
+	lua_setfield(L, -2, "droppedFrames");
+
+	return 1;
+}
+
+static int aggregate_gc(lua_State *L) {
+	struct aggregate *agg = luaL_checkudata(L, 1, AGGREGATE_USERDATA);
+	int i;
+
+	for(i = 0; i < agg->sourceCount; i++) {
+		free(agg->sources[i].frame);
+	}
+	free(agg->sources);
+	agg->sources = NULL;
+	agg->sourceCount = agg->sourceCap = 0;
+
+	if(agg->epfd != -1) {
+		close(agg->epfd);
+		agg->epfd = -1;
+	}
+
+	return 0;
+}
+
+/* Forwarding threads
+ * 
+ * A Forwarder copies events from a Device to a Uinput on a thread of its
+ * own, so forwarding keeps going while the Lua process is descheduled or
+ * busy. The thread works on duplicates of both fds and never enters Lua,
+ * so events skip the device's filters and other stages. It can be pinned
+ * to CPUs, run under SCHED_FIFO, and given a locked buffer and stack so
+ * page faults can't stall it. A setting that can't be applied is
+ * reported by status() instead of failing the forwarder, unless the
+ * `strict` option asks otherwise. Counters shared with the thread are
+ * only touched atomically. */
+
+#define FORWARDER_USERDATA "us.tropi.evdev.struct.forwarder"
+#define FORWARDER_BATCH 64
+#define FORWARDER_STACK_SIZE (256 * 1024)
+
+enum { FORWARD_RUNNING, FORWARD_EOF, FORWARD_FAILED, FORWARD_STOPPED, FORWARD_REVOKED };
+static const char *const forward_states[] = { "running", "eof", "failed", "stopped", "revoked", NULL };
+
+struct forwarder {
+	int input, output; // duplicated Device and Uinput fds
+	int stopfd; // eventfd waking the thread to exit
+	pthread_t thread;
+	int started;
+
+	struct input_event *buffer; // FORWARDER_BATCH events
+	void *stack; // NULL unless locked
+	size_t bufferSize, stackSize;
+
+	/* configuration, each with 0 or the errno it failed with */
+	cpu_set_t cpus;
+	int cpuCount, cpuError;
+	int priority, priorityError;
+	int lock, lockError;
+
+	/* shared with the thread */
+	int state, error;
+	int nodev; // ended with EVDEV_ENDED_NODEV, as of endedAt
+	dev_t endedDev;
+	uint64_t endedAt;
+	uint64_t events, frames, writes;
+	uint64_t latencyTotal, latencyMax; // microseconds
+};
+
+static uint64_t realtime_us(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint64_t) now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+static void *forward_finish(struct forwarder *fwd, int state, int error) {
+	__atomic_store_n(&fwd->error, error, __ATOMIC_RELAXED);
+	__atomic_store_n(&fwd->state, state, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/* write everything, waiting out a full uinput queue; 0 if told to stop */
+static int forward_write(struct forwarder *fwd, size_t bytes) {
+	const char *data = (const char *) fwd->buffer;
+	struct pollfd fds[2] = {
+		{ fwd->output, POLLOUT, 0 },
+		{ fwd->stopfd, POLLIN, 0 },
+	};
+
+	while(bytes > 0) {
+		ssize_t written = write(fwd->output, data, bytes);
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			} else if(errno != EAGAIN) {
+				return -1;
+			}
+			if(poll(fds, 2, -1) < 0 && errno != EINTR) {
+				return -1;
+			}
+			if(fds[1].revents) {
+				return 0;
+			}
+			continue;
+		}
+		__atomic_add_fetch(&fwd->writes, 1, __ATOMIC_RELAXED);
+		data += written;
+		bytes -= written;
+	}
+
+	return 1;
+}
+
+static void *forward_thread(void *arg) {
+	struct forwarder *fwd = arg;
+	struct pollfd fds[2] = {
+		{ fwd->input, POLLIN, 0 },
+		{ fwd->stopfd, POLLIN, 0 },
+	};
+
+	for(;;) {
+		if(poll(fds, 2, -1) < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return forward_finish(fwd, FORWARD_FAILED, errno);
+		}
+		if(fds[1].revents) {
+			return forward_finish(fwd, FORWARD_STOPPED, 0);
+		}
+		if(!fds[0].revents) {
+			continue;
+		}
+
+		ssize_t bytes = read(fwd->input, fwd->buffer, fwd->bufferSize);
+		if(bytes < 0 && (errno == EINTR || errno == EAGAIN)) {
+			continue;
+		} else if(bytes == 0 || (bytes < 0 && errno == ENODEV)) {
+			/* unplugged, or revoked through the Device or another copy */
+			int reason = evdev_endReason(fwd->input, NULL, bytes, &fwd->endedDev);
+			fwd->nodev = reason == EVDEV_ENDED_NODEV;
+			fwd->endedAt = monotonic_ns();
+			return forward_finish(fwd, reason == EVDEV_ENDED_REVOKED ? FORWARD_REVOKED : FORWARD_EOF, 0);
+		} else if(bytes < 0) {
+			return forward_finish(fwd, FORWARD_FAILED, errno);
+		}
+		bytes -= bytes % sizeof(struct input_event);
+
+		int result = forward_write(fwd, bytes);
+		if(result < 0) {
+			return forward_finish(fwd, FORWARD_FAILED, errno);
+		} else if(result == 0) {
+			return forward_finish(fwd, FORWARD_STOPPED, 0);
+		}
+
+		/* latency is measured against the kernel timestamp of each frame */
+		size_t i, count = bytes / sizeof(struct input_event);
+		uint64_t now = realtime_us();
+		for(i = 0; i < count; i++) {
+			struct input_event *evt = &fwd->buffer[i];
+			if(evt->type == EV_SYN && evt->code == SYN_REPORT) {
+				uint64_t stamp = (uint64_t) evt->input_event_sec * 1000000u + evt->input_event_usec;
+				uint64_t latency = now > stamp ? now - stamp : 0;
+				__atomic_add_fetch(&fwd->frames, 1, __ATOMIC_RELAXED);
+				__atomic_add_fetch(&fwd->latencyTotal, latency, __ATOMIC_RELAXED);
+				if(latency > __atomic_load_n(&fwd->latencyMax, __ATOMIC_RELAXED)) {
+					__atomic_store_n(&fwd->latencyMax, latency, __ATOMIC_RELAXED);
+				}
+			}
+		}
+		__atomic_add_fetch(&fwd->events, count, __ATOMIC_RELAXED);
+	}
+}
+
+/* allocate the buffer (and, when locking, the stack) as locked mappings */
+static int forward_allocate(struct forwarder *fwd) {
+	fwd->bufferSize = FORWARDER_BATCH * sizeof(struct input_event);
+
+	if(!fwd->lock) {
+		fwd->buffer = malloc(fwd->bufferSize);
+		return fwd->buffer == NULL ? -1 : 0;
+	}
+
+	fwd->buffer = mmap(NULL, fwd->bufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(fwd->buffer == MAP_FAILED) {
+		fwd->buffer = NULL;
+		return -1;
+	}
+	fwd->stackSize = FORWARDER_STACK_SIZE;
+	fwd->stack = mmap(NULL, fwd->stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+	if(fwd->stack == MAP_FAILED) {
+		fwd->stack = NULL;
+		return -1;
+	}
+
+	/* failing to lock (say, over RLIMIT_MEMLOCK) isn't fatal */
+	if(mlock(fwd->buffer, fwd->bufferSize) < 0 || mlock(fwd->stack, fwd->stackSize) < 0) {
+		fwd->lockError = errno;
+	}
+
+	return 0;
+}
+
+static void forward_stop(struct forwarder *fwd) {
+	if(fwd->started) {
+		uint64_t one = 1;
+		while(write(fwd->stopfd, &one, sizeof(one)) < 0 && errno == EINTR)
+			;
+		pthread_join(fwd->thread, NULL);
+		fwd->started = 0;
+	}
+}
+
+static void forward_free(struct forwarder *fwd) {
+	forward_stop(fwd);
+
+	if(fwd->input != -1) {
+		close(fwd->input);
+		fwd->input = -1;
+	}
+	if(fwd->output != -1) {
+		close(fwd->output);
+		fwd->output = -1;
+	}
+	if(fwd->stopfd != -1) {
+		close(fwd->stopfd);
+		fwd->stopfd = -1;
+	}
+
+	if(fwd->lock) {
+		if(fwd->buffer != NULL) {
+			munmap(fwd->buffer, fwd->bufferSize);
+		}
+		if(fwd->stack != NULL) {
+			munmap(fwd->stack, fwd->stackSize);
+		}
+	} else {
+		free(fwd->buffer);
+	}
+	fwd->buffer = NULL;
+	fwd->stack = NULL;
+}
+
+/* read the cpus option: one CPU number or a list of them */
+static void forward_cpus(lua_State *L, struct forwarder *fwd) {
+	CPU_ZERO(&fwd->cpus);
+
+	lua_getfield(L, 3, "cpus");
+	if(lua_isnumber(L, -1)) {
+		lua_newtable(L);
+		lua_insert(L, -2);
+		lua_rawseti(L, -2, 1);
+	} else if(!lua_isnil(L, -1)) {
+		luaL_checktype(L, -1, LUA_TTABLE);
+	}
+
+	if(lua_istable(L, -1)) {
+		lua_Integer i, count = luaL_len(L, -1);
+		for(i = 1; i <= count; i++) {
+			lua_rawgeti(L, -1, i);
+			lua_Integer cpu = luaL_checkinteger(L, -1);
+			luaL_argcheck(L, cpu >= 0 && cpu < CPU_SETSIZE, 3, "no such CPU");
+			CPU_SET(cpu, &fwd->cpus);
+			fwd->cpuCount++;
+			lua_pop(L, 1);
+		}
+	}
+	lua_pop(L, 1);
+}
+
+/* Forwarder(device, uinput[, options]) - options are `cpus`, `priority`
+ * (SCHED_FIFO, 1-99), `lock` and `strict` */
+static int forward_open(lua_State *L) {
+	CHECK_EVDEV(input, 1)
+	CHECK_UINPUT(output, 2, 1)
+
+	if(!lua_isnoneornil(L, 3)) {
+		luaL_checktype(L, 3, LUA_TTABLE);
+	} else {
+		lua_settop(L, 2);
+		lua_newtable(L);
+	}
+
+	struct forwarder *fwd = lua_newuserdata(L, sizeof(struct forwarder));
+	memset(fwd, 0, sizeof(struct forwarder));
+	fwd->input = fwd->output = fwd->stopfd = -1;
+	luaL_setmetatable(L, FORWARDER_USERDATA);
+
+	/* keep both objects around for as long as the thread might run */
+	lua_newtable(L);
+	lua_pushvalue(L, 1);
+	lua_rawseti(L, -2, 1);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, 2);
+	lua_setuservalue(L, -2);
+
+	forward_cpus(L, fwd);
+	fwd->priority = option_number(L, 3, "priority", 0);
+	luaL_argcheck(L, fwd->priority >= 0 && fwd->priority <= 99, 3, "priority out of range");
+	lua_getfield(L, 3, "lock");
+	fwd->lock = lua_toboolean(L, -1);
+	lua_getfield(L, 3, "strict");
+	int strict = lua_toboolean(L, -1);
+	lua_pop(L, 2);
+
+	fwd->input = fcntl(input->fd, F_DUPFD_CLOEXEC, 0);
+	fwd->output = fcntl(output->fd, F_DUPFD_CLOEXEC, 0);
+	fwd->stopfd = eventfd(0, EFD_CLOEXEC);
+	if(fwd->input < 0 || fwd->output < 0 || fwd->stopfd < 0) {
+		int error = errno;
+		forward_free(fwd);
+		return luaL_error(L, "Couldn't set up forwarder: %s", strerror(error));
+	}
+
+	if(forward_allocate(fwd) < 0) {
+		forward_free(fwd);
+		return luaL_error(L, "Out of memory allocating forwarder.");
+	}
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	if(fwd->stack != NULL) {
+		pthread_attr_setstack(&attr, fwd->stack, fwd->stackSize);
+	}
+	/* threads inherit the mask: leave every signal to the Lua thread */
+	sigset_t saved;
+	flight_blockSignals(&saved);
+	int error = pthread_create(&fwd->thread, &attr, &forward_thread, fwd);
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+	pthread_attr_destroy(&attr);
+	if(error != 0) {
+		forward_free(fwd);
+		return luaL_error(L, "Couldn't start forwarder thread: %s", strerror(error));
+	}
+	fwd->started = 1;
+
+	if(fwd->cpuCount > 0) {
+		fwd->cpuError = pthread_setaffinity_np(fwd->thread, sizeof(cpu_set_t), &fwd->cpus);
+	}
+	if(fwd->priority > 0) {
+		struct sched_param param;
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = fwd->priority;
+		fwd->priorityError = pthread_setschedparam(fwd->thread, SCHED_FIFO, &param);
+	}
+
+	if(strict && (fwd->cpuError || fwd->priorityError || fwd->lockError)) {
+		const char *what = fwd->cpuError ? "CPU affinity" : fwd->priorityError ? "SCHED_FIFO priority" : "locked memory";
+		error = fwd->cpuError ? fwd->cpuError : fwd->priorityError ? fwd->priorityError : fwd->lockError;
+		forward_free(fwd);
+		return luaL_error(L, "Couldn't apply forwarder %s: %s", what, strerror(error));
+	}
+
+	return 1;
+}
+
+static void forward_pushSetting(lua_State *L, const char *key, int error) {
+	if(error != 0) {
+		lua_pushstring(L, strerror(error));
+		lua_setfield(L, -2, key);
+	}
+}
+
+/* status() - a table describing the thread, its settings and counters */
+static int forward_status(lua_State *L) {
+	struct forwarder *fwd = luaL_checkudata(L, 1, FORWARDER_USERDATA);
+	int state = fwd->input == -1 ? FORWARD_STOPPED : __atomic_load_n(&fwd->state, __ATOMIC_ACQUIRE);
+	int i, n;
+
+	if(state == FORWARD_EOF && fwd->nodev
+		&& evdev_resolveEnd(EVDEV_ENDED_NODEV, fwd->endedDev, fwd->endedAt) == EVDEV_ENDED_REVOKED) {
+		state = FORWARD_REVOKED;
+	}
+
+	lua_newtable(L);
+
+	lua_pushstring(L, forward_states[state]);
+	lua_setfield(L, -2, "state");
+	if(state == FORWARD_FAILED) {
+		lua_pushstring(L, strerror(__atomic_load_n(&fwd->error, __ATOMIC_RELAXED)));
+		lua_setfield(L, -2, "error");
+	}
+
+	/* settings as applied; failures are listed under errors */
+	if(fwd->cpuCount > 0 && fwd->cpuError == 0) {
+		lua_newtable(L);
+		for(i = 0, n = 0; i < CPU_SETSIZE; i++) {
+			if(CPU_ISSET(i, &fwd->cpus)) {
+				lua_pushinteger(L, i);
+				lua_rawseti(L, -2, ++n);
+			}
+		}
+		lua_setfield(L, -2, "cpus");
+	}
+	lua_pushinteger(L, fwd->priorityError == 0 ? fwd->priority : 0);
+	lua_setfield(L, -2, "priority");
+	lua_pushboolean(L, fwd->lock && fwd->lockError == 0);
+	lua_setfield(L, -2, "locked");
+
+	lua_newtable(L);
+	forward_pushSetting(L, "cpus", fwd->cpuError);
+	forward_pushSetting(L, "priority", fwd->priorityError);
+	forward_pushSetting(L, "lock", fwd->lockError);
+	lua_setfield(L, -2, "errors");
+
+	uint64_t frames = __atomic_load_n(&fwd->frames, __ATOMIC_RELAXED);
+	uint64_t total = __atomic_load_n(&fwd->latencyTotal, __ATOMIC_RELAXED);
+	lua_pushnumber(L, __atomic_load_n(&fwd->events, __ATOMIC_RELAXED));
+	lua_setfield(L, -2, "events");
+	lua_pushnumber(L, frames);
+	lua_setfield(L, -2, "frames");
+	lua_pushnumber(L, __atomic_load_n(&fwd->writes, __ATOMIC_RELAXED));
+	lua_setfield(L, -2, "writes");
+	lua_pushnumber(L, frames > 0 ? total / 1e6 / frames : 0);
+	lua_setfield(L, -2, "meanLatency");
+	lua_pushnumber(L, __atomic_load_n(&fwd->latencyMax, __ATOMIC_RELAXED) / 1e6);
+	lua_setfield(L, -2, "maxLatency");
+
+	return 1;
+}
+
+static int forward_close(lua_State *L) {
+	struct forwarder *fwd = luaL_checkudata(L, 1, FORWARDER_USERDATA);
+
+	forward_free(fwd);
+
+	return 0;
+}
+
+/* Pools
+ * 
+ * UI_DEV_CREATE makes udev, libinput and compositors rescan, so a new
+ * Uinput takes a while to become usable. A Pool keeps initialized
+ * Uinputs of named capability profiles around and hands them out and
+ * back, reset between users so no key stays held. The uservalue table
+ * maps each profile name to a table holding its setup, title and idle
+ * devices, and `leased` to a table of handed-out devices; holding them
+ * there keeps garbage-collection from destroying pooled devices. */
+
+#define POOL_USERDATA "us.tropi.evdev.struct.pool"
+#define POOL_PATH_MAX 256
+
+struct pool {
+	char path[POOL_PATH_MAX];
+	int closed;
+};
+
+/* built-in profiles, for use in place of a setup function */
+static const char *const pool_profiles[] = { "keyboard", "mouse", "gamepad", NULL };
+
+static void pool_setKeys(struct userdev *dev, int first, int last) {
+	int code;
+	for(code = first; code <= last; code++) {
+		ioctl(dev->fd, UI_SET_KEYBIT, code);
+	}
+}
+
+static void pool_setAbs(struct userdev *dev, int axis, int min, int max) {
+	ioctl(dev->fd, UI_SET_ABSBIT, axis);
+	dev->dev.absmin[axis] = min;
+	dev->dev.absmax[axis] = max;
+}
+
+static void pool_applyProfile(struct userdev *dev, int profile) {
+	switch(profile) {
+	case 0: /* keyboard */
+		ioctl(dev->fd, UI_SET_EVBIT, EV_KEY);
+		ioctl(dev->fd, UI_SET_EVBIT, EV_REP);
+		pool_setKeys(dev, KEY_ESC, KEY_MICMUTE);
+		break;
+	case 1: /* mouse */
+		ioctl(dev->fd, UI_SET_EVBIT, EV_KEY);
+		ioctl(dev->fd, UI_SET_EVBIT, EV_REL);
+		pool_setKeys(dev, BTN_LEFT, BTN_TASK);
+		ioctl(dev->fd, UI_SET_RELBIT, REL_X);
+		ioctl(dev->fd, UI_SET_RELBIT, REL_Y);
+		ioctl(dev->fd, UI_SET_RELBIT, REL_WHEEL);
+		ioctl(dev->fd, UI_SET_RELBIT, REL_HWHEEL);
+		break;
+	case 2: /* gamepad */
+		ioctl(dev->fd, UI_SET_EVBIT, EV_KEY);
+		ioctl(dev->fd, UI_SET_EVBIT, EV_ABS);
+		pool_setKeys(dev, BTN_SOUTH, BTN_THUMBR);
+		pool_setKeys(dev, BTN_DPAD_UP, BTN_DPAD_RIGHT);
+		pool_setAbs(dev, ABS_X, -32768, 32767);
+		pool_setAbs(dev, ABS_Y, -32768, 32767);
+		pool_setAbs(dev, ABS_RX, -32768, 32767);
+		pool_setAbs(dev, ABS_RY, -32768, 32767);
+		pool_setAbs(dev, ABS_Z, 0, 255);
+		pool_setAbs(dev, ABS_RZ, 0, 255);
+		pool_setAbs(dev, ABS_HAT0X, -1, 1);
+		pool_setAbs(dev, ABS_HAT0Y, -1, 1);
+		break;
+	}
+}
+
+/* Pool([path]) - path is the uinput node, "/dev/uinput" by default */
+static int pool_open(lua_State *L) {
+	const char *path = luaL_optstring(L, 1, "/dev/uinput");
+
+	luaL_argcheck(L, strlen(path) < POOL_PATH_MAX, 1, "path too long");
+
+	struct pool *pool = lua_newuserdata(L, sizeof(struct pool));
+	memset(pool, 0, sizeof(struct pool));
+	strcpy(pool->path, path);
+	luaL_setmetatable(L, POOL_USERDATA);
+
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_setfield(L, -2, "leased");
+	lua_setuservalue(L, -2);
+
+	return 1;
+}
+
+#define CHECK_POOL(pool, index) \
+struct pool *pool = luaL_checkudata(L, index, POOL_USERDATA); \
+if(pool->closed) { \
+	return luaL_error(L, "Trying to use closed pool."); \
+}
+
+/* push the profile table for the name at `index`, or raise an error */
+static void pool_pushProfile(lua_State *L, int index) {
+	const char *name = luaL_checkstring(L, index);
+
+	lua_getuservalue(L, 1);
+	lua_getfield(L, -1, name);
+	if(!lua_istable(L, -1) || strcmp(name, "leased") == 0) {
+		luaL_error(L, "No pool profile named %s.", name);
+	}
+	lua_remove(L, -2);
+}
+
+/* define(name, setup[, title]) - setup is a function configuring a fresh
+ * Uinput before init(), or the name of a built-in profile */
+static int pool_define(lua_State *L) {
+	CHECK_POOL(pool, 1)
+	const char *name = luaL_checkstring(L, 2);
+	const char *title = luaL_optstring(L, 4, name);
+
+	luaL_argcheck(L, strcmp(name, "leased") != 0, 2, "reserved profile name");
+	if(lua_type(L, 3) == LUA_TSTRING) {
+		luaL_checkoption(L, 3, NULL, pool_profiles);
+	} else {
+		luaL_checktype(L, 3, LUA_TFUNCTION);
+	}
+
+	lua_getuservalue(L, 1);
+	lua_getfield(L, -1, name);
+	if(!lua_isnil(L, -1)) {
+		return luaL_error(L, "Pool profile %s is already defined.", name);
+	}
+	lua_pop(L, 1);
+
+	lua_newtable(L);
+	lua_pushvalue(L, 3);
+	lua_setfield(L, -2, "setup");
+	lua_pushstring(L, title);
+	lua_setfield(L, -2, "title");
+	lua_newtable(L);
+	lua_setfield(L, -2, "idle");
+	lua_pushinteger(L, 0);
+	lua_setfield(L, -2, "created");
+	lua_setfield(L, -2, name);
+
+	return 0;
+}
+
+/* create and initialize a device for the profile table on top of the
+ * stack, pushing it */
+static void pool_create(lua_State *L, struct pool *pool) {
+	int profile = lua_gettop(L);
+
+	lua_pushcfunction(L, &uinput_open);
+	lua_pushstring(L, pool->path);
+	lua_call(L, 1, 1);
+	struct userdev *dev = luaL_checkudata(L, -1, UINPUT_USERDATA);
+
+	lua_getfield(L, profile, "setup");
+	if(lua_type(L, -1) == LUA_TSTRING) {
+		pool_applyProfile(dev, luaL_checkoption(L, -1, NULL, pool_profiles));
+		lua_pop(L, 1);
+	} else {
+		lua_pushvalue(L, -2);
+		lua_call(L, 1, 0);
+	}
+
+	lua_pushcfunction(L, &uinput_init);
+	lua_pushvalue(L, -2);
+	lua_getfield(L, profile, "title");
+	lua_call(L, 2, 0);
+
+	lua_getfield(L, profile, "created");
+	lua_pushinteger(L, lua_tointeger(L, -1) + 1);
+	lua_setfield(L, profile, "created");
+	lua_pop(L, 1);
+}
+
+/* prefill(name, count) - create idle devices until `count` are waiting */
+static int pool_prefill(lua_State *L) {
+	CHECK_POOL(pool, 1)
+	lua_Integer count = luaL_checkinteger(L, 3);
+
+	lua_settop(L, 3);
+	pool_pushProfile(L, 2);
+	lua_getfield(L, 4, "idle");
+
+	while(luaL_len(L, 5) < count) {
+		lua_pushvalue(L, 4);
+		pool_create(L, pool);
+		lua_rawseti(L, 5, luaL_len(L, 5) + 1);
+		lua_pop(L, 1);
+	}
+
+	lua_pushinteger(L, luaL_len(L, 5));
+	return 1;
+}
+
+/* acquire(name) - hand out an idle device, creating one if none is idle */
+static int pool_acquire(lua_State *L) {
+	CHECK_POOL(pool, 1)
+
+	lua_settop(L, 2);
+	pool_pushProfile(L, 2);
+	lua_getfield(L, 3, "idle");
+
+	lua_Integer idle = luaL_len(L, 4);
+	if(idle > 0) {
+		lua_rawgeti(L, 4, idle);
+		lua_pushnil(L);
+		lua_rawseti(L, 4, idle);
+	} else {
+		lua_pushvalue(L, 3);
+		pool_create(L, pool);
+		lua_remove(L, -2);
+	}
+
+	lua_getuservalue(L, 1);
+	lua_getfield(L, -1, "leased");
+	lua_pushvalue(L, -3);
+	lua_pushvalue(L, 2);
+	lua_rawset(L, -3);
+	lua_pop(L, 2);
+
+	return 1;
+}
+
+/* release(uinput) - reset a device and return it to its profile's idle list */
+static int pool_release(lua_State *L) {
+	CHECK_POOL(pool, 1)
+	struct userdev *dev = luaL_checkudata(L, 2, UINPUT_USERDATA);
+
+	lua_settop(L, 2);
+	lua_getuservalue(L, 1);
+	lua_getfield(L, 3, "leased");
+	lua_pushvalue(L, 2);
+	lua_rawget(L, 4);
+	if(lua_isnil(L, -1)) {
+		return luaL_error(L, "Uinput wasn't acquired from this pool.");
+	}
+	int name = lua_gettop(L);
+
+	lua_pushvalue(L, 2);
+	lua_pushnil(L);
+	lua_rawset(L, 4);
+
+	/* a device closed while leased is simply forgotten */
+	if(dev->fd == -1) {
+		return 0;
+	}
+
+	/* pooled devices are created write-only, and go back that way */
+	dev->readable = 0;
+	if(uinput_clear(L, dev, 2) < 0) {
+		return luaL_error(L, "Failure resetting pooled device: %s", strerror(errno));
+	}
+
+	lua_pushvalue(L, name);
+	lua_rawget(L, 3);
+	lua_getfield(L, -1, "idle");
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, luaL_len(L, -2) + 1);
+
+	return 0;
+}
+
+/* stats() - a table mapping each profile to its idle, leased and created counts */
+static int pool_stats(lua_State *L) {
+	struct pool *pool = luaL_checkudata(L, 1, POOL_USERDATA);
+	(void) pool;
+
+	lua_settop(L, 1);
+	lua_newtable(L);
+	lua_getuservalue(L, 1);
+	lua_getfield(L, 3, "leased");
+
+	lua_pushnil(L);
+	while(lua_next(L, 3)) {
+		if(lua_type(L, -2) != LUA_TSTRING || strcmp(lua_tostring(L, -2), "leased") == 0) {
+			lua_pop(L, 1);
+			continue;
+		}
+		lua_newtable(L);
+		lua_getfield(L, -2, "idle");
+		lua_pushinteger(L, luaL_len(L, -1));
+		lua_setfield(L, -3, "idle");
+		lua_pop(L, 1);
+		lua_getfield(L, -2, "created");
+		lua_setfield(L, -2, "created");
+
+		/* count the profile's leased devices */
+		lua_Integer leased = 0;
+		lua_pushnil(L);
+		while(lua_next(L, 4)) {
+			if(lua_rawequal(L, -1, 5)) {
+				leased++;
+			}
+			lua_pop(L, 1);
+		}
+		lua_pushinteger(L, leased);
+		lua_setfield(L, -2, "leased");
+
+		lua_pushvalue(L, -3);
+		lua_insert(L, -2);
+		lua_settable(L, 2);
+		lua_pop(L, 1);
+	}
+
+	lua_settop(L, 2);
+	return 1;
+}
+
+/* close() - destroy the idle devices; leased ones are left to their users */
+static int pool_close(lua_State *L) {
+	struct pool *pool = luaL_checkudata(L, 1, POOL_USERDATA);
+
+	if(pool->closed) {
+		return 0;
+	}
+
+	lua_settop(L, 1);
+	lua_getuservalue(L, 1);
+	lua_pushnil(L);
+	while(lua_next(L, 2)) {
+		if(lua_type(L, -2) == LUA_TSTRING && strcmp(lua_tostring(L, -2), "leased") != 0) {
+			lua_getfield(L, -1, "idle");
+			lua_Integer i, idle = luaL_len(L, -1);
+			for(i = 1; i <= idle; i++) {
+				lua_pushcfunction(L, &uinput_close);
+				lua_rawgeti(L, -2, i);
+				lua_call(L, 1, 0);
+			}
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+	}
+
+	pool->closed = 1;
+	lua_newtable(L);
+	lua_setuservalue(L, 1);
+
+	return 0;
+}
+
+/* Handoff
+ * 
+ * sendState() passes live Devices and Uinputs to a successor process over
+ * a Unix socket, one SOCK_SEQPACKET message per object carrying its fd
+ * (SCM_RIGHTS) and a snapshot of its C-side state: the grab flag and
+ * pressed keys, and for a Uinput its configuration. receiveState() wraps
+ * the received fds in new objects, so nothing is reopened: virtual
+ * devices survive, grabs stay in place (they belong to the open file, not
+ * the process) and held keys are still known. Lua-side setup such as
+ * filters, hotkeys or limits isn't carried over.
+ * 
+ * Force-feedback effects belong to the open file too, but the kernel
+ * erases a file's effects whenever any fd for it is closed, so the
+ * sender's close takes them with it. A Device's effect cache follows its
+ * record instead, one HANDOFF_EFFECT message per live handle, and the
+ * successor re-uploads each on its next play. Relay effects a Uinput put
+ * on its target are left alone on the way out for the same reason. */
+
+#define HANDOFF_MAGIC "EVDHND01"
+#define HANDOFF_NAME_MAX 128
+
+enum { HANDOFF_END, HANDOFF_DEVICE, HANDOFF_UINPUT, HANDOFF_EFFECT };
+
+struct handoffRecord {
+	char magic[8];
+	uint32_t kind;
+	char name[HANDOFF_NAME_MAX]; // key in the objects table
+	char path[PATH_MAX];
+	int32_t grabbed;
+	uint64_t pressed[KEY_WORDS];
+
+	/* Uinput only */
+	int32_t init, readable;
+	uint32_t queueLimit;
+	struct uinput_user_dev dev;
+
+	/* Effect only, for the Device before it */
+	uint32_t handle;
+	struct ff_effect effect;
+};
+
+/* a record and the fd that came with it, held until the stream is complete */
+struct handoffReceived {
+	struct handoffRecord record;
+	int fd;
+};
+
+static void keys_load(struct keyState *keys, const uint64_t *pressed) {
+	int code;
+
+	memset(keys, 0, sizeof(struct keyState));
+	for(code = 0; code < KEY_CNT; code++) {
+		if(bit_test(pressed, code)) {
+			keys_update(keys, code, 1);
+		}
+	}
+}
+
+static int handoff_address(lua_State *L, const char *path, struct sockaddr_un *addr) {
+	memset(addr, 0, sizeof(struct sockaddr_un));
+	addr->sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(addr->sun_path)) {
+		return luaL_error(L, "Socket path too long.");
+	}
+	strcpy(addr->sun_path, path);
+	return 0;
+}
+
+static int handoff_sendRecord(int sock, struct handoffRecord *record, int fd) {
+	union {
+		struct cmsghdr header;
+		char space[CMSG_SPACE(sizeof(int))];
+	} control;
+	struct iovec iov = { record, sizeof(struct handoffRecord) };
+	struct msghdr msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+
+	if(fd != -1) {
+		memset(&control, 0, sizeof(control));
+		msg.msg_control = control.space;
+		msg.msg_controllen = sizeof(control.space);
+		struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+	}
+
+	ssize_t sent;
+	do {
+		sent = sendmsg(sock, &msg, MSG_NOSIGNAL);
+	} while(sent < 0 && errno == EINTR);
+
+	return sent == sizeof(struct handoffRecord) ? 0 : -1;
+}
+
+/* fill a record for the Device or Uinput at `index`, returning its fd */
+static int handoff_snapshot(lua_State *L, int index, struct handoffRecord *record) {
+	memset(record, 0, sizeof(struct handoffRecord));
+	memcpy(record->magic, HANDOFF_MAGIC, 8);
+
+	struct inputDevice *dev = luaL_testudata(L, index, EVDEV_USERDATA);
+	if(dev != NULL) {
+		luaL_argcheck(L, dev->fd != -1, 2, "closed Device");
+		record->kind = HANDOFF_DEVICE;
+		record->grabbed = dev->grabbed;
+		memcpy(record->pressed, dev->keys.pressed, sizeof(record->pressed));
+		strncpy(record->path, dev->stats.path, PATH_MAX - 1);
+		return dev->fd;
+	}
+
+	struct userdev *udev = luaL_testudata(L, index, UINPUT_USERDATA);
+	luaL_argcheck(L, udev != NULL, 2, "objects must be Devices or Uinputs");
+	luaL_argcheck(L, udev->fd != -1, 2, "closed Uinput");
+
+	/* queued events can't travel; give them a last chance */
+	uinput_flushQueue(udev);
+
+	record->kind = HANDOFF_UINPUT;
+	memcpy(record->pressed, udev->keys.pressed, sizeof(record->pressed));
+	strncpy(record->path, udev->stats.path, PATH_MAX - 1);
+	record->init = udev->init;
+	record->readable = udev->readable;
+	record->queueLimit = udev->queueLimit;
+	record->dev = udev->dev;
+	return udev->fd;
+}
+
+/* Send the objects in the table at stack index `objects` to the process
+ * at `path`, then close them here unless `keep`. Pushes true, or false
+ * and an error message. */
+static int handoff_sendTable(lua_State *L, const char *path, int objects, int keep) {
+	struct sockaddr_un addr;
+	struct handoffRecord record;
+	int top = lua_gettop(L);
+
+	luaL_checktype(L, objects, LUA_TTABLE);
+	handoff_address(L, path, &addr);
+
+	/* check everything before anything is sent */
+	lua_pushnil(L);
+	while(lua_next(L, objects)) {
+		luaL_argcheck(L, lua_type(L, -2) == LUA_TSTRING && lua_rawlen(L, -2) < HANDOFF_NAME_MAX, objects, "object names must be short strings");
+		handoff_snapshot(L, -1, &record);
+		lua_pop(L, 1);
+	}
+
+	int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if(sock < 0 || connect(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+		int error = errno;
+		if(sock >= 0) {
+			close(sock);
+		}
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(error));
+		return 2;
+	}
+
+	lua_pushnil(L);
+	while(lua_next(L, objects)) {
+		int fd = handoff_snapshot(L, -1, &record);
+		strcpy(record.name, lua_tostring(L, -2));
+		if(handoff_sendRecord(sock, &record, fd) < 0) {
+			goto failed;
+		}
+
+		struct inputDevice *dev = luaL_testudata(L, -1, EVDEV_USERDATA);
+		if(dev != NULL && dev->effects != NULL) {
+			size_t i;
+			for(i = 0; i < dev->effects->count; i++) {
+				if(!dev->effects->entries[i].live) {
+					continue;
+				}
+				memset(&record, 0, sizeof(record));
+				memcpy(record.magic, HANDOFF_MAGIC, 8);
+				record.kind = HANDOFF_EFFECT;
+				record.handle = i + 1;
+				record.effect = dev->effects->entries[i].spec;
+				if(handoff_sendRecord(sock, &record, -1) < 0) {
+					goto failed;
+				}
+			}
+		}
+		lua_pop(L, 1);
+	}
+
+	memset(&record, 0, sizeof(record));
+	memcpy(record.magic, HANDOFF_MAGIC, 8);
+	record.kind = HANDOFF_END;
+	if(handoff_sendRecord(sock, &record, -1) < 0) {
+		goto failed;
+	}
+
+	/* the successor acknowledges once it holds every fd */
+	char ack;
+	ssize_t got;
+	do {
+		got = recv(sock, &ack, 1, 0);
+	} while(got < 0 && errno == EINTR);
+	if(got != 1) {
+		errno = got == 0 ? ECONNRESET : errno;
+		goto failed;
+	}
+	close(sock);
+
+	/* let go of our copies; the successor's keep devices and grabs alive */
+	lua_settop(L, top);
+	lua_pushnil(L);
+	while(!keep && lua_next(L, objects)) {
+		struct userdev *udev = luaL_testudata(L, -1, UINPUT_USERDATA);
+		if(udev != NULL) {
+			/* the relay target's effects are shared with the successor */
+			free(udev->effects);
+			udev->effects = NULL;
+			uinput_release(udev, 0);
+		} else {
+			lua_pushcfunction(L, &evdev_close);
+			lua_pushvalue(L, -2);
+			lua_call(L, 1, 0);
+		}
+		lua_pop(L, 1);
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+
+failed:
+	{
+		int error = errno;
+		close(sock);
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(error));
+		return 2;
+	}
+}
+
+/* sendState(path, objects) - hand the Devices and Uinputs in `objects`, a
+ * table keyed by name, to the process listening at `path`. Once it has
+ * them, they're closed here without destroying or ungrabbing anything.
+ * Returns true, or false and an error message, leaving them open. */
+static int handoff_send(lua_State *L) {
+	const char *path = luaL_checkstring(L, 1);
+
+	lua_settop(L, 2);
+	return handoff_sendTable(L, path, 2, 0);
+}
+
+static struct inputDevice *handoff_pushDevice(lua_State *L, const struct handoffReceived *received) {
+	const struct handoffRecord *record = &received->record;
+
+	struct inputDevice *dev = evdev_wrap(L, received->fd, record->path);
+	dev->grabbed = record->grabbed;
+	keys_load(&dev->keys, record->pressed);
+	return dev;
+}
+
+/* put a handed-off effect back under its old handle, not yet uploaded; one
+ * that can't be restored just leaves its handle unknown */
+static void handoff_restoreEffect(struct inputDevice *dev, const struct handoffRecord *record) {
+	struct effectCache *cache = dev->effects;
+	size_t i = record->handle - 1;
+
+	if(cache == NULL) {
+		int slots = 0;
+		if(ioctl(dev->fd, EVIOCGEFFECTS, &slots) < 0 || slots <= 0
+			|| (cache = calloc(1, sizeof(struct effectCache))) == NULL) {
+			return;
+		}
+		cache->slots = slots;
+		dev->effects = cache;
+	}
+
+	if(i >= cache->cap) {
+		size_t cap = cache->cap ? cache->cap : 16;
+		while(cap <= i) {
+			cap *= 2;
+		}
+		struct cachedEffect *entries = realloc(cache->entries, cap * sizeof(struct cachedEffect));
+		if(entries == NULL) {
+			return;
+		}
+		cache->entries = entries;
+		cache->cap = cap;
+	}
+	while(cache->count <= i) {
+		memset(&cache->entries[cache->count], 0, sizeof(struct cachedEffect));
+		cache->entries[cache->count].effect.id = -1;
+		cache->count++;
+	}
+
+	cache->entries[i].spec = record->effect;
+	cache->entries[i].spec.id = -1;
+	if(record->effect.type == FF_PERIODIC) {
+		/* the sender's pointer means nothing here */
+		cache->entries[i].spec.u.periodic.custom_len = 0;
+		cache->entries[i].spec.u.periodic.custom_data = NULL;
+	}
+	cache->entries[i].effect = cache->entries[i].spec;
+	cache->entries[i].used = 0;
+	cache->entries[i].live = 1;
+}
+
+static void handoff_pushUinput(lua_State *L, const struct handoffReceived *received) {
+	const struct handoffRecord *record = &received->record;
+
+	struct userdev *dev = lua_newuserdata(L, sizeof(struct userdev));
+	memset(dev, 0, sizeof(struct userdev));
+	dev->fd = received->fd;
+	dev->timerfd = -1;
+	dev->epfd = -1;
+	luaL_setmetatable(L, UINPUT_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	dev->init = record->init;
+	dev->readable = record->readable;
+	dev->queueLimit = record->queueLimit > 0 ? record->queueLimit : UINPUT_DEFAULT_QUEUE_LIMIT;
+	dev->dev = record->dev;
+	keys_load(&dev->keys, record->pressed);
+	io_register(&dev->stats, "uinput", record->path);
+	snprintf(dev->stats.name, sizeof(dev->stats.name), "%s", dev->dev.name);
+}
+
+static void handoff_closeReceived(struct handoffReceived *received, size_t count) {
+	size_t i;
+	for(i = 0; i < count; i++) {
+		if(received[i].fd != -1) {
+			close(received[i].fd);
+		}
+	}
+	free(received);
+}
+
+/* only a process of our own user (or root) may hand us fds and state */
+static int handoff_trusted(int sock) {
+	struct ucred peer;
+	socklen_t len = sizeof(peer);
+
+	if(getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &peer, &len) < 0 || len != sizeof(peer)) {
+		return 0;
+	}
+	return peer.uid == geteuid() || peer.uid == 0;
+}
+
+/* receiveState(path[, timeout]) - listen at `path` for sendState() and
+ * return a table of the objects received, keyed by name; nil and a
+ * message if nothing arrives within `timeout` seconds, or if the sender
+ * runs as another user */
+static int handoff_receive(lua_State *L) {
+	const char *path = luaL_checkstring(L, 1);
+	lua_Number timeout = luaL_optnumber(L, 2, -1);
+	struct sockaddr_un addr;
+	struct handoffReceived *received = NULL;
+	size_t count = 0, cap = 0, i;
+	const char *error = NULL;
+
+	handoff_address(L, path, &addr);
+
+	int listener = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if(listener < 0) {
+		return luaL_error(L, "Couldn't create handoff socket: %s", strerror(errno));
+	}
+	/* replace a stale socket, but nothing else; nobody can connect
+	 * before it's made private, as it isn't listening yet */
+	struct stat old;
+	if(lstat(path, &old) == 0 && S_ISSOCK(old.st_mode)) {
+		unlink(path);
+	}
+	if(bind(listener, (struct sockaddr *) &addr, sizeof(addr)) < 0 || chmod(path, 0600) < 0
+		|| listen(listener, 1) < 0) {
+		int err = errno;
+		close(listener);
+		return luaL_error(L, "Couldn't listen at %s: %s", path, strerror(err));
+	}
+
+	struct pollfd pfd = { listener, POLLIN, 0 };
+	int ready;
+	do {
+		ready = poll(&pfd, 1, timeout < 0 ? -1 : (int) ceil(timeout * 1000));
+	} while(ready < 0 && errno == EINTR);
+
+	int sock = ready > 0 ? accept4(listener, NULL, NULL, SOCK_CLOEXEC) : -1;
+	close(listener);
+	unlink(path);
+	if(sock < 0) {
+		lua_pushnil(L);
+		lua_pushstring(L, ready == 0 ? "timed out" : strerror(errno));
+		return 2;
+	} else if(!handoff_trusted(sock)) {
+		/* close before reading, so none of its fds are taken */
+		close(sock);
+		lua_pushnil(L);
+		lua_pushstring(L, "sender runs as another user");
+		return 2;
+	}
+
+	for(;;) {
+		struct handoffRecord record;
+		union {
+			struct cmsghdr header;
+			char space[CMSG_SPACE(sizeof(int))];
+		} control;
+		struct iovec iov = { &record, sizeof(record) };
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control.space;
+		msg.msg_controllen = sizeof(control.space);
+
+		ssize_t got;
+		do {
+			got = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+		} while(got < 0 && errno == EINTR);
+
+		int fd = -1;
+		struct cmsghdr *cmsg = got > 0 ? CMSG_FIRSTHDR(&msg) : NULL;
+		if(cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+			memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+		}
+
+		if(got != sizeof(record) || memcmp(record.magic, HANDOFF_MAGIC, 8) != 0) {
+			error = got == 0 ? "sender hung up" : "malformed handoff message";
+		} else if(record.kind == HANDOFF_END) {
+			break;
+		} else if(record.kind == HANDOFF_EFFECT ? fd != -1 || count == 0
+				|| (received[count - 1].record.kind != HANDOFF_DEVICE && received[count - 1].record.kind != HANDOFF_EFFECT)
+				|| record.handle < 1 || record.handle > 65536
+			: (record.kind != HANDOFF_DEVICE && record.kind != HANDOFF_UINPUT) || fd == -1) {
+			error = "malformed handoff message";
+		} else if(count == cap) {
+			size_t newCap = cap ? cap * 2 : 8;
+			struct handoffReceived *grown = realloc(received, newCap * sizeof(struct handoffReceived));
+			if(grown == NULL) {
+				error = "out of memory";
+			} else {
+				received = grown;
+				cap = newCap;
+			}
+		}
+
+		if(error != NULL) {
+			if(fd != -1) {
+				close(fd);
+			}
+			close(sock);
+			handoff_closeReceived(received, count);
+			return luaL_error(L, "Handoff failed: %s", error);
+		}
+
+		record.name[HANDOFF_NAME_MAX - 1] = '\0';
+		record.path[PATH_MAX - 1] = '\0';
+		received[count].record = record;
+		received[count].fd = fd;
+		count++;
+	}
+
+	/* everything arrived; only now build objects that would close fds */
+	char ack = 1;
+	send(sock, &ack, 1, MSG_NOSIGNAL);
+	close(sock);
+
+	lua_newtable(L);
+	for(i = 0; i < count; i++) {
+		const char *name = received[i].record.name;
+		if(received[i].record.kind == HANDOFF_DEVICE) {
+			struct inputDevice *dev = handoff_pushDevice(L, &received[i]);
+			while(i + 1 < count && received[i + 1].record.kind == HANDOFF_EFFECT) {
+				handoff_restoreEffect(dev, &received[++i].record);
+			}
+		} else {
+			handoff_pushUinput(L, &received[i]);
+		}
+		lua_setfield(L, -2, name);
+	}
+	free(received);
+
+	return 1;
+}
+
+/* Groups
+ * 
+ * A session manager hands device fds to sessions it doesn't control, and
+ * closing its own copy doesn't stop theirs. A Group keeps the manager's
+ * copy of every Device it gave out, so revoke() can cut all of them off
+ * at once with EVIOCREVOKE when the session switches, rather than waiting
+ * for each holder to close its fd. */
+
+#define GROUP_USERDATA "us.tropi.evdev.struct.group"
+
+struct group {
+	size_t revoked; // over the group's lifetime
+};
+
+static int group_open(lua_State *L) {
+	struct group *group = lua_newuserdata(L, sizeof(struct group));
+	memset(group, 0, sizeof(struct group));
+	luaL_setmetatable(L, GROUP_USERDATA);
+
+	/* the uservalue is the set of member Devices */
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	return 1;
+}
+
+/* add(device) - track `device`, returning it */
+static int group_add(lua_State *L) {
+	luaL_checkudata(L, 1, GROUP_USERDATA);
+	CHECK_EVDEV(dev, 2);
+	(void) dev;
+
+	lua_settop(L, 2);
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_pushboolean(L, 1);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+
+	return 1;
+}
+
+/* open(path[, writeMode]) - open a Device like evdev.Device() and track it */
+static int group_deviceOpen(lua_State *L) {
+	luaL_checkudata(L, 1, GROUP_USERDATA);
+	luaL_checkstring(L, 2);
+
+	lua_settop(L, 3);
+	lua_pushcfunction(L, &evdev_open);
+	lua_pushvalue(L, 2);
+	lua_pushvalue(L, 3);
+	lua_call(L, 2, 1);
+	lua_replace(L, 2);
+	lua_settop(L, 2);
+
+	return group_add(L);
+}
+
+/* remove(device) - stop tracking `device` without touching it */
+static int group_remove(lua_State *L) {
+	luaL_checkudata(L, 1, GROUP_USERDATA);
+	luaL_checkudata(L, 2, EVDEV_USERDATA);
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_pushnil(L);
+	lua_rawset(L, -3);
+
+	return 0;
+}
+
+/* send(path, devices) - like evdev.sendState(), for a table of Devices,
+ * but the copies here stay open and tracked, so they can be revoked */
+static int group_send(lua_State *L) {
+	luaL_checkudata(L, 1, GROUP_USERDATA);
+	const char *path = luaL_checkstring(L, 2);
+
+	luaL_checktype(L, 3, LUA_TTABLE);
+	lua_settop(L, 3);
+	lua_pushnil(L);
+	while(lua_next(L, 3)) {
+		luaL_argcheck(L, luaL_testudata(L, -1, EVDEV_USERDATA) != NULL, 3, "only Devices can be revoked");
+		lua_pop(L, 1);
+	}
+
+	int results = handoff_sendTable(L, path, 3, 1);
+	if(!lua_toboolean(L, -results)) {
+		return results;
+	}
+
+	lua_getuservalue(L, 1);
+	lua_pushnil(L);
+	while(lua_next(L, 3)) {
+		lua_pushboolean(L, 1);
+		lua_rawset(L, -4);
+	}
+	lua_pop(L, 1);
+
+	return results;
+}
+
+/* revoke() - revoke every member, wherever its fd has been passed, and
+ * close the copies here. Returns the number revoked; members that
+ * couldn't be (such as pipes) stay in the group. */
+static int group_revoke(lua_State *L) {
+	struct group *group = luaL_checkudata(L, 1, GROUP_USERDATA);
+	int revoked = 0;
+
+	lua_settop(L, 1);
+	lua_getuservalue(L, 1);
+	lua_newtable(L); // members to drop, as the set can't change mid-traversal
+
+	lua_pushnil(L);
+	while(lua_next(L, 2)) {
+		struct inputDevice *dev = luaL_checkudata(L, -2, EVDEV_USERDATA);
+		lua_pop(L, 1);
+
+		if(dev->fd != -1) {
+			if(ioctl(dev->fd, EVIOCREVOKE, NULL) < 0) {
+				continue;
+			}
+			dev->revoked = 1;
+			dev->grabbed = 0;
+			revoked++;
+
+			lua_pushcfunction(L, &evdev_close);
+			lua_pushvalue(L, -2);
+			lua_call(L, 1, 0);
+		}
+
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, 3, lua_rawlen(L, 3) + 1);
+	}
+
+	size_t i, count = lua_rawlen(L, 3);
+	for(i = 1; i <= count; i++) {
+		lua_rawgeti(L, 3, i);
+		lua_pushnil(L);
+		lua_rawset(L, 2);
+	}
+
+	group->revoked += revoked;
+	lua_pushinteger(L, revoked);
+	return 1;
+}
+
+/* count() - the number of members, and how many have been revoked in
+ * all */
+static int group_count(lua_State *L) {
+	struct group *group = luaL_checkudata(L, 1, GROUP_USERDATA);
+	lua_Integer members = 0;
+
+	lua_getuservalue(L, 1);
+	lua_pushnil(L);
+	while(lua_next(L, -2)) {
+		members++;
+		lua_pop(L, 1);
+	}
+
+	lua_pushinteger(L, members);
+	lua_pushinteger(L, group->revoked);
+	return 2;
+}
+
+/* Dispatcher
+ * 
+ * Routes events to Lua handlers by (type, code) through flat per-type
+ * arrays of handler slots, so events nobody registered for are dropped
+ * in C without entering Lua at all. Handler functions live in the
+ * dispatcher's uservalue table, indexed by slot. */
+
+#define DISPATCHER_USERDATA "us.tropi.evdev.struct.dispatcher"
+
+struct handlerSlot {
+	int type, code; // -1 for wildcards
+	int active;
+	unsigned long calls;
+	uint64_t ns; // time spent in the handler, when profiling
+};
+
+struct dispatcher {
+	int *byCode[EV_CNT]; // slot + 1 per code; NULL until a type is used
+	int byType[EV_CNT]; // slot + 1 of the type's wildcard handler
+	int any; // slot + 1 of the catch-all handler
+	struct handlerSlot *slots;
+	int slotCount, slotCap;
+	int profiling;
+};
+
+static int dispatcher_open(lua_State *L) {
+	struct dispatcher *disp = lua_newuserdata(L, sizeof(struct dispatcher));
+	memset(disp, 0, sizeof(struct dispatcher));
+	luaL_setmetatable(L, DISPATCHER_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	return 1;
+}
+
+/* find the cell holding the slot for (type, code), allocating as needed */
+static int *dispatcher_cell(lua_State *L, struct dispatcher *disp, int type, int code) {
+	if(type < 0) {
+		return &disp->any;
+	}
+	if(code < 0) {
+		return &disp->byType[type];
+	}
+
+	int count = event_codeCount(type);
+	luaL_argcheck(L, code < count, 3, "event code out of range for its type");
+	if(disp->byCode[type] == NULL) {
+		disp->byCode[type] = calloc(count, sizeof(int));
+		if(disp->byCode[type] == NULL) {
+			luaL_error(L, "Out of memory registering handler.");
+		}
+	}
+	return &disp->byCode[type][code];
+}
+
+/* on(type, code, handler); nil type or code are wildcards,
+ * and a nil handler removes the registration */
+static int dispatcher_on(lua_State *L) {
+	struct dispatcher *disp = luaL_checkudata(L, 1, DISPATCHER_USERDATA);
+	int type = luaL_opt(L, luaL_checkinteger, 2, -1);
+	int code = luaL_opt(L, luaL_checkinteger, 3, -1);
+	int removing = lua_isnoneornil(L, 4);
+
+	luaL_argcheck(L, type < EV_CNT, 2, "event type out of range");
+	luaL_argcheck(L, type >= 0 || code < 0, 3, "a code needs a type");
+	if(!removing) {
+		luaL_checktype(L, 4, LUA_TFUNCTION);
+	}
+
+	int *cell = dispatcher_cell(L, disp, type, code);
+	int slot = *cell - 1;
+
+	if(slot < 0) {
+		if(removing) {
+			return 0;
+		}
+		if(disp->slotCount == disp->slotCap) {
+			int cap = disp->slotCap ? disp->slotCap * 2 : 8;
+			struct handlerSlot *slots = realloc(disp->slots, cap * sizeof(struct handlerSlot));
+			if(slots == NULL) {
+				return luaL_error(L, "Out of memory registering handler.");
+			}
+			disp->slots = slots;
+			disp->slotCap = cap;
+		}
+		slot = disp->slotCount++;
+		memset(&disp->slots[slot], 0, sizeof(struct handlerSlot));
+		disp->slots[slot].type = type;
+		disp->slots[slot].code = code;
+		*cell = slot + 1;
+	}
+
+	disp->slots[slot].active = !removing;
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 4);
+	lua_rawseti(L, -2, slot + 1);
+
+	return 0;
+}
+
+static void dispatcher_call(lua_State *L, struct dispatcher *disp, int handlers,
+		int cell, struct input_event *evt, int deviceIndex) {
+	struct handlerSlot *slot = &disp->slots[cell - 1];
+
+	if(!slot->active) {
+		return;
+	}
+
+	lua_rawgeti(L, handlers, cell);
+	lua_pushnumber(L, evdev_timestamp(evt));
+	lua_pushinteger(L, evt->type);
+	lua_pushinteger(L, evt->code);
+	lua_pushinteger(L, evt->value);
+	lua_pushvalue(L, deviceIndex);
+
+	slot->calls++;
+	if(disp->profiling) {
+		uint64_t start = monotonic_ns();
+		lua_call(L, 5, 0);
+		/* the handler may have added handlers, moving the slots */
+		disp->slots[cell - 1].ns += monotonic_ns() - start;
+	} else {
+		lua_call(L, 5, 0);
+	}
+}
+
+/* Drain everything the device has ready, blocking for the first event
+ * like Device:read(); returns the number of handler-matched events,
+ * or nil on EOF. */
+static int dispatcher_dispatch(lua_State *L) {
+	struct dispatcher *disp = luaL_checkudata(L, 1, DISPATCHER_USERDATA);
+	CHECK_EVDEV(dev, 2);
+
+	lua_settop(L, 2);
+	lua_getuservalue(L, 1);
+	int handlers = lua_gettop(L);
+
+	struct input_event evt;
+	int matched = 0;
+
+	do {
+		if(dev->fd == -1 || !evdev_fetch(L, 2, dev, &evt)) {
+			return 0;
+		}
+		if(evt.type >= EV_CNT) {
+			continue;
+		}
+
+		int exact = 0;
+		if(disp->byCode[evt.type] != NULL && evt.code < event_codeCount(evt.type)) {
+			exact = disp->byCode[evt.type][evt.code];
+		}
+		int wildcard = disp->byType[evt.type];
+
+		if(exact || wildcard || disp->any) {
+			matched++;
+			if(exact) {
+				dispatcher_call(L, disp, handlers, exact, &evt, 2);
+			}
+			if(wildcard) {
+				dispatcher_call(L, disp, handlers, wildcard, &evt, 2);
+			}
+			if(disp->any) {
+				dispatcher_call(L, disp, handlers, disp->any, &evt, 2);
+			}
+		}
+	} while(!(evt.type == EV_SYN && !evdev_readable(dev->fd)) || evdev_pendingEvents(dev) > 0);
+
+	lua_pushinteger(L, matched);
+	return 1;
+}
+
+/* profile(true/false) toggles timing; profile() returns per-handler stats */
+static int dispatcher_profile(lua_State *L) {
+	struct dispatcher *disp = luaL_checkudata(L, 1, DISPATCHER_USERDATA);
+
+	if(!lua_isnone(L, 2)) {
+		disp->profiling = lua_toboolean(L, 2);
+		return 0;
+	}
+
+	lua_createtable(L, disp->slotCount, 0);
+	int i;
+	for(i = 0; i < disp->slotCount; i++) {
+		struct handlerSlot *slot = &disp->slots[i];
+		lua_createtable(L, 0, 4);
+		if(slot->type >= 0) {
+			lua_pushinteger(L, slot->type);
+			lua_setfield(L, -2, "type");
+		}
+		if(slot->code >= 0) {
+			lua_pushinteger(L, slot->code);
+			lua_setfield(L, -2, "code");
+		}
+		lua_pushinteger(L, slot->calls);
+		lua_setfield(L, -2, "calls");
+		lua_pushnumber(L, slot->ns / 1e9);
+		lua_setfield(L, -2, "seconds");
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+static int dispatcher_gc(lua_State *L) {
+	struct dispatcher *disp = luaL_checkudata(L, 1, DISPATCHER_USERDATA);
+	int type;
+
+	for(type = 0; type < EV_CNT; type++) {
+		free(disp->byCode[type]);
+		disp->byCode[type] = NULL;
+	}
+	free(disp->slots);
+	disp->slots = NULL;
+	disp->slotCount = disp->slotCap = 0;
+
+	return 0;
+}
+
+/* Recordings
+ * 
+ * A compact on-disk format for captured events. After an 8-byte magic,
+ * events are grouped into blocks that end on a SYN_REPORT once they pass
+ * RECORD_BLOCK_SIZE bytes of payload. Each block has a 16-byte header
+ * (first timestamp in microseconds, event count, payload length) and
+ * encodes every event as: zigzag varint timestamp delta, type byte,
+ * zigzag varint code delta, zigzag varint value. Closing the recorder
+ * appends an index of (offset, first, last timestamp) per block and a
+ * footer pointing at it; a recording that was never closed is still
+ * readable by scanning its blocks. All integers are little-endian. */
+
+#define RECORDER_USERDATA "us.tropi.evdev.struct.recorder"
+#define REPLAY_USERDATA "us.tropi.evdev.struct.replay"
+
+#define RECORD_MAGIC "EVDREC01"
+#define RECORD_INDEX_MAGIC "EVDIDX01"
+#define RECORD_HEADER_SIZE 8
+#define RECORD_BLOCK_HEADER_SIZE 16
+#define RECORD_INDEX_ENTRY_SIZE 24
+#define RECORD_FOOTER_SIZE 24
+#define RECORD_BLOCK_SIZE 4096
+/* a block is cut mid-frame only if a frame never ends */
+#define RECORD_BLOCK_MAX 65536
+#define RECORD_EVENT_MAX 32
+
+static void put_u32(uint8_t *out, uint32_t value) {
+	int i;
+	for(i = 0; i < 4; i++) {
+		out[i] = value >> (8 * i);
+	}
+}
+
+static void put_u64(uint8_t *out, uint64_t value) {
+	int i;
+	for(i = 0; i < 8; i++) {
+		out[i] = value >> (8 * i);
+	}
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+	uint32_t value = 0;
+	int i;
+	for(i = 3; i >= 0; i--) {
+		value = value << 8 | in[i];
+	}
+	return value;
+}
+
+static uint64_t get_u64(const uint8_t *in) {
+	uint64_t value = 0;
+	int i;
+	for(i = 7; i >= 0; i--) {
+		value = value << 8 | in[i];
+	}
+	return value;
+}
+
+static int put_varint(uint8_t *out, int64_t signedValue) {
+	uint64_t value = ((uint64_t) signedValue << 1) ^ (uint64_t) (signedValue >> 63);
+	int len = 0;
+
+	while(value >= 0x80) {
+		out[len++] = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	out[len++] = value;
+
+	return len;
+}
+
+/* returns NULL if the varint runs past end */
+static const uint8_t *get_varint(const uint8_t *in, const uint8_t *end, int64_t *out) {
+	uint64_t value = 0;
+	int shift;
+
+	for(shift = 0; in < end && shift < 64; shift += 7) {
+		uint8_t byte = *in++;
+		value |= (uint64_t) (byte & 0x7f) << shift;
+		if(!(byte & 0x80)) {
+			*out = (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+			return in;
+		}
+	}
+
+	return NULL;
+}
+
+static int write_all(int fd, const uint8_t *buf, size_t len) {
+	while(len > 0) {
+		ssize_t count = write(fd, buf, len);
+		if(count < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		buf += count;
+		len -= count;
+	}
+	return 0;
+}
+
+struct recordBlock {
+	uint64_t offset;
+	int64_t first, last; // microseconds
+};
+
+struct recorder {
+	int fd;
+	uint64_t offset; // file position of the block being built
+
+	uint8_t block[RECORD_BLOCK_MAX + RECORD_EVENT_MAX];
+	size_t blockLen;
+	uint32_t blockEvents;
+	int64_t first, last;
+	int prevCode;
+
+	int unindexed; // skip the index, for writers that can't allocate
+	struct recordBlock *index;
+	size_t indexCount, indexCap;
+
+	int failed; // errno of the first failed write; nothing is written after
+};
+
+static int recorder_flushBlock(struct recorder *rec) {
+	uint8_t header[RECORD_BLOCK_HEADER_SIZE];
+
+	if(rec->failed) {
+		errno = rec->failed;
+		return -1;
+	}
+	if(rec->blockEvents == 0) {
+		return 0;
+	}
+
+	if(!rec->unindexed && rec->indexCount == rec->indexCap) {
+		size_t cap = rec->indexCap ? rec->indexCap * 2 : 64;
+		struct recordBlock *index = realloc(rec->index, cap * sizeof(struct recordBlock));
+		if(index == NULL) {
+			/* carry on without the footer; replays rebuild the index */
+			free(rec->index);
+			rec->index = NULL;
+			rec->indexCount = rec->indexCap = 0;
+			rec->unindexed = 1;
+		} else {
+			rec->index = index;
+			rec->indexCap = cap;
+		}
+	}
+
+	put_u64(header, rec->first);
+	put_u32(header + 8, rec->blockEvents);
+	put_u32(header + 12, rec->blockLen);
+
+	if(write_all(rec->fd, header, sizeof(header)) < 0
+		|| write_all(rec->fd, rec->block, rec->blockLen) < 0) {
+		/* the file may end in a partial block now, which replays skip;
+		 * writing on could only bury it mid-file */
+		rec->failed = errno;
+		rec->blockLen = 0;
+		rec->blockEvents = 0;
+		return -1;
+	}
+
+	if(!rec->unindexed) {
+		struct recordBlock *entry = &rec->index[rec->indexCount++];
+		entry->offset = rec->offset;
+		entry->first = rec->first;
+		entry->last = rec->last;
+	}
+
+	rec->offset += sizeof(header) + rec->blockLen;
+	rec->blockLen = 0;
+	rec->blockEvents = 0;
+
+	return 0;
+}
+
+static int recorder_finish(struct recorder *rec) {
+	uint8_t entry[RECORD_INDEX_ENTRY_SIZE];
+	uint8_t footer[RECORD_FOOTER_SIZE];
+	size_t i;
+
+	if(recorder_flushBlock(rec) < 0) {
+		return -1;
+	}
+	if(rec->unindexed) {
+		return 0;
+	}
+
+	for(i = 0; i < rec->indexCount; i++) {
+		put_u64(entry, rec->index[i].offset);
+		put_u64(entry + 8, rec->index[i].first);
+		put_u64(entry + 16, rec->index[i].last);
+		if(write_all(rec->fd, entry, sizeof(entry)) < 0) {
+			rec->failed = errno;
+			return -1;
+		}
+	}
+
+	put_u64(footer, rec->offset);
+	put_u64(footer + 8, rec->indexCount);
+	memcpy(footer + 16, RECORD_INDEX_MAGIC, 8);
+
+	return write_all(rec->fd, footer, sizeof(footer));
+}
+
+static int recorder_begin(struct recorder *rec) {
+	rec->offset = RECORD_HEADER_SIZE;
+	return write_all(rec->fd, (const uint8_t *) RECORD_MAGIC, RECORD_HEADER_SIZE);
+}
+
+/* append an event, timestamped in microseconds */
+static int recorder_add(struct recorder *rec, int64_t time, int type, int code, int value) {
+	if(rec->failed) {
+		errno = rec->failed;
+		return -1;
+	}
+	if(rec->blockEvents == 0) {
+		rec->first = rec->last = time;
+		rec->prevCode = 0;
+	}
+
+	uint8_t *out = rec->block + rec->blockLen;
+	out += put_varint(out, time - rec->last);
+	*out++ = type;
+	out += put_varint(out, code - rec->prevCode);
+	out += put_varint(out, value);
+
+	rec->blockLen = out - rec->block;
+	rec->blockEvents++;
+	rec->last = time;
+	rec->prevCode = code;
+
+	if((rec->blockLen >= RECORD_BLOCK_SIZE && type == EV_SYN && code == SYN_REPORT)
+		|| rec->blockLen >= RECORD_BLOCK_MAX) {
+		return recorder_flushBlock(rec);
+	}
+
+	return 0;
+}
+
+static int recorder_open(lua_State *L) {
+	const char *path = luaL_checkstring(L, 1);
+
+	struct recorder *rec = lua_newuserdata(L, sizeof(struct recorder));
+	memset(rec, 0, sizeof(struct recorder));
+	rec->fd = -1;
+	luaL_setmetatable(L, RECORDER_USERDATA);
+
+	rec->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(rec->fd < 0) {
+		return luaL_error(L, "Couldn't open %s for recording: %s", path, strerror(errno));
+	}
+
+	if(recorder_begin(rec) < 0) {
+		return luaL_error(L, "Couldn't write recording header: %s", strerror(errno));
+	}
+
+	return 1;
+}
+
+#define CHECK_RECORDER(rec, index) \
+struct recorder *rec = luaL_checkudata(L, index, RECORDER_USERDATA); \
+if(rec->fd == -1) { \
+	return luaL_error(L, "Trying to use closed recorder."); \
+}
+
+/* write(timestamp, type, code, value); takes a Device:read() result as-is */
+static int recorder_write(lua_State *L) {
+	CHECK_RECORDER(rec, 1);
+	int64_t time = llround(luaL_checknumber(L, 2) * 1e6);
+	int type = luaL_checkinteger(L, 3);
+	int code = luaL_checkinteger(L, 4);
+	int value = luaL_checkinteger(L, 5);
+
+	luaL_argcheck(L, type >= 0 && type <= 0xff, 3, "event type out of range");
+	luaL_argcheck(L, code >= 0 && code <= 0xffff, 4, "event code out of range");
+
+	if(recorder_add(rec, time, type, code, value) < 0) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(errno));
+		return 2;
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+/* write out the last block and the index; true, or false and an error */
+static int recorder_close(lua_State *L) {
+	struct recorder *rec = luaL_checkudata(L, 1, RECORDER_USERDATA);
+	int result = 0;
+	int err = 0;
+
+	if(rec->fd != -1) {
+		result = recorder_finish(rec);
+		err = errno;
+		if(close(rec->fd) < 0 && result == 0) {
+			result = -1;
+			err = errno;
+		}
+		rec->fd = -1;
+	}
+
+	free(rec->index);
+	rec->index = NULL;
+	rec->indexCount = rec->indexCap = 0;
+
+	if(result < 0) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(err));
+		return 2;
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+/* Replays map the whole recording and decode one event at a time; seek()
+ * binary-searches the block index, so nothing before the start of the
+ * requested range is decoded beyond its block. */
+
+struct replay {
+	const uint8_t *map;
+	size_t size;
+
+	struct recordBlock *index;
+	size_t blockCount;
+
+	size_t block; // next block to enter
+	const uint8_t *pos, *end; // within the current block
+	uint32_t remaining;
+	int64_t time;
+	int prevCode;
+
+	int64_t until; // stop after this time, if limited
+	int limited;
+	int held; // an event read by seek() waits in `next`
+	struct input_event next;
+};
+
+#define CHECK_REPLAY(replay, index) \
+struct replay *replay = luaL_checkudata(L, index, REPLAY_USERDATA); \
+if(replay->map == NULL) { \
+	return luaL_error(L, "Trying to use closed replay."); \
+}
+
+static int replay_validBlock(struct replay *replay, uint64_t offset) {
+	return offset >= RECORD_HEADER_SIZE
+		&& replay->size >= RECORD_BLOCK_HEADER_SIZE
+		&& offset <= replay->size - RECORD_BLOCK_HEADER_SIZE
+		&& get_u32(replay->map + offset + 12) <= replay->size - offset - RECORD_BLOCK_HEADER_SIZE;
+}
+
+/* take the index from the footer, or rebuild it for an unfinished file */
+static int replay_loadIndex(struct replay *replay) {
+	const uint8_t *footer = replay->map + replay->size - RECORD_FOOTER_SIZE;
+	size_t i;
+
+	if(replay->size >= RECORD_HEADER_SIZE + RECORD_FOOTER_SIZE
+		&& memcmp(footer + 16, RECORD_INDEX_MAGIC, 8) == 0) {
+		uint64_t indexOffset = get_u64(footer);
+		uint64_t count = get_u64(footer + 8);
+
+		if(indexOffset > replay->size - RECORD_FOOTER_SIZE
+			|| count != (replay->size - RECORD_FOOTER_SIZE - indexOffset) / RECORD_INDEX_ENTRY_SIZE) {
+			return -1;
+		}
+
+		replay->index = malloc((count ? count : 1) * sizeof(struct recordBlock));
+		if(replay->index == NULL) {
+			return -1;
+		}
+		for(i = 0; i < count; i++) {
+			const uint8_t *entry = replay->map + indexOffset + i * RECORD_INDEX_ENTRY_SIZE;
+			replay->index[i].offset = get_u64(entry);
+			replay->index[i].first = get_u64(entry + 8);
+			replay->index[i].last = get_u64(entry + 16);
+			if(!replay_validBlock(replay, replay->index[i].offset)) {
+				return -1;
+			}
+		}
+		replay->blockCount = count;
+		return 0;
+	}
+
+	/* no footer: walk the blocks, keeping those that are complete;
+	 * last times are unknown, so use the next block's first */
+	uint64_t offset = RECORD_HEADER_SIZE;
+	size_t cap = 0;
+	while(replay_validBlock(replay, offset)) {
+		if(replay->blockCount == cap) {
+			cap = cap ? cap * 2 : 64;
+			struct recordBlock *index = realloc(replay->index, cap * sizeof(struct recordBlock));
+			if(index == NULL) {
+				return -1;
+			}
+			replay->index = index;
+		}
+		struct recordBlock *entry = &replay->index[replay->blockCount++];
+		entry->offset = offset;
+		entry->first = get_u64(replay->map + offset);
+		entry->last = INT64_MAX;
+		if(replay->blockCount > 1) {
+			entry[-1].last = entry->first;
+		}
+		offset += RECORD_BLOCK_HEADER_SIZE + get_u32(replay->map + offset + 12);
+	}
+
+	return 0;
+}
+
+static int replay_open(lua_State *L) {
+	const char *path = luaL_checkstring(L, 1);
+
+	struct replay *replay = lua_newuserdata(L, sizeof(struct replay));
+	memset(replay, 0, sizeof(struct replay));
+	luaL_setmetatable(L, REPLAY_USERDATA);
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0) {
+		return luaL_error(L, "Couldn't open recording %s: %s", path, strerror(errno));
+	}
+
+	struct stat info;
+	if(fstat(fd, &info) < 0 || info.st_size < RECORD_HEADER_SIZE) {
+		close(fd);
+		return luaL_error(L, "%s is not a recording.", path);
+	}
+
+	void *map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) {
+		return luaL_error(L, "Couldn't map recording %s: %s", path, strerror(errno));
+	}
+	replay->map = map;
+	replay->size = info.st_size;
+
+	if(memcmp(replay->map, RECORD_MAGIC, RECORD_HEADER_SIZE) != 0
+		|| replay_loadIndex(replay) < 0) {
+		/* the mapping is released when the userdata is collected */
+		return luaL_error(L, "%s is not a valid recording.", path);
+	}
+
+	madvise(map, info.st_size, MADV_SEQUENTIAL);
+
+	return 1;
+}
+
+static void replay_enter(struct replay *replay, size_t block) {
+	const uint8_t *header = replay->map + replay->index[block].offset;
+
+	replay->block = block + 1;
+	replay->time = get_u64(header);
+	replay->remaining = get_u32(header + 8);
+	replay->pos = header + RECORD_BLOCK_HEADER_SIZE;
+	replay->end = replay->pos + get_u32(header + 12);
+	replay->prevCode = 0;
+}
+
+/* decode the next event; returns 0 at the end, -1 if corrupt */
+static int replay_decode(struct replay *replay, struct input_event *evt) {
+	int64_t delta, code, value;
+
+	while(replay->remaining == 0) {
+		if(replay->block >= replay->blockCount) {
+			return 0;
+		}
+		replay_enter(replay, replay->block);
+	}
+
+	const uint8_t *pos = get_varint(replay->pos, replay->end, &delta);
+	if(pos == NULL || pos >= replay->end) {
+		return -1;
+	}
+	int type = *pos++;
+	pos = get_varint(pos, replay->end, &code);
+	if(pos == NULL) {
+		return -1;
+	}
+	pos = get_varint(pos, replay->end, &value);
+	if(pos == NULL) {
+		return -1;
+	}
+
+	replay->pos = pos;
+	replay->remaining--;
+	replay->time += delta;
+	replay->prevCode += code;
+
+	memset(evt, 0, sizeof(struct input_event));
+	evt->time.tv_sec = replay->time / 1000000;
+	evt->time.tv_usec = replay->time % 1000000;
+	evt->type = type;
+	evt->code = replay->prevCode;
+	evt->value = value;
+
+	return 1;
+}
+
+static int replay_fetch(lua_State *L, struct replay *replay, struct input_event *evt) {
+	if(replay->held) {
+		replay->held = 0;
+		*evt = replay->next;
+	} else {
+		int result = replay_decode(replay, evt);
+		if(result < 0) {
+			return luaL_error(L, "Corrupt recording.");
+		} else if(result == 0) {
+			return 0;
+		}
+	}
+
+	if(replay->limited && replay->time > replay->until) {
+		/* stay put, so a later seek() can widen the range */
+		replay->next = *evt;
+		replay->held = 1;
+		return 0;
+	}
+
+	return 1;
+}
+
+static int replay_tryRead(lua_State *L) {
+	CHECK_REPLAY(replay, 1);
+
+	struct input_event evt;
+
+	if(!replay_fetch(L, replay, &evt)) {
+		return 0;
+	}
+
+	lua_pushnumber(L, evdev_timestamp(&evt));
+	lua_pushinteger(L, evt.type);
+	lua_pushinteger(L, evt.code);
+	lua_pushinteger(L, evt.value);
+
+	return 4;
+}
+
+static int replay_read(lua_State *L) {
+	int count = replay_tryRead(L);
+
+	if(count == 0) {
+		return luaL_error(L, "End of input event stream.");
+	}
+
+	return count;
+}
+
+/* seek(from[, to]) - continue from the first event at or after `from`,
+ * and report the end of the stream after `to` */
+static int replay_seek(lua_State *L) {
+	CHECK_REPLAY(replay, 1);
+	int64_t from = llround(luaL_optnumber(L, 2, 0) * 1e6);
+
+	replay->limited = !lua_isnoneornil(L, 3);
+	if(replay->limited) {
+		replay->until = llround(luaL_checknumber(L, 3) * 1e6);
+	}
+
+	/* first block that could contain `from` */
+	size_t low = 0, high = replay->blockCount;
+	while(low < high) {
+		size_t mid = low + (high - low) / 2;
+		if(replay->index[mid].last < from) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	replay->held = 0;
+	replay->remaining = 0;
+	replay->block = low;
+
+	struct input_event evt;
+	int result;
+	while((result = replay_decode(replay, &evt)) > 0) {
+		if(replay->time >= from) {
+			replay->next = evt;
+			replay->held = 1;
+			break;
+		}
+	}
+	if(result < 0) {
+		return luaL_error(L, "Corrupt recording.");
+	}
+
+	return 0;
+}
+
+/* timeRange() - timestamps of the first and last recorded events */
+static int replay_timeRange(lua_State *L) {
+	CHECK_REPLAY(replay, 1);
+
+	if(replay->blockCount == 0) {
+		return 0;
+	}
+
+	struct recordBlock *last = &replay->index[replay->blockCount - 1];
+	int64_t lastTime = last->last;
+
+	if(lastTime == INT64_MAX) {
+		/* unfinished recording; decode the final block to find out */
+		struct replay scan = *replay;
+		struct input_event evt;
+		scan.remaining = 0;
+		scan.block = replay->blockCount - 1;
+		while(replay_decode(&scan, &evt) > 0);
+		lastTime = scan.time;
+	}
+
+	lua_pushnumber(L, replay->index[0].first / 1e6);
+	lua_pushnumber(L, lastTime / 1e6);
+	return 2;
+}
+
+static int replay_gc(lua_State *L) {
+	struct replay *replay = luaL_checkudata(L, 1, REPLAY_USERDATA);
+
+	if(replay->map != NULL) {
+		munmap((void *) replay->map, replay->size);
+		replay->map = NULL;
+	}
+	free(replay->index);
+	replay->index = NULL;
+	replay->blockCount = 0;
+
+	return 0;
+}
+
+/* Flight recorder dumps
+ * 
+ * Rings are written oldest first as recordings, so they can be replayed.
+ * The signal handler does the same with only async-signal-safe calls:
+ * a static recorder that skips the index, and hand-built file names. */
+
+static int flight_dump(struct flightRing *ring, struct recorder *rec) {
+	size_t start = (ring->head + ring->cap - ring->count) % ring->cap;
+	size_t i;
+
+	if(recorder_begin(rec) < 0) {
+		return -1;
+	}
+
+	for(i = 0; i < ring->count; i++) {
+		const struct input_event *evt = &ring->events[(start + i) % ring->cap];
+		int64_t time = (int64_t) evt->time.tv_sec * 1000000 + evt->time.tv_usec;
+		if(recorder_add(rec, time, evt->type, evt->code, evt->value) < 0) {
+			return -1;
+		}
+	}
+
+	return recorder_finish(rec);
+}
+
+static char flightDirectory[PATH_MAX];
+static struct recorder flightSignalRecorder;
+
+static size_t flight_appendString(char *buf, size_t len, const char *str) {
+	while(*str && len < PATH_MAX + 63) {
+		buf[len++] = *str++;
+	}
+	buf[len] = '\0';
+	return len;
+}
+
+static size_t flight_appendNumber(char *buf, size_t len, unsigned long number) {
+	char digits[24];
+	int count = 0;
+
+	do {
+		digits[count++] = '0' + number % 10;
+		number /= 10;
+	} while(number > 0);
+
+	while(count > 0 && len < PATH_MAX + 63) {
+		buf[len++] = digits[--count];
+	}
+	buf[len] = '\0';
+	return len;
+}
+
+/* dumps every ring to <directory>/flight-<pid>-<fd>.evr */
+static void flight_signal(int sig) {
+	static char path[PATH_MAX + 64];
+	int savedErrno = errno;
+	struct flightRing *ring;
+
+	(void) sig;
+
+	for(ring = flightRings; ring != NULL; ring = ring->next) {
+		size_t len = flight_appendString(path, 0, flightDirectory);
+		len = flight_appendString(path, len, "/flight-");
+		len = flight_appendNumber(path, len, getpid());
+		len = flight_appendString(path, len, "-");
+		len = flight_appendNumber(path, len, ring->id);
+		flight_appendString(path, len, ".evr");
+
+		int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if(fd < 0) {
+			continue;
+		}
+
+		memset(&flightSignalRecorder, 0, sizeof(struct recorder));
+		flightSignalRecorder.fd = fd;
+		flightSignalRecorder.unindexed = 1;
+		flight_dump(ring, &flightSignalRecorder);
+		close(fd);
+	}
+
+	errno = savedErrno;
+}
+
+/* flightRecorder(count) keeps the last `count` raw events; nil or 0 stops */
+static int evdev_flightRecorder(lua_State *L) {
+	CHECK_EVDEV(dev, 1);
+	lua_Integer count = luaL_optinteger(L, 2, 0);
+
+	luaL_argcheck(L, count >= 0, 2, "count must not be negative");
+
+	flight_free(dev->flight);
+	dev->flight = NULL;
+
+	if(count > 0) {
+		dev->flight = flight_new(count, dev->fd);
+		if(dev->flight == NULL) {
+			return luaL_error(L, "Out of memory allocating flight recorder.");
+		}
+	}
+
+	return 0;
+}
+
+/* dumpFlight(path) writes the ring as a recording; true or false, error */
+static int evdev_dumpFlight(lua_State *L) {
+	struct inputDevice *dev = luaL_checkudata(L, 1, EVDEV_USERDATA);
+	const char *path = luaL_checkstring(L, 2);
+
+	if(dev->flight == NULL) {
+		return luaL_error(L, "Device has no flight recorder.");
+	}
+
+	struct recorder *rec = calloc(1, sizeof(struct recorder));
+	if(rec == NULL) {
+		return luaL_error(L, "Out of memory dumping flight recorder.");
+	}
+
+	int result = -1;
+	rec->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(rec->fd >= 0) {
+		result = flight_dump(dev->flight, rec);
+		int err = errno;
+		if(close(rec->fd) < 0 && result == 0) {
+			result = -1;
+		} else {
+			errno = err;
+		}
+	}
+	free(rec->index);
+	free(rec);
+
+	if(result < 0) {
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(errno));
+		return 2;
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static const char *const flight_signalNames[] = { "SIGUSR1", "SIGUSR2", "SIGHUP", "SIGQUIT", NULL };
+static const int flight_signals[] = { SIGUSR1, SIGUSR2, SIGHUP, SIGQUIT };
+
+/* flightSignal(signal, directory) dumps every flight recorder on `signal`,
+ * given by number or name */
+static int evdev_flightSignal(lua_State *L) {
+	int sig = lua_type(L, 1) == LUA_TSTRING
+		? flight_signals[luaL_checkoption(L, 1, NULL, flight_signalNames)]
+		: (int) luaL_checkinteger(L, 1);
+	size_t len;
+	const char *directory = luaL_checklstring(L, 2, &len);
+
+	luaL_argcheck(L, len < sizeof(flightDirectory), 2, "directory name too long");
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = &flight_signal;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+
+	sigset_t saved;
+	flight_blockSignals(&saved);
+	memcpy(flightDirectory, directory, len + 1);
+	int result = sigaction(sig, &action, NULL);
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+
+	if(result < 0) {
+		return luaL_error(L, "Couldn't handle signal %d: %s", sig, strerror(errno));
+	}
+
+	return 0;
+}
+
+/* Metrics
+ * 
+ * Renders the counters of every live Device and Uinput in the
+ * Prometheus text exposition format. */
+
+static const char *const metrics_typeNames[EV_CNT] = {
+	[EV_SYN] = "EV_SYN", [EV_KEY] = "EV_KEY", [EV_REL] = "EV_REL",
+	[EV_ABS] = "EV_ABS", [EV_MSC] = "EV_MSC", [EV_SW] = "EV_SW",
+	[EV_LED] = "EV_LED", [EV_SND] = "EV_SND", [EV_REP] = "EV_REP",
+	[EV_FF] = "EV_FF", [EV_PWR] = "EV_PWR", [EV_FF_STATUS] = "EV_FF_STATUS",
+};
+
+static void metrics_addEscaped(luaL_Buffer *buf, const char *str) {
+	for(; *str; str++) {
+		if(*str == '\\' || *str == '"') {
+			luaL_addchar(buf, '\\');
+			luaL_addchar(buf, *str);
+		} else if(*str == '\n') {
+			luaL_addstring(buf, "\\n");
+		} else {
+			luaL_addchar(buf, *str);
+		}
+	}
+}
+
+/* one sample line; `extra` is an additional label pair or NULL */
+static void metrics_sample(luaL_Buffer *buf, const char *metric, struct ioStats *stats, const char *extra, uint64_t value) {
+	char number[32];
+
+	luaL_addstring(buf, metric);
+	luaL_addstring(buf, "{kind=\"");
+	luaL_addstring(buf, stats->kind);
+	luaL_addstring(buf, "\",path=\"");
+	metrics_addEscaped(buf, stats->path ? stats->path : "");
+	luaL_addstring(buf, "\",name=\"");
+	metrics_addEscaped(buf, stats->name);
+	luaL_addchar(buf, '"');
+	if(extra != NULL) {
+		luaL_addchar(buf, ',');
+		luaL_addstring(buf, extra);
+	}
+	snprintf(number, sizeof(number), "} %llu\n", (unsigned long long) value);
+	luaL_addstring(buf, number);
+}
+
+static void metrics_header(luaL_Buffer *buf, const char *metric, const char *type, const char *help) {
+	luaL_addstring(buf, "# HELP ");
+	luaL_addstring(buf, metric);
+	luaL_addchar(buf, ' ');
+	luaL_addstring(buf, help);
+	luaL_addstring(buf, "\n# TYPE ");
+	luaL_addstring(buf, metric);
+	luaL_addchar(buf, ' ');
+	luaL_addstring(buf, type);
+	luaL_addchar(buf, '\n');
+}
+
+#define METRICS_COUNTER(metric, field, help) \
+	metrics_header(&buf, metric, "counter", help); \
+	for(stats = liveStats; stats != NULL; stats = stats->next) { \
+		metrics_sample(&buf, metric, stats, NULL, stats->field); \
+	}
+
+/* metrics([path]) returns the text, or writes it to `path` atomically */
+static int evdev_metrics(lua_State *L) {
+	const char *path = luaL_optstring(L, 1, NULL);
+	struct ioStats *stats;
+	luaL_Buffer buf;
+	char label[32];
+	int type;
+
+	lua_settop(L, 1);
+	luaL_buffinit(L, &buf);
+
+	metrics_header(&buf, "evdev_events_total", "counter", "Input events read from a device or written to uinput.");
+	for(stats = liveStats; stats != NULL; stats = stats->next) {
+		for(type = 0; type < EV_CNT; type++) {
+			if(stats->events[type]) {
+				if(metrics_typeNames[type] != NULL) {
+					snprintf(label, sizeof(label), "type=\"%s\"", metrics_typeNames[type]);
+				} else {
+					snprintf(label, sizeof(label), "type=\"%d\"", type);
+				}
+				metrics_sample(&buf, "evdev_events_total", stats, label, stats->events[type]);
+			}
+		}
+	}
+
+	METRICS_COUNTER("evdev_bytes_total", bytes, "Bytes read or written.")
+	METRICS_COUNTER("evdev_syscalls_total", syscalls, "read() and write() calls made.")
+	METRICS_COUNTER("evdev_syn_dropped_total", synDropped, "SYN_DROPPED events; the kernel buffer overflowed.")
+	METRICS_COUNTER("evdev_short_reads_total", shortReads, "Reads returning a partial event.")
+
+	metrics_header(&buf, "evdev_write_errors_total", "counter", "Failed writes, by error.");
+	for(stats = liveStats; stats != NULL; stats = stats->next) {
+		metrics_sample(&buf, "evdev_write_errors_total", stats, "error=\"EAGAIN\"", stats->writeAgain);
+		metrics_sample(&buf, "evdev_write_errors_total", stats, "error=\"EIO\"", stats->writeIO);
+		metrics_sample(&buf, "evdev_write_errors_total", stats, "error=\"other\"", stats->writeFailed);
+	}
+
+	metrics_header(&buf, "evdev_grabbed", "gauge", "1 if the device is grabbed.");
+	for(stats = liveStats; stats != NULL; stats = stats->next) {
+		if(stats->grabbed != NULL) {
+			metrics_sample(&buf, "evdev_grabbed", stats, NULL, *stats->grabbed != 0);
+		}
+	}
+
+	luaL_pushresult(&buf);
+
+	if(path == NULL) {
+		return 1;
+	}
+
+	/* write beside the target and rename, so scrapers never see half */
+	size_t len;
+	const char *text = lua_tolstring(L, -1, &len);
+	const char *tmpPath = lua_pushfstring(L, "%s.%d.tmp", path, (int) getpid());
+
+	int fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	int result = fd < 0 ? -1 : write_all(fd, (const uint8_t *) text, len);
+	int err = errno;
+	if(fd >= 0 && close(fd) < 0 && result == 0) {
+		result = -1;
+		err = errno;
+	}
+	if(result == 0 && rename(tmpPath, path) < 0) {
+		result = -1;
+		err = errno;
+	}
+
+	if(result < 0) {
+		if(fd >= 0) {
+			unlink(tmpPath);
+		}
+		lua_pushboolean(L, 0);
+		lua_pushstring(L, strerror(err));
+		return 2;
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+#undef METRICS_COUNTER
+
+/* Merging
+ * 
+ * A Merge interleaves events from several Devices or Replays in kernel
+ * timestamp order. Everything a source has ready is moved into a binary
+ * heap keyed on (timestamp, arrival order); the earliest event is only
+ * released once every other live source has something buffered to
+ * compare it with, or once it has waited out the reorder window. Replays
+ * always have their next event buffered, so they never hold things up.
+ * Sources live in the uservalue table, indexed like `sources`. */
+
+#define MERGE_USERDATA "us.tropi.evdev.struct.merge"
+
+struct mergeEntry {
+	struct input_event evt;
+	int64_t time; // microseconds
+	uint64_t seq; // arrival order, keeping each source's own order
+	uint64_t arrival; // CLOCK_MONOTONIC nanoseconds
+	int source;
+};
+
+struct mergeSource {
+	struct inputDevice *dev; // exactly one of dev, replay is set
+	struct replay *replay;
+	size_t buffered;
+	int eof;
+};
+
+struct merge {
+	uint64_t window; // nanoseconds
+	struct mergeSource *sources;
+	int sourceCount, sourceCap;
+	struct mergeEntry *heap;
+	size_t heapCount, heapCap;
+	uint64_t seq;
+	int flushing;
+};
+
+static int merge_before(const struct mergeEntry *a, const struct mergeEntry *b) {
+	return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+static int merge_push(struct merge *merge, const struct input_event *evt, int source) {
+	if(merge->heapCount == merge->heapCap) {
+		size_t cap = merge->heapCap ? merge->heapCap * 2 : 64;
+		struct mergeEntry *heap = realloc(merge->heap, cap * sizeof(struct mergeEntry));
+		if(heap == NULL) {
+			return -1;
+		}
+		merge->heap = heap;
+		merge->heapCap = cap;
+	}
+
+	struct mergeEntry entry;
+	entry.evt = *evt;
+	entry.time = (int64_t) evt->time.tv_sec * 1000000 + evt->time.tv_usec;
+	entry.seq = merge->seq++;
+	entry.arrival = monotonic_ns();
+	entry.source = source;
+
+	/* sift up */
+	size_t i = merge->heapCount++;
+	while(i > 0) {
+		size_t parent = (i - 1) / 2;
+		if(!merge_before(&entry, &merge->heap[parent])) {
+			break;
+		}
+		merge->heap[i] = merge->heap[parent];
+		i = parent;
+	}
+	merge->heap[i] = entry;
+	merge->sources[source].buffered++;
+
+	return 0;
+}
+
+static void merge_pop(struct merge *merge, struct mergeEntry *out) {
+	*out = merge->heap[0];
+	merge->sources[out->source].buffered--;
+
+	struct mergeEntry last = merge->heap[--merge->heapCount];
+	size_t i = 0;
+
+	/* sift down */
+	for(;;) {
+		size_t child = 2 * i + 1;
+		if(child >= merge->heapCount) {
+			break;
+		}
+		if(child + 1 < merge->heapCount && merge_before(&merge->heap[child + 1], &merge->heap[child])) {
+			child++;
+		}
+		if(!merge_before(&merge->heap[child], &last)) {
+			break;
+		}
+		merge->heap[i] = merge->heap[child];
+		i = child;
+	}
+	if(merge->heapCount > 0) {
+		merge->heap[i] = last;
+	}
+}
+
+/* Merge([window]) - reorder window in seconds, default 10ms */
+static int merge_open(lua_State *L) {
+	double window = luaL_optnumber(L, 1, 0.01);
+
+	luaL_argcheck(L, window >= 0, 1, "window must not be negative");
+
+	struct merge *merge = lua_newuserdata(L, sizeof(struct merge));
+	memset(merge, 0, sizeof(struct merge));
+	merge->window = seconds_to_ns(window);
+	luaL_setmetatable(L, MERGE_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	return 1;
+}
+
+/* add(source) - returns the source's index, as read() reports it */
+static int merge_add(lua_State *L) {
+	struct merge *merge = luaL_checkudata(L, 1, MERGE_USERDATA);
+	struct inputDevice *dev = luaL_testudata(L, 2, EVDEV_USERDATA);
+	struct replay *replay = dev == NULL ? luaL_testudata(L, 2, REPLAY_USERDATA) : NULL;
+
+	luaL_argcheck(L, dev != NULL || replay != NULL, 2, "Device or Replay expected");
+
+	if(merge->sourceCount == merge->sourceCap) {
+		int cap = merge->sourceCap ? merge->sourceCap * 2 : 4;
+		struct mergeSource *sources = realloc(merge->sources, cap * sizeof(struct mergeSource));
+		if(sources == NULL) {
+			return luaL_error(L, "Out of memory adding merge source.");
+		}
+		merge->sources = sources;
+		merge->sourceCap = cap;
+	}
+
+	struct mergeSource *source = &merge->sources[merge->sourceCount++];
+	memset(source, 0, sizeof(struct mergeSource));
+	source->dev = dev;
+	source->replay = replay;
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, merge->sourceCount);
+
+	lua_pushinteger(L, merge->sourceCount);
+	return 1;
+}
+
+/* move whatever each source has ready into the heap; the uservalue
+ * table must be at stack index `sources` */
+static void merge_fill(lua_State *L, struct merge *merge, int sources) {
+	struct input_event evt;
+	int i;
+
+	for(i = 0; i < merge->sourceCount; i++) {
+		struct mergeSource *source = &merge->sources[i];
+		if(source->eof) {
+			continue;
+		}
+
+		if(source->replay != NULL) {
+			/* one lookahead is all a replay needs; at the end of its
+			 * range it is asked again next time, as seek() may have
+			 * moved it since */
+			if(source->replay->map == NULL) {
+				source->eof = 1;
+			} else if(source->buffered == 0 && replay_fetch(L, source->replay, &evt)) {
+				if(merge_push(merge, &evt, i) < 0) {
+					luaL_error(L, "Out of memory merging events.");
+				}
+			}
+			continue;
+		}
+
+		struct inputDevice *dev = source->dev;
+		if(dev->fd == -1) {
+			source->eof = 1;
+			continue;
+		}
+
+		lua_rawgeti(L, sources, i + 1);
+		int index = lua_gettop(L);
+		evdev_settleDue(dev);
+		while(dev->fd != -1 && (evdev_pendingEvents(dev) > 0 || evdev_readable(dev->fd))) {
+			if(!evdev_fetch(L, index, dev, &evt)) {
+				source->eof = 1;
+				break;
+			}
+			if(merge_push(merge, &evt, i) < 0) {
+				luaL_error(L, "Out of memory merging events.");
+			}
+		}
+		lua_pop(L, 1);
+	}
+}
+
+/* nanoseconds until the earliest event may be released; 0 if now,
+ * -1 if it can't be released until more arrives (an empty heap) */
+static int64_t merge_wait(struct merge *merge) {
+	int i;
+
+	if(merge->heapCount == 0) {
+		return -1;
+	}
+	if(merge->flushing) {
+		return 0;
+	}
+
+	const struct mergeEntry *top = &merge->heap[0];
+	for(i = 0; i < merge->sourceCount; i++) {
+		struct mergeSource *source = &merge->sources[i];
+		/* a replay with nothing buffered has nothing more to give */
+		if(i != top->source && !source->eof && source->dev != NULL && source->buffered == 0) {
+			uint64_t now = monotonic_ns();
+			uint64_t due = top->arrival + merge->window;
+			return due > now ? (int64_t) (due - now) : 0;
+		}
+	}
+
+	return 0;
+}
+
+/* returns 0 once every source is at EOF and the heap is empty */
+static int merge_next(lua_State *L, struct merge *merge, int block, struct mergeEntry *out) {
+	lua_getuservalue(L, 1);
+	int sources = lua_gettop(L);
+
+	for(;;) {
+		merge_fill(L, merge, sources);
+
+		int64_t wait = merge_wait(merge);
+		if(wait == 0) {
+			merge_pop(merge, out);
+			lua_pop(L, 1);
+			return 1;
+		}
+
+		/* wait on the devices that are still live, and for their
+		 * debounced transitions to settle */
+		struct pollfd pfds[merge->sourceCount > 0 ? merge->sourceCount : 1];
+		int count = 0, i;
+		for(i = 0; i < merge->sourceCount; i++) {
+			if(!merge->sources[i].eof && merge->sources[i].dev != NULL) {
+				int64_t settle = evdev_settleWait(merge->sources[i].dev);
+				if(settle >= 0 && (wait < 0 || settle < wait)) {
+					wait = settle;
+				}
+				pfds[count].fd = merge->sources[i].dev->fd;
+				pfds[count].events = POLLIN;
+				pfds[count].revents = 0;
+				count++;
+			}
+		}
+
+		if(count == 0 && merge->heapCount == 0) {
+			lua_pop(L, 1);
+			return 0;
+		}
+		if(!block) {
+			lua_pop(L, 1);
+			return -1;
+		}
+
+		int timeout = wait < 0 ? -1 : (int) ((wait + 999999) / 1000000);
+		if(poll(pfds, count, timeout) < 0 && errno != EINTR) {
+			return luaL_error(L, "Failure waiting on merge sources: %s", strerror(errno));
+		}
+	}
+}
+
+static int merge_pushResult(lua_State *L, struct mergeEntry *entry) {
+	lua_pushnumber(L, evdev_timestamp(&entry->evt));
+	lua_pushinteger(L, entry->evt.type);
+	lua_pushinteger(L, entry->evt.code);
+	lua_pushinteger(L, entry->evt.value);
+	lua_getuservalue(L, 1);
+	lua_rawgeti(L, -1, entry->source + 1);
+	lua_remove(L, -2);
+	lua_pushinteger(L, entry->source + 1);
+	return 6;
+}
+
+/* read() - the next event in timestamp order, followed by its source
+ * and the source's index; blocks until one can be released */
+static int merge_read(lua_State *L) {
+	struct merge *merge = luaL_checkudata(L, 1, MERGE_USERDATA);
+	struct mergeEntry entry;
+
+	if(merge_next(L, merge, 1, &entry) == 0) {
+		return luaL_error(L, "End of input event stream.");
+	}
+
+	return merge_pushResult(L, &entry);
+}
+
+/* tryRead() - like read(), but returns nil at the end of every source,
+ * and false if nothing can be released without blocking */
+static int merge_tryRead(lua_State *L) {
+	struct merge *merge = luaL_checkudata(L, 1, MERGE_USERDATA);
+	struct mergeEntry entry;
+
+	int result = merge_next(L, merge, 0, &entry);
+	if(result == 0) {
+		return 0;
+	} else if(result < 0) {
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+
+	return merge_pushResult(L, &entry);
+}
+
+/* flush([on]) - release buffered events without waiting for the other
+ * sources, as when shutting down; flush(false) goes back to merging */
+static int merge_flush(lua_State *L) {
+	struct merge *merge = luaL_checkudata(L, 1, MERGE_USERDATA);
+
+	merge->flushing = lua_isnone(L, 2) || lua_toboolean(L, 2);
+
+	return 0;
+}
+
+/* pending() - the number of events buffered for reordering */
+static int merge_pending(lua_State *L) {
+	struct merge *merge = luaL_checkudata(L, 1, MERGE_USERDATA);
+
+	lua_pushinteger(L, merge->heapCount);
+	return 1;
+}
+
+static int merge_gc(lua_State *L) {
+	struct merge *merge = luaL_checkudata(L, 1, MERGE_USERDATA);
+
+	free(merge->heap);
+	merge->heap = NULL;
+	merge->heapCount = merge->heapCap = 0;
+	free(merge->sources);
+	merge->sources = NULL;
+	merge->sourceCount = merge->sourceCap = 0;
+
+	return 0;
+}
+
+/* Pollers
+ * 
+ * A Poller is an epoll set over objects with a pollfd() method, such as
+ * Devices, Uinputs or Rings, for waiting on many of them without
+ * cqueues; evdev.run() uses one to resume coroutines. Objects are watched
+ * level-triggered. The uservalue table maps each watched fd to its object
+ * and each object back to its fd, so an object closed since it was added
+ * can still be removed. */
+
+#define POLLER_USERDATA "us.tropi.evdev.struct.poller"
+#define POLLER_MAX_EVENTS 64
+
+struct poller {
+	int epfd;
+	int count;
+};
+
+static int poller_open(lua_State *L) {
+	struct poller *poller = lua_newuserdata(L, sizeof(struct poller));
+	poller->count = 0;
+	poller->epfd = epoll_create1(EPOLL_CLOEXEC);
+	luaL_setmetatable(L, POLLER_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	if(poller->epfd < 0) {
+		return luaL_error(L, "Couldn't create poll set.");
+	}
+
+	return 1;
+}
+
+#define CHECK_POLLER(poller, index) \
+struct poller *poller = luaL_checkudata(L, index, POLLER_USERDATA); \
+if(poller->epfd == -1) { \
+	return luaL_error(L, "Trying to use closed poller."); \
+}
+
+/* the fd an object reports through its pollfd() method */
+static int poller_fd(lua_State *L, int index) {
+	luaL_checkany(L, index);
+	lua_getfield(L, index, "pollfd");
+	lua_pushvalue(L, index);
+	lua_call(L, 1, 1);
+	int isnum;
+	int fd = lua_tointegerx(L, -1, &isnum);
+	lua_pop(L, 1);
+	if(!isnum || fd < 0) {
+		return luaL_argerror(L, index, "pollfd() didn't return a file descriptor");
+	}
+	return fd;
+}
+
+/* stop watching the object at stack index `index`, if it's watched;
+ * `table` is the stack index of the uservalue table */
+static void poller_forget(struct poller *poller, lua_State *L, int table, int index) {
+	lua_pushvalue(L, index);
+	lua_rawget(L, table);
+	int isnum;
+	int fd = lua_tointegerx(L, -1, &isnum);
+	lua_pop(L, 1);
+	if(!isnum) {
+		return;
+	}
+
+	/* fails harmlessly if closing the fd already took it out */
+	epoll_ctl(poller->epfd, EPOLL_CTL_DEL, fd, NULL);
+	lua_pushvalue(L, index);
+	lua_pushnil(L);
+	lua_rawset(L, table);
+	lua_pushnil(L);
+	lua_rawseti(L, table, fd);
+	poller->count--;
+}
+
+/* add(object) - watch an object until removed; adding twice is harmless */
+static int poller_add(lua_State *L) {
+	CHECK_POLLER(poller, 1)
+	int fd = poller_fd(L, 2);
+
+	lua_settop(L, 2);
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawget(L, 3);
+	int watched = !lua_isnil(L, -1);
+	lua_pop(L, 1);
+	if(watched) {
+		return 0;
+	}
+
+	/* an object whose fd was closed and reused is gone */
+	lua_rawgeti(L, 3, fd);
+	if(!lua_isnil(L, -1)) {
+		poller_forget(poller, L, 3, 4);
+	}
+	lua_pop(L, 1);
+
+	struct epoll_event watch;
+	memset(&watch, 0, sizeof(watch));
+	watch.events = EPOLLIN;
+	watch.data.fd = fd;
+	if(epoll_ctl(poller->epfd, EPOLL_CTL_ADD, fd, &watch) < 0) {
+		return luaL_error(L, "Couldn't watch fd %d: %s", fd, strerror(errno));
+	}
+
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, fd);
+	lua_pushvalue(L, 2);
+	lua_pushinteger(L, fd);
+	lua_rawset(L, -3);
+	poller->count++;
+
+	return 0;
+}
+
+/* remove(object) - by the fd it was added with, so it may be closed */
+static int poller_remove(lua_State *L) {
+	CHECK_POLLER(poller, 1)
+	luaL_checkany(L, 2);
+
+	lua_settop(L, 2);
+	lua_getuservalue(L, 1);
+	poller_forget(poller, L, 3, 2);
+
+	return 0;
+}
+
+/* wait([timeout]) - block until a watched object is readable, or for at
+ * most `timeout` seconds; returns the readable objects */
+static int poller_wait(lua_State *L) {
+	CHECK_POLLER(poller, 1)
+	lua_Number timeout = luaL_optnumber(L, 2, -1);
+	struct epoll_event ready[POLLER_MAX_EVENTS];
+	int count, i;
+
+	int ms = timeout < 0 ? -1 : (int) ceil(timeout * 1000);
+
+	lua_settop(L, 1);
+	lua_getuservalue(L, 1);
+
+	do {
+		count = epoll_wait(poller->epfd, ready, POLLER_MAX_EVENTS, ms);
+	} while(count < 0 && errno == EINTR);
+	if(count < 0) {
+		return luaL_error(L, "Failure waiting on poll set: %s", strerror(errno));
+	}
+
+	luaL_checkstack(L, count, "too many ready objects");
+	for(i = 0; i < count; i++) {
+		lua_rawgeti(L, 2, ready[i].data.fd);
+	}
+
+	return count;
+}
+
+/* count() - the number of watched objects */
+static int poller_count(lua_State *L) {
+	struct poller *poller = luaL_checkudata(L, 1, POLLER_USERDATA);
+
+	lua_pushinteger(L, poller->count);
+	return 1;
+}
+
+static int poller_pollfd(lua_State *L) {
+	CHECK_POLLER(poller, 1)
+
+	lua_pushinteger(L, poller->epfd);
+	return 1;
+}
+
+static int poller_close(lua_State *L) {
+	struct poller *poller = luaL_checkudata(L, 1, POLLER_USERDATA);
+
+	if(poller->epfd != -1) {
+		close(poller->epfd);
+		poller->epfd = -1;
+		poller->count = 0;
+		lua_newtable(L);
+		lua_setuservalue(L, 1);
+	}
+
+	return 0;
+}
+
+/* Rings
+ * 
+ * A Ring reads many Devices at once. With io_uring, a read for a batch of
+ * events stays posted against every device, and harvest() collects all
+ * completed reads with a single io_uring_enter() that also reposts them;
+ * without it (or when asked), an epoll set and one read() per ready device
+ * stand in. Events go through each device's usual stages and are left in
+ * one array, tagged with their source's index, for Lua or the FFI view.
+ * The uservalue table holds the devices, indexed like the sources.
+ * 
+ * Device fds are blocking, so io_uring serves their reads from its worker
+ * threads; closing the ring cancels them and waits before buffers go. */
+
+#define RING_USERDATA "us.tropi.evdev.struct.ring"
+#define RING_DEFAULT_SIZE 64
+#define RING_DEFAULT_BATCH 64
+#define RING_CANCEL_TAG UINT64_MAX
+
+enum { RING_IO_URING, RING_EPOLL };
+static const char *const ring_backends[] = { "io_uring", "epoll", NULL };
+
+struct ringSource {
+	struct inputDevice *dev;
+	struct input_event *buffer; // `batch` events
+	int posted; // a read is in flight
+	int eof;
+};
+
+struct ring {
+	int backend;
+	int fd; // io_uring or epoll fd
+	unsigned size, batch;
+
+	struct ringSource *sources;
+	unsigned sourceCount;
+
+	struct input_event *events; // last harvest
+	int *eventSources;
+	size_t eventCount, eventCap;
+
+#ifdef EVDEV_HAVE_IO_URING
+	void *sqMap, *cqMap;
+	size_t sqMapSize, cqMapSize;
+	struct io_uring_sqe *sqes;
+	size_t sqesSize;
+	unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+	unsigned *cqHead, *cqTail, *cqMask;
+	struct io_uring_cqe *cqes;
+	unsigned toSubmit;
+#endif
+};
+
+#ifdef EVDEV_HAVE_IO_URING
+
+static int ring_setup(struct ring *ring) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	ring->fd = syscall(__NR_io_uring_setup, ring->size, &params);
+	if(ring->fd < 0) {
+		return -1;
+	}
+
+	ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if(params.features & IORING_FEAT_SINGLE_MMAP) {
+		if(ring->cqMapSize > ring->sqMapSize) {
+			ring->sqMapSize = ring->cqMapSize;
+		}
+		ring->cqMapSize = 0;
+	}
+
+	ring->sqMap = mmap(NULL, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if(ring->sqMap == MAP_FAILED) {
+		ring->sqMap = NULL;
+		return -1;
+	}
+	ring->cqMap = ring->sqMap;
+	if(ring->cqMapSize > 0) {
+		ring->cqMap = mmap(NULL, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+		if(ring->cqMap == MAP_FAILED) {
+			ring->cqMap = NULL;
+			return -1;
+		}
+	}
+
+	ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if(ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		return -1;
+	}
+
+	uint8_t *sq = ring->sqMap, *cq = ring->cqMap;
+	ring->sqHead = (unsigned *) (sq + params.sq_off.head);
+	ring->sqTail = (unsigned *) (sq + params.sq_off.tail);
+	ring->sqMask = (unsigned *) (sq + params.sq_off.ring_mask);
+	ring->sqArray = (unsigned *) (sq + params.sq_off.array);
+	ring->cqHead = (unsigned *) (cq + params.cq_off.head);
+	ring->cqTail = (unsigned *) (cq + params.cq_off.tail);
+	ring->cqMask = (unsigned *) (cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+
+	return 0;
+}
+
+static struct io_uring_sqe *ring_getSqe(struct ring *ring) {
+	unsigned tail = *ring->sqTail;
+	unsigned head = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+
+	if(tail - head > *ring->sqMask) {
+		return NULL;
+	}
+
+	unsigned index = tail & *ring->sqMask;
+	struct io_uring_sqe *sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	ring->sqArray[index] = index;
+	__atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+	ring->toSubmit++;
+
+	return sqe;
+}
+
+/* submit what's queued, optionally waiting for a completion */
+static int ring_enter(struct ring *ring, int wait) {
+	for(;;) {
+		int result = syscall(__NR_io_uring_enter, ring->fd, ring->toSubmit, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+		if(result >= 0) {
+			ring->toSubmit -= result < (int) ring->toSubmit ? result : (int) ring->toSubmit;
+			return 0;
+		}
+		if(errno != EINTR) {
+			return -1;
+		}
+	}
+}
+
+static void ring_post(struct ring *ring, unsigned index) {
+	struct ringSource *source = &ring->sources[index];
+
+	if(source->posted || source->eof || source->dev->fd == -1) {
+		return;
+	}
+
+	struct io_uring_sqe *sqe = ring_getSqe(ring);
+	if(sqe == NULL) {
+		return;
+	}
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = source->dev->fd;
+	sqe->addr = (uintptr_t) source->buffer;
+	sqe->len = ring->batch * sizeof(struct input_event);
+	sqe->off = (uint64_t) -1; // current position, as for read()
+	sqe->user_data = index;
+	source->posted = 1;
+}
+
+static void ring_teardown(struct ring *ring) {
+	unsigned i, posted = 0;
+
+	/* outstanding reads write into source buffers; see them finish */
+	if(ring->fd != -1 && ring->sqes != NULL) {
+		for(i = 0; i < ring->sourceCount; i++) {
+			if(ring->sources[i].posted) {
+				struct io_uring_sqe *sqe = ring_getSqe(ring);
+				if(sqe != NULL) {
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->addr = i;
+					sqe->user_data = RING_CANCEL_TAG;
+				}
+				posted++;
+			}
+		}
+		while(posted > 0 && ring_enter(ring, 1) == 0) {
+			unsigned head = *ring->cqHead;
+			while(head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+				struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+				if(cqe->user_data != RING_CANCEL_TAG && cqe->user_data < ring->sourceCount) {
+					ring->sources[cqe->user_data].posted = 0;
+					posted--;
+				}
+				head++;
+			}
+			__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+		}
+	}
+
+	if(ring->sqes != NULL) {
+		munmap(ring->sqes, ring->sqesSize);
+		ring->sqes = NULL;
+	}
+	if(ring->cqMap != NULL && ring->cqMap != ring->sqMap) {
+		munmap(ring->cqMap, ring->cqMapSize);
+	}
+	ring->cqMap = NULL;
+	if(ring->sqMap != NULL) {
+		munmap(ring->sqMap, ring->sqMapSize);
+		ring->sqMap = NULL;
+	}
+}
+
+#endif
+
+/* Ring([options]) - options may set `size` (most devices, default 64),
+ * `batch` (events per read, default 64) and `backend` */
+static int ring_open(lua_State *L) {
+	if(!lua_isnoneornil(L, 1)) {
+		luaL_checktype(L, 1, LUA_TTABLE);
+	} else {
+		lua_settop(L, 0);
+		lua_newtable(L);
+	}
+
+	lua_Number size = option_number(L, 1, "size", RING_DEFAULT_SIZE);
+	lua_Number batch = option_number(L, 1, "batch", RING_DEFAULT_BATCH);
+	lua_getfield(L, 1, "backend");
+	int backend = luaL_checkoption(L, -1, "io_uring", ring_backends);
+	lua_pop(L, 1);
+
+	luaL_argcheck(L, size >= 1 && size <= 4096, 1, "size out of range");
+	luaL_argcheck(L, batch >= 1 && batch <= EVDEV_BATCH_MAX, 1, "batch out of range");
+
+	struct ring *ring = lua_newuserdata(L, sizeof(struct ring));
+	memset(ring, 0, sizeof(struct ring));
+	ring->fd = -1;
+	ring->size = size;
+	ring->batch = batch;
+	luaL_setmetatable(L, RING_USERDATA);
+
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
+	ring->sources = calloc(ring->size, sizeof(struct ringSource));
+	if(ring->sources == NULL) {
+		return luaL_error(L, "Out of memory allocating ring.");
+	}
+
+#ifdef EVDEV_HAVE_IO_URING
+	if(backend == RING_IO_URING && ring_setup(ring) == 0) {
+		ring->backend = RING_IO_URING;
+		return 1;
+	}
+	/* fall back if the kernel lacks io_uring or has it disabled */
+	ring_teardown(ring);
+	if(ring->fd != -1) {
+		close(ring->fd);
+	}
+#endif
+	(void) backend;
+
+	ring->backend = RING_EPOLL;
+	ring->fd = epoll_create1(EPOLL_CLOEXEC);
+	if(ring->fd < 0) {
+		return luaL_error(L, "Couldn't create ring poll set.");
+	}
+
+	return 1;
+}
+
+#define CHECK_RING(ring, index) \
+struct ring *ring = luaL_checkudata(L, index, RING_USERDATA); \
+if(ring->fd == -1) { \
+	return luaL_error(L, "Trying to use closed ring."); \
+}
+
+/* add(device) - returns the device's index, as harvest() tags events;
+ * the device shouldn't be read by other means while in the ring */
+static int ring_add(lua_State *L) {
+	CHECK_RING(ring, 1)
+	CHECK_EVDEV(dev, 2)
+
+	if(ring->sourceCount == ring->size) {
+		return luaL_error(L, "Ring is full; raise its size option.");
+	}
+
+	struct ringSource *source = &ring->sources[ring->sourceCount];
+	source->buffer = malloc(ring->batch * sizeof(struct input_event));
+	if(source->buffer == NULL) {
+		return luaL_error(L, "Out of memory allocating ring buffer.");
+	}
+	source->dev = dev;
+	ring->sourceCount++;
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, ring->sourceCount);
+
+	if(ring->backend == RING_EPOLL) {
+		struct epoll_event watch;
+		memset(&watch, 0, sizeof(watch));
+		watch.events = EPOLLIN;
+		watch.data.u32 = ring->sourceCount - 1;
+		epoll_ctl(ring->fd, EPOLL_CTL_ADD, dev->fd, &watch);
+	}
+#ifdef EVDEV_HAVE_IO_URING
+	else {
+		ring_post(ring, ring->sourceCount - 1);
+		if(ring_enter(ring, 0) < 0) {
+			return luaL_error(L, "Couldn't submit ring read: %s", strerror(errno));
+		}
+	}
+#endif
+
+	lua_pushinteger(L, ring->sourceCount);
+	return 1;
+}
+
+static int ring_reserve(lua_State *L, struct ring *ring, size_t more) {
+	size_t need = ring->eventCount + more;
+
+	if(need > ring->eventCap) {
+		size_t cap = ring->eventCap ? ring->eventCap : 256;
+		while(cap < need) {
+			cap *= 2;
+		}
+		struct input_event *events = realloc(ring->events, cap * sizeof(struct input_event));
+		if(events == NULL) {
+			return luaL_error(L, "Out of memory harvesting events.");
+		}
+		ring->events = events;
+		int *eventSources = realloc(ring->eventSources, cap * sizeof(int));
+		if(eventSources == NULL) {
+			return luaL_error(L, "Out of memory harvesting events.");
+		}
+		ring->eventSources = eventSources;
+		ring->eventCap = cap;
+	}
+
+	return 0;
+}
+
+static void ring_keep(struct ring *ring, unsigned index) {
+	ring->eventSources[ring->eventCount++] = index;
+}
+
+/* take what a device's stages queued, with room already reserved */
+static void ring_injected(lua_State *L, struct ring *ring, unsigned index, int devIndex) {
+	struct inputDevice *dev = ring->sources[index].dev;
+
+	while(evdev_pendingEvents(dev) > 0) {
+		struct input_event *evt = &ring->events[ring->eventCount];
+		evdev_nextPending(dev, evt);
+		if(evdev_process(L, devIndex, dev, evt)) {
+			ring_keep(ring, index);
+		}
+	}
+}
+
+/* nanoseconds until a live device's debounced transition settles; -1 if
+ * none is waiting to */
+static int64_t ring_settleWait(struct ring *ring) {
+	int64_t soonest = -1;
+	unsigned i;
+
+	for(i = 0; i < ring->sourceCount; i++) {
+		struct ringSource *source = &ring->sources[i];
+		if(source->eof || source->dev->fd == -1) {
+			continue;
+		}
+		int64_t wait = evdev_settleWait(source->dev);
+		if(wait >= 0 && (soonest < 0 || wait < soonest)) {
+			soonest = wait;
+		}
+	}
+
+	return soonest;
+}
+
+/* deliver the transitions that settled on quiet devices; the uservalue
+ * table must be at stack index 2 */
+static void ring_settle(lua_State *L, struct ring *ring) {
+	unsigned i;
+
+	for(i = 0; i < ring->sourceCount; i++) {
+		struct ringSource *source = &ring->sources[i];
+		if(source->eof || source->dev->fd == -1 || !evdev_settleDue(source->dev)) {
+			continue;
+		}
+		ring_reserve(L, ring, DEBOUNCE_QUEUE_SIZE);
+		lua_rawgeti(L, 2, i + 1);
+		ring_injected(L, ring, i, lua_gettop(L));
+		lua_pop(L, 1);
+	}
+}
+
+/* run a completed read through its device's stages; the uservalue table
+ * must be at stack index 2 */
+static void ring_complete(lua_State *L, struct ring *ring, unsigned index, ssize_t count) {
+	struct ringSource *source = &ring->sources[index];
+	struct inputDevice *dev = source->dev;
+	size_t i;
+
+	io_countRead(&dev->stats, source->buffer, count);
+
+	if(dev->fd == -1) {
+		source->eof = 1;
+		return;
+	} else if(count <= 0) {
+		/* unplugged, revoked, or the end of a pipe or file; the error
+		 * comes negated */
+		if(count < 0) {
+			errno = -count;
+		}
+		evdev_end(dev, count);
+		source->eof = 1;
+		return;
+	} else if(count % sizeof(struct input_event) != 0) {
+		luaL_error(L, "Failure reading input event.");
+	}
+
+	lua_rawgeti(L, 2, index + 1);
+	int devIndex = lua_gettop(L);
+
+	for(i = 0; i < count / sizeof(struct input_event); i++) {
+		ring_reserve(L, ring, 1 + LIMIT_QUEUE_SIZE + DEBOUNCE_QUEUE_SIZE);
+
+		struct input_event *evt = &ring->events[ring->eventCount];
+		*evt = source->buffer[i];
+
+		int result = evdev_accept(L, devIndex, dev, evt);
+		if(result == EVDEV_KEEP) {
+			ring_keep(ring, index);
+		} else if(result == EVDEV_INJECTED) {
+			ring_injected(L, ring, index, devIndex);
+		} else if(result == EVDEV_CLOSED) {
+			source->eof = 1;
+			break;
+		}
+	}
+
+	lua_pop(L, 1);
+}
+
+static int ring_live(struct ring *ring) {
+	unsigned i;
+	for(i = 0; i < ring->sourceCount; i++) {
+		if(!ring->sources[i].eof) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* harvest([block]) - collect every completed read, waiting for one
+ * unless `block` is false. Returns the number of events kept and light
+ * userdata for the events and their source indexes (C arrays of struct
+ * input_event and int), valid until the next harvest(); nil once every
+ * device has reached EOF. */
+static int ring_harvest(lua_State *L) {
+	CHECK_RING(ring, 1)
+	int block = lua_isnoneornil(L, 2) || lua_toboolean(L, 2);
+
+	lua_settop(L, 1);
+	lua_getuservalue(L, 1);
+	ring->eventCount = 0;
+
+	if(!ring_live(ring)) {
+		return 0;
+	}
+
+	/* a debounced transition may settle before any read completes */
+	int64_t settle = block ? ring_settleWait(ring) : -1;
+	int timeout = !block ? 0 : settle < 0 ? -1 : (int) ((settle + 999999) / 1000000);
+
+	if(ring->backend == RING_EPOLL) {
+		struct epoll_event ready[64];
+		int count, i;
+
+		do {
+			count = epoll_wait(ring->fd, ready, 64, timeout);
+		} while(count < 0 && errno == EINTR);
+		if(count < 0) {
+			return luaL_error(L, "Failure waiting on ring: %s", strerror(errno));
+		}
+
+		for(i = 0; i < count; i++) {
+			unsigned index = ready[i].data.u32;
+			struct ringSource *source = &ring->sources[index];
+			if(source->eof) {
+				continue;
+			}
+			ssize_t bytes = source->dev->fd == -1 ? 0
+				: read(source->dev->fd, source->buffer, ring->batch * sizeof(struct input_event));
+			if(bytes < 0) {
+				/* as io_uring reports it */
+				bytes = -errno;
+			}
+			if(source->dev->fd != -1 && (bytes <= 0 || source->eof)) {
+				epoll_ctl(ring->fd, EPOLL_CTL_DEL, source->dev->fd, NULL);
+			}
+			ring_complete(L, ring, index, bytes);
+		}
+	}
+#ifdef EVDEV_HAVE_IO_URING
+	else {
+		unsigned i;
+
+		/* a read whose stages raised an error was never reposted, nor
+		 * one that found the submission queue full; a device closed
+		 * since then has nothing left to read */
+		for(i = 0; i < ring->sourceCount; i++) {
+			struct ringSource *source = &ring->sources[i];
+			if(!source->posted && source->dev->fd == -1) {
+				source->eof = 1;
+			}
+			ring_post(ring, i);
+		}
+		if(!ring_live(ring)) {
+			return 0;
+		}
+
+		if(timeout > 0) {
+			/* submit, then wait no longer than the settling allows */
+			if(ring_enter(ring, 0) < 0) {
+				return luaL_error(L, "Failure waiting on ring: %s", strerror(errno));
+			}
+			struct pollfd pfd = { ring->fd, POLLIN, 0 };
+			while(poll(&pfd, 1, timeout) < 0 && errno == EINTR) {
+			}
+			block = 0;
+		}
+		if(ring_enter(ring, block && timeout != 0) < 0) {
+			return luaL_error(L, "Failure waiting on ring: %s", strerror(errno));
+		}
+
+		unsigned head = *ring->cqHead;
+		while(head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe cqe = ring->cqes[head & *ring->cqMask];
+			head++;
+			__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+
+			if(cqe.user_data >= ring->sourceCount) {
+				continue;
+			}
+			ring->sources[cqe.user_data].posted = 0;
+			if(cqe.res < 0) {
+				errno = -cqe.res;
+				if(errno == EINTR || errno == EAGAIN || errno == ECANCELED) {
+					ring_post(ring, cqe.user_data);
+					continue;
+				}
+			}
+			ring_complete(L, ring, cqe.user_data, cqe.res);
+			ring_post(ring, cqe.user_data);
+		}
+
+		/* repost straight away, so reads are in flight while Lua works */
+		if(ring->toSubmit > 0 && ring_enter(ring, 0) < 0) {
+			return luaL_error(L, "Couldn't submit ring read: %s", strerror(errno));
+		}
+	}
+#endif
+
+	ring_settle(L, ring);
+
+	if(ring->eventCount == 0 && !ring_live(ring)) {
+		return 0;
+	}
+
+	lua_pushinteger(L, ring->eventCount);
+	lua_pushlightuserdata(L, ring->events);
+	lua_pushlightuserdata(L, ring->eventSources);
+	return 3;
+}
 
-#define EVDEV_USERDATA "us.tropi.evdev.struct.inputDevice"
-struct inputDevice {
-	int fd; /* file descriptor */
-};
+/* event(i) - the i-th event of the last harvest, like Device:read(),
+ * followed by its device and the device's index */
+static int ring_event(lua_State *L) {
+	struct ring *ring = luaL_checkudata(L, 1, RING_USERDATA);
+	lua_Integer i = luaL_checkinteger(L, 2);
 
-#define CHECK_EVDEV(dev, index) \
-struct inputDevice *dev = luaL_checkudata(L, index, EVDEV_USERDATA); \
-if(dev->fd == -1) { \
-	return luaL_error(L, "Trying to use closed device event node."); \
+	luaL_argcheck(L, i >= 1 && (size_t) i <= ring->eventCount, 2, "no such event in harvest");
+
+	struct input_event *evt = &ring->events[i - 1];
+	int source = ring->eventSources[i - 1];
+	lua_pushnumber(L, evdev_timestamp(evt));
+	lua_pushinteger(L, evt->type);
+	lua_pushinteger(L, evt->code);
+	lua_pushinteger(L, evt->value);
+	lua_getuservalue(L, 1);
+	lua_rawgeti(L, -1, source + 1);
+	lua_remove(L, -2);
+	lua_pushinteger(L, source + 1);
+
+	return 6;
 }
 
-static int evdev_open(lua_State *L) {
-	const char *path = luaL_checkstring(L, 1);
-	int writeMode = lua_toboolean(L, 2);
+static int ring_backend(lua_State *L) {
+	struct ring *ring = luaL_checkudata(L, 1, RING_USERDATA);
 
-	/* create userdata */
-	struct inputDevice *dev = lua_newuserdata(L, sizeof(struct inputDevice));
-	dev->fd = -1;
+	lua_pushstring(L, ring_backends[ring->backend]);
+	return 1;
+}
 
-	luaL_setmetatable(L, EVDEV_USERDATA);
-	
-	if(writeMode) {
-		// if requested, attempt opening for writing so we can send LED events and such
-		dev->fd = open(path, O_RDWR | O_CLOEXEC);
+/* either fd becomes readable when harvest() won't block */
+static int ring_pollfd(lua_State *L) {
+	CHECK_RING(ring, 1)
+
+	lua_pushinteger(L, ring->fd);
+	return 1;
+}
+
+/* seconds until a device's debounced transition settles, which harvest()
+ * delivers without the fd turning readable; nil if none is waiting to */
+static int ring_timeout(lua_State *L) {
+	CHECK_RING(ring, 1)
+
+	int64_t wait = ring_settleWait(ring);
+	if(wait < 0) {
+		return 0;
 	}
-	
-	if(dev->fd < 0) {
-		// writing mode not requested or not allowed,
-		// try falling back to reading events only
-		dev->fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	lua_pushnumber(L, wait / 1e9);
+	return 1;
+}
+
+static int ring_close(lua_State *L) {
+	struct ring *ring = luaL_checkudata(L, 1, RING_USERDATA);
+	unsigned i;
+
+#ifdef EVDEV_HAVE_IO_URING
+	if(ring->backend == RING_IO_URING) {
+		ring_teardown(ring);
+	}
+#endif
+	if(ring->fd != -1) {
+		close(ring->fd);
+		ring->fd = -1;
 	}
 
-	if(dev->fd < 0) {
-		// still couldn't open, nothing to be done.
-		return luaL_error(L, "Couldn't open device node.");
+	for(i = 0; i < ring->sourceCount; i++) {
+		free(ring->sources[i].buffer);
 	}
+	free(ring->sources);
+	ring->sources = NULL;
+	ring->sourceCount = 0;
+	free(ring->events);
+	free(ring->eventSources);
+	ring->events = NULL;
+	ring->eventSources = NULL;
+	ring->eventCount = ring->eventCap = 0;
 
-	return 1;
+	return 0;
 }
 
-static int evdev_tryRead(lua_State *L) {
-	CHECK_EVDEV(dev, 1);
+/* Load generation
+ * 
+ * A Generator synthesizes realistic input, such as mouse motion, up to ten
+ * tracked multitouch fingers, or key storms, so consumers can be
+ * stress-tested on machines without input hardware. Started, a thread
+ * writes one frame per period on absolute CLOCK_MONOTONIC deadlines
+ * (clock_nanosleep), into a pipe whose read end is a Device or into a
+ * Uinput; record() instead fills a Recorder as fast as it can, with
+ * timestamps spaced at the rate. Frames are stamped with CLOCK_REALTIME
+ * like evdev's, so a Meter on the consumer side can report lag. */
 
-	struct input_event evt;
-	const size_t evt_size = sizeof(struct input_event);
-	memset(&evt, 0, evt_size);
+#define GENERATOR_USERDATA "us.tropi.evdev.struct.generator"
+#define GENERATOR_FRAME_MAX 64
+#define GENERATOR_FINGERS 10
+#define GENERATOR_TOUCH_MAX 4095
+#define GENERATOR_SLICE_NS 50000000 // longest sleep between stop checks
 
-	int count = read(dev->fd, &evt, evt_size);
+enum { GENERATE_MOUSE, GENERATE_TOUCH, GENERATE_KEYS };
+static const char *const generator_kinds[] = { "mouse", "touch", "keys", NULL };
 
-	if(count < 0) {
-		/* device was presumably unplugged */
-		return 0;
-	} else if((unsigned int) count < evt_size) {
-		return luaL_error(L, "Failure reading input event.");
+struct generatorFinger {
+	int id; // tracking id, or -1 while lifted
+	double x, y, vx, vy;
+	int life; // frames until lifted or placed again
+};
+
+struct generator {
+	int kind;
+	double rate; // frames per second
+	int fingers;
+	uint64_t random;
+
+	/* synthesis state */
+	uint64_t frame;
+	double phase;
+	int button;
+	struct generatorFinger touch[GENERATOR_FINGERS];
+	int nextId, touching;
+	int key;
+
+	/* thread */
+	pthread_t thread;
+	int started;
+	int out; // fd the thread writes
+	int uinput; // out is a uinput node, which drops frames when full
+	uint64_t limit; // frames to write, 0 for no limit
+	int stop;
+
+	/* shared with the thread */
+	uint64_t frames, events, late, dropped;
+	uint64_t maxLate, startNs, endNs;
+	int error;
+};
+
+static uint64_t generator_next(struct generator *gen) {
+	/* xorshift64* */
+	gen->random ^= gen->random >> 12;
+	gen->random ^= gen->random << 25;
+	gen->random ^= gen->random >> 27;
+	return gen->random * 0x2545f4914f6cdd1dull;
+}
+
+static double generator_uniform(struct generator *gen) {
+	return (generator_next(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void generator_push(struct input_event *evts, int *count, int type, int code, int value) {
+	struct input_event *evt = &evts[(*count)++];
+	evt->type = type;
+	evt->code = code;
+	evt->value = value;
+}
+
+static void generator_mouse(struct generator *gen, struct input_event *evts, int *count) {
+	/* wandering circles with jitter, and now and then a click */
+	gen->phase += 0.05 + generator_uniform(gen) * 0.02;
+	generator_push(evts, count, EV_REL, REL_X, lround(cos(gen->phase) * 6 + generator_uniform(gen) * 2 - 1));
+	generator_push(evts, count, EV_REL, REL_Y, lround(sin(gen->phase) * 6 + generator_uniform(gen) * 2 - 1));
+
+	if(gen->button || generator_uniform(gen) < 0.01) {
+		gen->button = !gen->button;
+		generator_push(evts, count, EV_KEY, BTN_LEFT, gen->button);
 	}
+}
 
-	/* return: timestamp, event type, event code, event value */
-	lua_pushnumber(L, evt.time.tv_sec + evt.time.tv_usec/1000000.0);
-	lua_pushinteger(L, evt.type);
-	lua_pushinteger(L, evt.code);
-	lua_pushinteger(L, evt.value);
-	
-	return 4;
+static const int generator_tools[] = {
+	BTN_TOOL_FINGER, BTN_TOOL_DOUBLETAP, BTN_TOOL_TRIPLETAP, BTN_TOOL_QUADTAP, BTN_TOOL_QUINTTAP
+};
+
+static void generator_touch(struct generator *gen, struct input_event *evts, int *count) {
+	int slot, before = gen->touching;
+
+	for(slot = 0; slot < gen->fingers; slot++) {
+		struct generatorFinger *finger = &gen->touch[slot];
+
+		if(--finger->life <= 0) {
+			generator_push(evts, count, EV_ABS, ABS_MT_SLOT, slot);
+			if(finger->id == -1) {
+				/* touch down somewhere new */
+				finger->id = gen->nextId++ & 0xffff;
+				finger->x = generator_uniform(gen) * GENERATOR_TOUCH_MAX;
+				finger->y = generator_uniform(gen) * GENERATOR_TOUCH_MAX;
+				finger->vx = generator_uniform(gen) * 8 - 4;
+				finger->vy = generator_uniform(gen) * 8 - 4;
+				finger->life = 50 + generator_next(gen) % 200;
+				gen->touching++;
+				generator_push(evts, count, EV_ABS, ABS_MT_TRACKING_ID, finger->id);
+				generator_push(evts, count, EV_ABS, ABS_MT_POSITION_X, finger->x);
+				generator_push(evts, count, EV_ABS, ABS_MT_POSITION_Y, finger->y);
+			} else {
+				finger->id = -1;
+				finger->life = 5 + generator_next(gen) % 20;
+				gen->touching--;
+				generator_push(evts, count, EV_ABS, ABS_MT_TRACKING_ID, -1);
+			}
+			continue;
+		}
+
+		if(finger->id != -1) {
+			finger->x = fmin(fmax(finger->x + finger->vx, 0), GENERATOR_TOUCH_MAX);
+			finger->y = fmin(fmax(finger->y + finger->vy, 0), GENERATOR_TOUCH_MAX);
+			generator_push(evts, count, EV_ABS, ABS_MT_SLOT, slot);
+			generator_push(evts, count, EV_ABS, ABS_MT_POSITION_X, finger->x);
+			generator_push(evts, count, EV_ABS, ABS_MT_POSITION_Y, finger->y);
+		}
+	}
+
+	if((before == 0) != (gen->touching == 0)) {
+		generator_push(evts, count, EV_KEY, BTN_TOUCH, gen->touching > 0);
+	}
+	if(before != gen->touching) {
+		if(before > 0 && before <= 5) {
+			generator_push(evts, count, EV_KEY, generator_tools[before - 1], 0);
+		}
+		if(gen->touching > 0 && gen->touching <= 5) {
+			generator_push(evts, count, EV_KEY, generator_tools[gen->touching - 1], 1);
+		}
+	}
+
+	/* single-touch emulation follows the first finger down */
+	for(slot = 0; slot < gen->fingers; slot++) {
+		if(gen->touch[slot].id != -1) {
+			generator_push(evts, count, EV_ABS, ABS_X, gen->touch[slot].x);
+			generator_push(evts, count, EV_ABS, ABS_Y, gen->touch[slot].y);
+			break;
+		}
+	}
 }
 
-static int evdev_read(lua_State *L) {
-	int count = evdev_tryRead(L);
+static void generator_keys(struct generator *gen, struct input_event *evts, int *count) {
+	/* alternate presses and releases of random letters */
+	if(gen->key != 0) {
+		generator_push(evts, count, EV_KEY, gen->key, 0);
+		gen->key = 0;
+	} else {
+		static const int letters[] = {
+			KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I,
+			KEY_J, KEY_K, KEY_L, KEY_M, KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R,
+			KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z
+		};
+		int letter = generator_next(gen) % 26;
+		gen->key = letters[letter];
+		/* HID usages run A to Z from 0x04 on the keyboard page */
+		generator_push(evts, count, EV_MSC, MSC_SCAN, 0x70004 + letter);
+		generator_push(evts, count, EV_KEY, gen->key, 1);
+	}
+}
 
-	if(count == 0) {
-		return luaL_error(L, "End of input event stream.");
+/* build the next frame, SYN_REPORT included, stamped `stamp` µs */
+static int generator_frame(struct generator *gen, struct input_event *evts, uint64_t stamp) {
+	int i, count = 0;
+
+	memset(evts, 0, GENERATOR_FRAME_MAX * sizeof(struct input_event));
+	switch(gen->kind) {
+	case GENERATE_MOUSE: generator_mouse(gen, evts, &count); break;
+	case GENERATE_TOUCH: generator_touch(gen, evts, &count); break;
+	case GENERATE_KEYS: generator_keys(gen, evts, &count); break;
+	}
+	generator_push(evts, &count, EV_SYN, SYN_REPORT, 0);
+	gen->frame++;
+
+	for(i = 0; i < count; i++) {
+		evts[i].input_event_sec = stamp / 1000000;
+		evts[i].input_event_usec = stamp % 1000000;
 	}
 
 	return count;
 }
 
-static int evdev_grab(lua_State *L) {
-	CHECK_EVDEV(dev, 1);
+/* write a whole frame, waiting out a full pipe; a full uinput drops it */
+static int generator_write(struct generator *gen, const struct input_event *evts, int count) {
+	const char *data = (const char *) evts;
+	size_t bytes = count * sizeof(struct input_event);
+	struct pollfd pfd = { gen->out, POLLOUT, 0 };
 
-	int wantGrab = lua_isnone(L, 2) || lua_toboolean(L, 2);
+	while(bytes > 0) {
+		ssize_t written = write(gen->out, data, bytes);
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			} else if(errno != EAGAIN) {
+				return -1;
+			} else if(gen->uinput && bytes == count * sizeof(struct input_event)) {
+				/* writing to a uinput node */
+				__atomic_add_fetch(&gen->dropped, 1, __ATOMIC_RELAXED);
+				return 0;
+			}
+			if(__atomic_load_n(&gen->stop, __ATOMIC_RELAXED)) {
+				return 0;
+			}
+			poll(&pfd, 1, 50);
+			continue;
+		}
+		data += written;
+		bytes -= written;
+	}
 
-	if(ioctl(dev->fd, EVIOCGRAB, wantGrab) < 0) {
-		/* Presuming any error here means a failed grab;
-		 * not sure if any error besides EBUSY is possible. */
-		lua_pushboolean(L, 0);
-		return 1;
+	return 1;
+}
+
+static void *generator_thread(void *arg) {
+	struct generator *gen = arg;
+	struct input_event evts[GENERATOR_FRAME_MAX];
+	uint64_t period = 1e9 / gen->rate;
+	uint64_t deadline = monotonic_ns();
+
+	__atomic_store_n(&gen->startNs, deadline, __ATOMIC_RELAXED);
+
+	while(!__atomic_load_n(&gen->stop, __ATOMIC_RELAXED)) {
+		uint64_t now = monotonic_ns();
+
+		if(now < deadline) {
+			/* sleep in slices so stop() is noticed at low rates */
+			uint64_t until = deadline - now > GENERATOR_SLICE_NS ? now + GENERATOR_SLICE_NS : deadline;
+			struct timespec ts = { until / 1000000000u, until % 1000000000u };
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+			continue;
+		}
+
+		uint64_t lateness = now - deadline;
+		if(lateness > period) {
+			/* don't burst to catch up; note it and carry on from now */
+			__atomic_add_fetch(&gen->late, 1, __ATOMIC_RELAXED);
+			if(lateness > __atomic_load_n(&gen->maxLate, __ATOMIC_RELAXED)) {
+				__atomic_store_n(&gen->maxLate, lateness, __ATOMIC_RELAXED);
+			}
+			deadline = now;
+		}
+		deadline += period;
+
+		int count = generator_frame(gen, evts, realtime_us());
+		int result = generator_write(gen, evts, count);
+		if(result < 0) {
+			__atomic_store_n(&gen->error, errno, __ATOMIC_RELAXED);
+			break;
+		} else if(result > 0) {
+			__atomic_add_fetch(&gen->events, count, __ATOMIC_RELAXED);
+		}
+		uint64_t frames = __atomic_add_fetch(&gen->frames, 1, __ATOMIC_RELAXED);
+		if(gen->limit > 0 && frames >= gen->limit) {
+			break;
+		}
 	}
-	
-	lua_pushboolean(L, 1);
+
+	__atomic_store_n(&gen->endNs, monotonic_ns(), __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/* Generator(kind[, options]) - kind is "mouse", "touch" or "keys";
+ * options are `rate` (frames per second, default 1000), `fingers` (for
+ * touch, default 10) and `seed` */
+static int generator_open(lua_State *L) {
+	int kind = luaL_checkoption(L, 1, NULL, generator_kinds);
+
+	if(!lua_isnoneornil(L, 2)) {
+		luaL_checktype(L, 2, LUA_TTABLE);
+	} else {
+		lua_settop(L, 1);
+		lua_newtable(L);
+	}
+
+	double rate = option_number(L, 2, "rate", 1000);
+	double fingers = option_number(L, 2, "fingers", GENERATOR_FINGERS);
+	double seed = option_number(L, 2, "seed", 1);
+	luaL_argcheck(L, rate > 0 && rate <= 1e6, 2, "rate out of range");
+	luaL_argcheck(L, fingers >= 1 && fingers <= GENERATOR_FINGERS, 2, "fingers out of range");
+	luaL_argcheck(L, seed >= 0 && seed < 18446744073709551616.0, 2, "seed out of range");
+
+	struct generator *gen = lua_newuserdata(L, sizeof(struct generator));
+	memset(gen, 0, sizeof(struct generator));
+	gen->kind = kind;
+	gen->rate = rate;
+	gen->fingers = fingers;
+	gen->random = (uint64_t) seed * 0x9e3779b97f4a7c15ull | 1;
+	gen->out = -1;
+	luaL_setmetatable(L, GENERATOR_USERDATA);
+
+	int slot;
+	for(slot = 0; slot < GENERATOR_FINGERS; slot++) {
+		gen->touch[slot].id = -1;
+		gen->touch[slot].life = 1 + slot * 3;
+	}
+
+	/* the uservalue keeps a Uinput target alive */
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+
 	return 1;
 }
 
-static int evdev_write(lua_State *L) {
-	CHECK_EVDEV(dev, 1);
-	
-	struct input_event evt;
-	memset(&evt, 0, sizeof(struct input_event));
-	
-	evt.type = luaL_checkinteger(L, 2);
-	evt.code = luaL_checkinteger(L, 3);
-	evt.value = luaL_checkinteger(L, 4);
-	
-	write(dev->fd, &evt, sizeof(struct input_event));
-	
+static void generator_join(struct generator *gen) {
+	if(gen->started) {
+		__atomic_store_n(&gen->stop, 1, __ATOMIC_RELAXED);
+		pthread_join(gen->thread, NULL);
+		gen->started = 0;
+	}
+}
+
+/* a run that has reached its duration counts as idle */
+#define CHECK_GENERATOR_IDLE(gen, index) \
+struct generator *gen = luaL_checkudata(L, index, GENERATOR_USERDATA); \
+if(gen->started && __atomic_load_n(&gen->endNs, __ATOMIC_ACQUIRE) != 0) { \
+	generator_join(gen); \
+} else if(gen->started) { \
+	return luaL_error(L, "Generator is running."); \
+}
+
+/* setup(uinput) - declare what the generator's kind of device emits on
+ * a Uinput that isn't initialized yet */
+static int generator_setup(lua_State *L) {
+	CHECK_GENERATOR_IDLE(gen, 1)
+	CHECK_UINPUT(dev, 2, 0)
+	int i;
+
+	switch(gen->kind) {
+	case GENERATE_MOUSE:
+		ioctl(dev->fd, UI_SET_EVBIT, EV_KEY);
+		ioctl(dev->fd, UI_SET_EVBIT, EV_REL);
+		ioctl(dev->fd, UI_SET_KEYBIT, BTN_LEFT);
+		ioctl(dev->fd, UI_SET_KEYBIT, BTN_RIGHT);
+		ioctl(dev->fd, UI_SET_RELBIT, REL_X);
+		ioctl(dev->fd, UI_SET_RELBIT, REL_Y);
+		break;
+	case GENERATE_TOUCH:
+		ioctl(dev->fd, UI_SET_EVBIT, EV_KEY);
+		ioctl(dev->fd, UI_SET_EVBIT, EV_ABS);
+		ioctl(dev->fd, UI_SET_PROPBIT, INPUT_PROP_DIRECT);
+		ioctl(dev->fd, UI_SET_KEYBIT, BTN_TOUCH);
+		for(i = 0; i < 5; i++) {
+			ioctl(dev->fd, UI_SET_KEYBIT, generator_tools[i]);
+		}
+		pool_setAbs(dev, ABS_X, 0, GENERATOR_TOUCH_MAX);
+		pool_setAbs(dev, ABS_Y, 0, GENERATOR_TOUCH_MAX);
+		pool_setAbs(dev, ABS_MT_SLOT, 0, gen->fingers - 1);
+		pool_setAbs(dev, ABS_MT_TRACKING_ID, 0, 0xffff);
+		pool_setAbs(dev, ABS_MT_POSITION_X, 0, GENERATOR_TOUCH_MAX);
+		pool_setAbs(dev, ABS_MT_POSITION_Y, 0, GENERATOR_TOUCH_MAX);
+		break;
+	case GENERATE_KEYS:
+		ioctl(dev->fd, UI_SET_EVBIT, EV_KEY);
+		ioctl(dev->fd, UI_SET_EVBIT, EV_MSC);
+		ioctl(dev->fd, UI_SET_MSCBIT, MSC_SCAN);
+		pool_setKeys(dev, KEY_Q, KEY_P);
+		pool_setKeys(dev, KEY_A, KEY_L);
+		pool_setKeys(dev, KEY_Z, KEY_M);
+		break;
+	}
+
 	return 0;
 }
 
-static int evdev_close(lua_State *L) {
-	struct inputDevice *dev = luaL_checkudata(L, 1, EVDEV_USERDATA);
-	
-	if(dev->fd != -1) {
-		close(dev->fd);
-		dev->fd = -1;
+/* device() - a Device reading a pipe that start() will write into */
+static int generator_device(lua_State *L) {
+	CHECK_GENERATOR_IDLE(gen, 1)
+	int fds[2];
+
+	if(gen->out != -1) {
+		return luaL_error(L, "Generator already has a pipe.");
+	}
+	if(pipe2(fds, O_CLOEXEC) < 0) {
+		return luaL_error(L, "Couldn't create pipe: %s", strerror(errno));
+	}
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	/* room for bursts, where the kernel allows it */
+	fcntl(fds[1], F_SETPIPE_SZ, 1 << 20);
+
+	gen->out = fds[1];
+	evdev_wrap(L, fds[0], "pipe");
+
+	return 1;
+}
+
+/* start([uinput][, seconds]) - write frames at the rate from a thread,
+ * into the initialized `uinput` or the pipe from device(), for `seconds`
+ * or until stop() */
+static int generator_start(lua_State *L) {
+	CHECK_GENERATOR_IDLE(gen, 1)
+	int durationIndex = 2;
+
+	if(luaL_testudata(L, 2, UINPUT_USERDATA) != NULL) {
+		CHECK_UINPUT(dev, 2, 1)
+		if(gen->out != -1) {
+			close(gen->out);
+		}
+		gen->out = fcntl(dev->fd, F_DUPFD_CLOEXEC, 0);
+		gen->uinput = 1;
+		lua_getuservalue(L, 1);
+		lua_pushvalue(L, 2);
+		lua_setfield(L, -2, "target");
+		lua_pop(L, 1);
+		durationIndex = 3;
+	} else if(lua_isnil(L, 2)) {
+		durationIndex = 3;
 	}
+	if(gen->out < 0) {
+		return luaL_error(L, "Generator has nothing to write to; pass a Uinput or call device().");
+	}
+
+	lua_Number seconds = luaL_optnumber(L, durationIndex, 0);
+	luaL_argcheck(L, seconds >= 0, durationIndex, "negative duration");
+	gen->limit = seconds > 0 ? (uint64_t) ceil(seconds * gen->rate) : 0;
+
+	gen->stop = 0;
+	gen->frames = gen->events = gen->late = gen->dropped = gen->maxLate = 0;
+	gen->endNs = 0;
+	gen->error = 0;
+
+	/* as for the Forwarder, signals stay on the Lua thread */
+	sigset_t saved;
+	flight_blockSignals(&saved);
+	int error = pthread_create(&gen->thread, NULL, &generator_thread, gen);
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+	if(error != 0) {
+		return luaL_error(L, "Couldn't start generator thread: %s", strerror(error));
+	}
+	gen->started = 1;
 
 	return 0;
 }
 
-static int evdev_pollfd(lua_State *L) {
-	CHECK_EVDEV(dev, 1);
+/* record(recorder, seconds) - write `seconds` worth of frames into a
+ * Recorder at once, timestamped as if generated at the rate from now */
+static int generator_record(lua_State *L) {
+	CHECK_GENERATOR_IDLE(gen, 1)
+	CHECK_RECORDER(rec, 2);
+	lua_Number seconds = luaL_checknumber(L, 3);
+	struct input_event evts[GENERATOR_FRAME_MAX];
+	uint64_t frame, frames = ceil(seconds * gen->rate);
+	uint64_t start = realtime_us(), events = 0;
+	int i;
 
-	lua_pushinteger(L, dev->fd);
+	for(frame = 0; frame < frames; frame++) {
+		uint64_t stamp = start + (uint64_t) (frame * 1e6 / gen->rate);
+		int count = generator_frame(gen, evts, stamp);
+		for(i = 0; i < count; i++) {
+			if(recorder_add(rec, stamp, evts[i].type, evts[i].code, evts[i].value) < 0) {
+				lua_pushnil(L);
+				lua_pushstring(L, strerror(errno));
+				return 2;
+			}
+		}
+		events += count;
+	}
 
+	lua_pushinteger(L, events);
 	return 1;
 }
 
-/* Uinput wrappers */
+/* stats() - frames and events written, the rate achieved, and how often
+ * and how far the thread fell behind its deadlines */
+static int generator_stats(lua_State *L) {
+	struct generator *gen = luaL_checkudata(L, 1, GENERATOR_USERDATA);
+	uint64_t start = __atomic_load_n(&gen->startNs, __ATOMIC_RELAXED);
+	uint64_t end = __atomic_load_n(&gen->endNs, __ATOMIC_ACQUIRE);
+	uint64_t frames = __atomic_load_n(&gen->frames, __ATOMIC_RELAXED);
+	int error = __atomic_load_n(&gen->error, __ATOMIC_RELAXED);
 
-#define UINPUT_USERDATA "us.tropi.evdev.struct.userdev"
-struct userdev {
-       int fd; // file descriptor
-       int init; // 0 if not initialized, 1 if initialized
-       struct uinput_user_dev dev;
+	uint64_t until = end != 0 && end >= start ? end : monotonic_ns();
+	double elapsed = start > 0 ? (until - start) / 1e9 : 0;
+
+	lua_newtable(L);
+	lua_pushboolean(L, gen->started && end == 0);
+	lua_setfield(L, -2, "running");
+	lua_pushinteger(L, frames);
+	lua_setfield(L, -2, "frames");
+	lua_pushinteger(L, __atomic_load_n(&gen->events, __ATOMIC_RELAXED));
+	lua_setfield(L, -2, "events");
+	lua_pushnumber(L, elapsed);
+	lua_setfield(L, -2, "seconds");
+	lua_pushnumber(L, elapsed > 0 ? frames / elapsed : 0);
+	lua_setfield(L, -2, "rate");
+	lua_pushinteger(L, __atomic_load_n(&gen->late, __ATOMIC_RELAXED));
+	lua_setfield(L, -2, "late");
+	lua_pushnumber(L, __atomic_load_n(&gen->maxLate, __ATOMIC_RELAXED) / 1e9);
+	lua_setfield(L, -2, "maxLate");
+	lua_pushinteger(L, __atomic_load_n(&gen->dropped, __ATOMIC_RELAXED));
+	lua_setfield(L, -2, "dropped");
+	if(error != 0) {
+		lua_pushstring(L, strerror(error));
+		lua_setfield(L, -2, "error");
+	}
+
+	return 1;
+}
+
+/* stop() - stop the thread, returning stats() */
+static int generator_stop(lua_State *L) {
+	struct generator *gen = luaL_checkudata(L, 1, GENERATOR_USERDATA);
+
+	generator_join(gen);
+
+	return generator_stats(L);
+}
+
+/* wait() - block until a start() with a duration has finished, returning
+ * stats() */
+static int generator_wait(lua_State *L) {
+	struct generator *gen = luaL_checkudata(L, 1, GENERATOR_USERDATA);
+
+	if(gen->started) {
+		pthread_join(gen->thread, NULL);
+		gen->started = 0;
+	}
+
+	return generator_stats(L);
+}
+
+static int generator_gc(lua_State *L) {
+	struct generator *gen = luaL_checkudata(L, 1, GENERATOR_USERDATA);
+
+	generator_join(gen);
+	if(gen->out != -1) {
+		close(gen->out);
+		gen->out = -1;
+	}
+
+	return 0;
+}
+
+/* Meters
+ * 
+ * A Meter measures a consumer: each observed event's lag from its kernel
+ * timestamp (CLOCK_REALTIME) to now goes into a histogram of logarithmic
+ * buckets, 16 per doubling (under 4.5% error), from which percentiles are
+ * read without keeping every sample. */
+
+#define METER_USERDATA "us.tropi.evdev.struct.meter"
+#define METER_STEPS 16
+#define METER_BUCKETS (40 * METER_STEPS) // lags up to 2^40 µs
+
+struct meter {
+	uint64_t buckets[METER_BUCKETS];
+	uint64_t count, firstUs, lastUs;
+	double total, max; // µs
 };
 
-#define CHECK_UINPUT(dev, index, isInit) \
-struct userdev *dev = luaL_checkudata(L, index, UINPUT_USERDATA); \
-if(dev->fd == -1) { \
-	return luaL_error(L, "Trying to use closed uinput device node."); \
-} \
-if(isInit == 1) { \
-	if(dev->init == 0 ) \
-		return luaL_error(L, "Trying to use uninitialized uinput device node."); \
-} else if(isInit == 0) { \
-	if(dev->init == 1) \
-		return luaL_error(L, "Trying to configure initialized uinput device node."); \
-} else if(isInit == 2) { \
-	/* Don't care about initialization state */ \
-} else { \
-	/* Should never happen */ \
-	return luaL_error(L, "Logic error in CHECK_UINPUT"); \
+static int meter_open(lua_State *L) {
+	struct meter *meter = lua_newuserdata(L, sizeof(struct meter));
+	memset(meter, 0, sizeof(struct meter));
+	luaL_setmetatable(L, METER_USERDATA);
+
+	return 1;
 }
 
+/* observe(timestamp[, count]) - record `count` events (default 1) with
+ * this timestamp, as handled now */
+static int meter_observe(lua_State *L) {
+	struct meter *meter = luaL_checkudata(L, 1, METER_USERDATA);
+	lua_Number stamp = luaL_checknumber(L, 2);
+	lua_Integer count = luaL_optinteger(L, 3, 1);
+	uint64_t now = realtime_us();
 
-static int uinput_open(lua_State *L) {
-	const char *path = luaL_optstring(L, 1, "/dev/uinput");
-	
-	/* create userdata */
-	struct userdev *dev = lua_newuserdata(L, sizeof(struct userdev));
-	memset(dev, 0, sizeof(struct userdev));
-	dev->fd = -1;
+	double lag = now - stamp * 1e6;
+	if(lag < 0) {
+		lag = 0;
+	}
 
-	luaL_setmetatable(L, UINPUT_USERDATA);
-	
-	dev->fd = open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
-	if(dev->fd < 0) {
-		return luaL_error(L, "Couldn't open uinput device node.");
+	int bucket = lag < 1 ? 0 : (int) (log2(lag + 1) * METER_STEPS);
+	if(bucket >= METER_BUCKETS) {
+		bucket = METER_BUCKETS - 1;
 	}
-	
-	/* init dummy device description */
-	dev->dev.id.bustype = BUS_VIRTUAL;
-	
+
+	if(meter->count == 0) {
+		meter->firstUs = now;
+	}
+	meter->lastUs = now;
+	meter->buckets[bucket] += count;
+	meter->count += count;
+	meter->total += lag * count;
+	if(lag > meter->max) {
+		meter->max = lag;
+	}
+
+	return 0;
+}
+
+/* upper bound of the bucket holding the fraction `p` of samples, in s */
+static double meter_percentile(struct meter *meter, double p) {
+	uint64_t want = ceil(meter->count * p), seen = 0;
+	int bucket;
+
+	for(bucket = 0; bucket < METER_BUCKETS; bucket++) {
+		seen += meter->buckets[bucket];
+		if(seen >= want && seen > 0) {
+			double upper = exp2((bucket + 1) / (double) METER_STEPS) - 1;
+			return fmin(upper, meter->max) / 1e6;
+		}
+	}
+
+	return meter->max / 1e6;
+}
+
+/* report() - events, seconds and events per second since the first
+ * observation, and mean, p50, p99 and max lag in seconds */
+static int meter_report(lua_State *L) {
+	struct meter *meter = luaL_checkudata(L, 1, METER_USERDATA);
+	double seconds = (meter->lastUs - meter->firstUs) / 1e6;
+
+	lua_newtable(L);
+	lua_pushinteger(L, meter->count);
+	lua_setfield(L, -2, "events");
+	lua_pushnumber(L, seconds);
+	lua_setfield(L, -2, "seconds");
+	lua_pushnumber(L, seconds > 0 ? meter->count / seconds : 0);
+	lua_setfield(L, -2, "rate");
+	lua_pushnumber(L, meter->count > 0 ? meter->total / meter->count / 1e6 : 0);
+	lua_setfield(L, -2, "mean");
+	lua_pushnumber(L, meter->count > 0 ? meter_percentile(meter, 0.5) : 0);
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, meter->count > 0 ? meter_percentile(meter, 0.99) : 0);
+	lua_setfield(L, -2, "p99");
+	lua_pushnumber(L, meter->max / 1e6);
+	lua_setfield(L, -2, "max");
+
 	return 1;
 }
 
-#define BIT_TYPES(action, axisAction) \
-action(useEvent, UI_SET_EVBIT) \
-action(useKey, UI_SET_KEYBIT) \
-axisAction(useRelAxis, UI_SET_RELBIT) \
-axisAction(useAbsAxis, UI_SET_ABSBIT)
+static int meter_reset(lua_State *L) {
+	struct meter *meter = luaL_checkudata(L, 1, METER_USERDATA);
+
+	memset(meter, 0, sizeof(struct meter));
+
+	return 0;
+}
+
+/* Constants
+ * 
+ * The name tables in constants.h are turned into Lua tables only when
+ * first asked for: a section's name -> value table, or an event type's
+ * code -> name table. Both kinds are cached in the functions' shared
+ * upvalue, so names come back as the same interned strings. */
+
+static const struct evdevConstantSection *constant_section(const char *name) {
+	const struct evdevConstantSection *section, *best = NULL;
+
+	for(section = evdevConstantSections; section->prefix != NULL; section++) {
+		size_t len = strlen(section->prefix);
+		if(strncmp(name, section->prefix, len) == 0
+			&& (best == NULL || len > strlen(best->prefix))) {
+			best = section;
+		}
+	}
+
+	return best;
+}
 
+/* push the cached name -> value table for a section */
+static void constant_pushSection(lua_State *L, const struct evdevConstantSection *section) {
+	lua_getfield(L, lua_upvalueindex(1), section->prefix);
+	if(!lua_isnil(L, -1)) {
+		return;
+	}
+	lua_pop(L, 1);
 
-#define DECLARE_BIT_SETTER(name, type) \
-static int uinput_ ## name (lua_State *L) { \
-	CHECK_UINPUT(dev, 1, 0) \
-	int bit = luaL_checkinteger(L, 2); \
-	ioctl(dev->fd, type, bit); \
-	return 0; \
+	int i;
+	lua_createtable(L, 0, section->count);
+	for(i = 0; i < section->count; i++) {
+		lua_pushinteger(L, section->constants[i].value);
+		lua_setfield(L, -2, section->constants[i].name);
+	}
+	lua_pushvalue(L, -1);
+	lua_setfield(L, lua_upvalueindex(1), section->prefix);
 }
 
-#define DECLARE_AXIS_BIT_SETTER(name, type) \
-static int uinput_ ## name (lua_State *L) { \
-	CHECK_UINPUT(dev, 1, 0) \
-	int bit = luaL_checkinteger(L, 2); \
-	int minVal = luaL_checkinteger(L, 3); \
-	int maxVal = luaL_checkinteger(L, 4); \
-	ioctl(dev->fd, type, bit); \
-	dev->dev.absmin[bit] = minVal; \
-	dev->dev.absmax[bit] = maxVal; \
-	return 0; \
+/* constant(name) - the value of a constant, or nil */
+static int evdev_constant(lua_State *L) {
+	const char *name = luaL_checkstring(L, 1);
+	const struct evdevConstantSection *section = constant_section(name);
+
+	if(section == NULL) {
+		return 0;
+	}
+
+	constant_pushSection(L, section);
+	lua_getfield(L, -1, name);
+	return 1;
 }
 
-BIT_TYPES(DECLARE_BIT_SETTER, DECLARE_AXIS_BIT_SETTER)
+/* section(prefix) - a table of every constant with that prefix */
+static int evdev_section(lua_State *L) {
+	const char *prefix = luaL_checkstring(L, 1);
+	const struct evdevConstantSection *section;
 
-static int uinput_init(lua_State *L) {
-	
-	CHECK_UINPUT(dev, 1, 0)
-	
-	/* Give device human-friendly description */
-	const char *name = luaL_optstring(L, 2, "Lua-Powered Virtual Input Device");
-	strncpy(dev->dev.name, name, UINPUT_MAX_NAME_SIZE);
-	
-	// register device
-	write(dev->fd, &dev->dev, sizeof(struct uinput_user_dev));
-	
-	if(ioctl(dev->fd, UI_DEV_CREATE)) {
-		return luaL_error(L, "Couldn't create uinput device node.");
+	for(section = evdevConstantSections; section->prefix != NULL; section++) {
+		if(strcmp(prefix, section->prefix) == 0) {
+			constant_pushSection(L, section);
+			return 1;
+		}
 	}
-	
-	dev->init = 1;
-	
-	return 0;
+
+	return luaL_argerror(L, 1, "unknown constant prefix");
 }
 
-static int uinput_write(lua_State *L) {
-	CHECK_UINPUT(dev, 1, 1)
-	
-	struct input_event evt;
-	memset(&evt, 0, sizeof(struct input_event));
-	
-	evt.type = luaL_checkinteger(L, 2);
-	evt.code = luaL_checkinteger(L, 3);
-	evt.value = luaL_checkinteger(L, 4);
-	
-	write(dev->fd, &evt, sizeof(struct input_event));
-	
-	return 0;
+/* which sections name the codes of each event type */
+static const struct {
+	int type;
+	const char *prefixes[3];
+} constant_typeSections[] = {
+	{ EV_SYN, { "SYN_", NULL } },
+	{ EV_KEY, { "KEY_", "BTN_", NULL } },
+	{ EV_REL, { "REL_", NULL } },
+	{ EV_ABS, { "ABS_", NULL } },
+	{ EV_MSC, { "MSC_", NULL } },
+	{ EV_SW, { "SW_", NULL } },
+	{ EV_LED, { "LED_", NULL } },
+	{ EV_SND, { "SND_", NULL } },
+	{ EV_REP, { "REP_", NULL } },
+	{ EV_FF, { "FF_", NULL } },
+	{ -1, { NULL } }
+};
+
+/* fill the table on top of the stack with code -> name, first name wins */
+static void constant_addNames(lua_State *L, const char *prefix, int limit) {
+	const struct evdevConstantSection *section;
+	int i;
+
+	for(section = evdevConstantSections; section->prefix != NULL; section++) {
+		if(strcmp(prefix, section->prefix) != 0) {
+			continue;
+		}
+		for(i = 0; i < section->count; i++) {
+			const struct evdevConstant *constant = &section->constants[i];
+			if(constant->alias || constant->value < 0 || constant->value >= limit) {
+				continue;
+			}
+			lua_rawgeti(L, -1, constant->value);
+			if(lua_isnil(L, -1)) {
+				lua_pushstring(L, constant->name);
+				lua_rawseti(L, -3, constant->value);
+			}
+			lua_pop(L, 1);
+		}
+	}
 }
 
-static int uinput_close(lua_State *L) {
+/* name(type[, code]) - the name of an event type, or of a code of that type */
+static int evdev_name(lua_State *L) {
+	lua_Integer type = luaL_checkinteger(L, 1);
+	int i;
 
-	struct userdev *dev = luaL_checkudata(L, 1, UINPUT_USERDATA);
-	
-	/* explicit double-closes are poor practice,
-	 * but don't make them errors because we always close on __gc  */
-	if(dev->fd == -1) {
+	if(type < 0 || type >= EV_CNT) {
 		return 0;
 	}
-	
-	/* uinput device destroys on close anyways, but being explicit: */
-	ioctl(dev->fd, UI_DEV_DESTROY);
-	close(dev->fd);
-	
-	/* mark resource released */
-	dev->fd = -1;
-	
-	return 0;
+
+	/* the EV_ names live under the key "types", codes under their type */
+	int withCode = !lua_isnoneornil(L, 2);
+	if(withCode) {
+		lua_rawgeti(L, lua_upvalueindex(1), type);
+	} else {
+		lua_getfield(L, lua_upvalueindex(1), "types");
+	}
+
+	if(lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		if(withCode) {
+			for(i = 0; constant_typeSections[i].type >= 0; i++) {
+				if(constant_typeSections[i].type == type) {
+					const char *const *prefix;
+					for(prefix = constant_typeSections[i].prefixes; *prefix != NULL; prefix++) {
+						constant_addNames(L, *prefix, event_codeCount(type));
+					}
+				}
+			}
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, lua_upvalueindex(1), type);
+		} else {
+			constant_addNames(L, "EV_", EV_CNT);
+			lua_pushvalue(L, -1);
+			lua_setfield(L, lua_upvalueindex(1), "types");
+		}
+	}
+
+	lua_rawgeti(L, -1, withCode ? luaL_checkinteger(L, 2) : type);
+	return 1;
 }
 
 /* Expose to Lua */
@@ -305,16 +8936,55 @@ static int uinput_close(lua_State *L) {
 static const luaL_Reg evdevFuncs[] = {
 	{ "Device", &evdev_open },
 	{ "Uinput", &uinput_open },
+	{ "Trackpad", &trackpad_open },
+	{ "Aggregate", &aggregate_open },
+	{ "Forwarder", &forward_open },
+	{ "Pool", &pool_open },
+	{ "Group", &group_open },
+	{ "Generator", &generator_open },
+	{ "Meter", &meter_open },
+	{ "Dispatcher", &dispatcher_open },
+	{ "Hotkeys", &hotkeys_open },
+	{ "Recorder", &recorder_open },
+	{ "Replay", &replay_open },
+	{ "Merge", &merge_open },
+	{ "Ring", &ring_open },
+	{ "Poller", &poller_open },
+	{ "flightSignal", &evdev_flightSignal },
+	{ "metrics", &evdev_metrics },
+	{ "sendState", &handoff_send },
+	{ "receiveState", &handoff_receive },
+	{ "monotonic", &evdev_monotonic },
 	{ NULL, NULL }
 };
 
 static const luaL_Reg evdev_mtFuncs[] = {
 	{ "read", &evdev_read },
 	{ "tryRead", &evdev_tryRead },
+	{ "readAsync", &evdev_readAsync },
+	{ "readBatch", &evdev_readBatch },
+	{ "event", &evdev_event },
 	{ "write", &evdev_write},
 	{ "close", &evdev_close },
+	{ "revoke", &evdev_revoke },
+	{ "ended", &evdev_ended },
 	{ "grab", &evdev_grab },
 	{ "pollfd", &evdev_pollfd },
+	{ "filterAxis", &evdev_filterAxis },
+	{ "hotkeys", &evdev_hotkeys },
+	{ "gestures", &evdev_gestures },
+	{ "debounce", &evdev_debounce },
+	{ "stats", &evdev_stats },
+	{ "limit", &evdev_limit },
+	{ "timeout", &evdev_timeout },
+	{ "pending", &evdev_pending },
+	{ "flightRecorder", &evdev_flightRecorder },
+	{ "dumpFlight", &evdev_dumpFlight },
+	{ "uploadEffect", &evdev_uploadEffect },
+	{ "playEffect", &evdev_playEffect },
+	{ "stopEffect", &evdev_stopEffect },
+	{ "eraseEffect", &evdev_eraseEffect },
+	{ "effects", &evdev_effects },
 	{ NULL, NULL }
 };
 
@@ -325,10 +8995,140 @@ static const luaL_Reg uinput_mtFuncs[] = {
 	{ "init", &uinput_init },
 	{ "close", &uinput_close },
 	{ "write", &uinput_write},
+	{ "flush", &uinput_flush },
+	{ "queued", &uinput_queued },
+	{ "setQueueLimit", &uinput_setQueueLimit },
+	{ "stats", &uinput_stats },
+	{ "schedule", &uinput_schedule },
+	{ "dispatch", &uinput_dispatch },
+	{ "scheduled", &uinput_scheduled },
+	{ "cancel", &uinput_cancel },
+	{ "reset", &uinput_reset },
+	{ "read", &uinput_read },
+	{ "relay", &uinput_relay },
+	{ "useFF", &uinput_useFF },
+	{ "pollfd", &uinput_pollfd },
+	{ "filterAxis", &uinput_filterAxis },
 	BIT_TYPES(REGISTER_BIT_SETTER, REGISTER_BIT_SETTER)
 	{ NULL, NULL }
 };
 
+static const luaL_Reg dispatcher_mtFuncs[] = {
+	{ "on", &dispatcher_on },
+	{ "dispatch", &dispatcher_dispatch },
+	{ "profile", &dispatcher_profile },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg hotkeys_mtFuncs[] = {
+	{ "chord", &hotkeys_chord },
+	{ "sequence", &hotkeys_sequence },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg aggregate_mtFuncs[] = {
+	{ "add", &aggregate_add },
+	{ "pump", &aggregate_pump },
+	{ "pollfd", &aggregate_pollfd },
+	{ "stats", &aggregate_stats },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg trackpad_mtFuncs[] = {
+	{ "pump", &trackpad_pump },
+	{ "pollfd", &trackpad_pollfd },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg recorder_mtFuncs[] = {
+	{ "write", &recorder_write },
+	{ "close", &recorder_close },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg replay_mtFuncs[] = {
+	{ "read", &replay_read },
+	{ "tryRead", &replay_tryRead },
+	{ "seek", &replay_seek },
+	{ "timeRange", &replay_timeRange },
+	{ "close", &replay_gc },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg merge_mtFuncs[] = {
+	{ "add", &merge_add },
+	{ "read", &merge_read },
+	{ "tryRead", &merge_tryRead },
+	{ "flush", &merge_flush },
+	{ "pending", &merge_pending },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg forward_mtFuncs[] = {
+	{ "status", &forward_status },
+	{ "close", &forward_close },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg generator_mtFuncs[] = {
+	{ "setup", &generator_setup },
+	{ "device", &generator_device },
+	{ "start", &generator_start },
+	{ "stop", &generator_stop },
+	{ "wait", &generator_wait },
+	{ "record", &generator_record },
+	{ "stats", &generator_stats },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg meter_mtFuncs[] = {
+	{ "observe", &meter_observe },
+	{ "report", &meter_report },
+	{ "reset", &meter_reset },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg group_mtFuncs[] = {
+	{ "open", &group_deviceOpen },
+	{ "add", &group_add },
+	{ "remove", &group_remove },
+	{ "send", &group_send },
+	{ "revoke", &group_revoke },
+	{ "count", &group_count },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg pool_mtFuncs[] = {
+	{ "define", &pool_define },
+	{ "prefill", &pool_prefill },
+	{ "acquire", &pool_acquire },
+	{ "release", &pool_release },
+	{ "stats", &pool_stats },
+	{ "close", &pool_close },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg poller_mtFuncs[] = {
+	{ "add", &poller_add },
+	{ "remove", &poller_remove },
+	{ "wait", &poller_wait },
+	{ "count", &poller_count },
+	{ "pollfd", &poller_pollfd },
+	{ "close", &poller_close },
+	{ NULL, NULL }
+};
+
+static const luaL_Reg ring_mtFuncs[] = {
+	{ "add", &ring_add },
+	{ "harvest", &ring_harvest },
+	{ "event", &ring_event },
+	{ "backend", &ring_backend },
+	{ "pollfd", &ring_pollfd },
+	{ "timeout", &ring_timeout },
+	{ "close", &ring_close },
+	{ NULL, NULL }
+};
+
 int luaopen_evdev_core(lua_State *L) {
 	
 	/* Evdev metatable */
@@ -353,14 +9153,210 @@ int luaopen_evdev_core(lua_State *L) {
 	
 	lua_pushstring(L, "__index");
 	luaL_newlib(L, uinput_mtFuncs);
+	
+		lua_pushstring(L, "events");
+		lua_pushstring(L, "r");
+		lua_settable(L, -3);
+	
 	lua_settable(L, -3);
 
 	lua_pushstring(L, "__gc");
 	lua_pushcfunction(L, &uinput_close);
 	lua_settable(L, -3);
 	
+	
+	/* Trackpad metatable */
+	luaL_newmetatable(L, TRACKPAD_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, trackpad_mtFuncs);
+	
+		lua_pushstring(L, "events");
+		lua_pushstring(L, "r");
+		lua_settable(L, -3);
+	
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &trackpad_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Aggregate metatable */
+	luaL_newmetatable(L, AGGREGATE_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, aggregate_mtFuncs);
+	
+		lua_pushstring(L, "events");
+		lua_pushstring(L, "r");
+		lua_settable(L, -3);
+	
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &aggregate_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Dispatcher metatable */
+	luaL_newmetatable(L, DISPATCHER_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, dispatcher_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &dispatcher_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Hotkeys metatable */
+	luaL_newmetatable(L, HOTKEYS_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, hotkeys_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &hotkeys_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Recorder metatable */
+	luaL_newmetatable(L, RECORDER_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, recorder_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &recorder_close);
+	lua_settable(L, -3);
+	
+	
+	/* Replay metatable */
+	luaL_newmetatable(L, REPLAY_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, replay_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &replay_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Merge metatable */
+	luaL_newmetatable(L, MERGE_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, merge_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &merge_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Forwarder metatable */
+	luaL_newmetatable(L, FORWARDER_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, forward_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &forward_close);
+	lua_settable(L, -3);
+	
+	
+	/* Generator metatable */
+	luaL_newmetatable(L, GENERATOR_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, generator_mtFuncs);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &generator_gc);
+	lua_settable(L, -3);
+	
+	
+	/* Meter metatable */
+	luaL_newmetatable(L, METER_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, meter_mtFuncs);
+	lua_settable(L, -3);
+	
+	
+	/* Group metatable */
+	luaL_newmetatable(L, GROUP_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, group_mtFuncs);
+	lua_settable(L, -3);
+	
+	
+	/* Pool metatable */
+	luaL_newmetatable(L, POOL_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, pool_mtFuncs);
+	lua_settable(L, -3);
+	
+	
+	/* Poller metatable */
+	luaL_newmetatable(L, POLLER_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, poller_mtFuncs);
+	
+		lua_pushstring(L, "events");
+		lua_pushstring(L, "r");
+		lua_settable(L, -3);
+	
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &poller_close);
+	lua_settable(L, -3);
+	
+	
+	/* Ring metatable */
+	luaL_newmetatable(L, RING_USERDATA);
+	
+	lua_pushstring(L, "__index");
+	luaL_newlib(L, ring_mtFuncs);
+	
+		lua_pushstring(L, "events");
+		lua_pushstring(L, "r");
+		lua_settable(L, -3);
+	
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, &ring_close);
+	lua_settable(L, -3);
+	
 	/* Base library */
 	luaL_newlib(L, evdevFuncs);
+
+	/* constant lookups share a cache of lazily-built tables */
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_pushcclosure(L, &evdev_constant, 1);
+	lua_setfield(L, -3, "constant");
+	lua_pushvalue(L, -1);
+	lua_pushcclosure(L, &evdev_section, 1);
+	lua_setfield(L, -3, "section");
+	lua_pushcclosure(L, &evdev_name, 1);
+	lua_setfield(L, -2, "name");
+
+	/* lets the FFI binding check its struct layout */
+	lua_pushinteger(L, sizeof(struct input_event));
+	lua_setfield(L, -2, "eventSize");
 	
 	return 1;
 }
@@ -0,0 +1,60 @@
+--[[
+LuaJIT FFI view of batched reads: Device:readBatch() leaves its events
+in a C array, which is cast to struct input_event cdata here so loops
+over the fields compile without crossing the Lua C API per event.
+
+Loaded by evdev.lua only under LuaJIT; errors if the FFI struct doesn't
+match the C module's, so the caller can fall back.
+--]]
+
+local ffi = require "ffi"
+local c = require "evdev.core"
+
+ffi.cdef [[
+struct evdev_timeval {
+	long tv_sec;
+	long tv_usec;
+};
+
+struct evdev_input_event {
+	struct evdev_timeval time;
+	uint16_t type;
+	uint16_t code;
+	int32_t value;
+};
+]]
+
+local eventArray = ffi.typeof "const struct evdev_input_event *"
+local sourceArray = ffi.typeof "const int *"
+
+assert(ffi.sizeof "struct evdev_input_event" == c.eventSize,
+	"struct input_event layout differs from evdev.core")
+
+-- count, events: events[0] .. events[count - 1] are cdata
+local function readBatch(device, max)
+	local count, buffer = device:readBatch(max)
+	if not count then
+		return nil, buffer
+	end
+	return count, ffi.cast(eventArray, buffer)
+end
+
+-- count, events, sources: sources[i] is the 0-based Ring index of events[i]
+local function harvest(ring, block)
+	local count, buffer, sources = ring:harvest(block)
+	if not count then
+		return nil
+	end
+	return count, ffi.cast(eventArray, buffer), ffi.cast(sourceArray, sources)
+end
+
+local function timestamp(event)
+	return tonumber(event.time.tv_sec) + tonumber(event.time.tv_usec) / 1e6
+end
+
+return {
+	backend = "ffi",
+	readBatch = readBatch,
+	harvest = harvest,
+	timestamp = timestamp,
+}
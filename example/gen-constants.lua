@@ -1,29 +1,45 @@
--- script for generating constants.lua from the linux/input.h header
+-- script for generating evdev/constants.h from the linux/input.h and
+-- linux/input-event-codes.h headers
 
+-- a name goes in the first section whose prefix matches
 local capture = {
-	{"Event Types", "^EV_"},
-	{"Synchronization", "^SYN_"},
-	{"Keys", "^KEY_"},
-	{"Buttons", "^BTN_"},
-	{"Relative Axes", "^REL_"},
-	{"Absolute Axes", "^ABS_"},
-	{"LEDs", "^LED_"},
+	{"Event Types", "EV_"},
+	{"Synchronization", "SYN_"},
+	{"Keys", "KEY_"},
+	{"Buttons", "BTN_"},
+	{"Relative Axes", "REL_"},
+	{"Absolute Axes", "ABS_"},
+	{"Miscellaneous Events", "MSC_"},
+	{"Switches", "SW_"},
+	{"LEDs", "LED_"},
+	{"Sounds", "SND_"},
+	{"Autorepeat", "REP_"},
+	{"Force Feedback Status", "FF_STATUS_"},
+	{"Force Feedback", "FF_"},
+	{"Input Properties", "INPUT_PROP_"},
+	{"Device ID Fields", "ID_"},
+	{"Bus Types", "BUS_"},
+	{"Multitouch Tools", "MT_TOOL_"},
 }
 
 local header = [[
+/* Constants for the Linux evdev API
+ * created by the gen-constants.lua script from the <linux/input.h> header
+ *
+ * Each name is guarded, so building against older headers only leaves
+ * out what they don't define. */
 
-local _ENV = {}
+struct evdevConstant {
+	const char *name;
+	int value;
+	int alias; /* another name for a value, or a limit; never a code's name */
+};
 
-if setfenv then
-	setfenv(1, _ENV)
-end
-
--- Constants for the Linux evdev API
--- created by the gen-constants.lua script from the <linux/input.h> header
-]]
-
-local footer = [[
-return _ENV
+struct evdevConstantSection {
+	const char *prefix;
+	const struct evdevConstant *constants;
+	int count;
+};
 ]]
 
 local headerFiles = { ... }
@@ -34,26 +50,66 @@ if #headerFiles == 0 then
 end
 
 local sections = {}
-for _, record in pairs(capture) do
-	sections[record[1]] = "-- " .. record[1] .. "\n"
+local seen = {}
+for _, record in ipairs(capture) do
+	sections[record[2]] = {}
 end
 
 for headerIndex = 1, #headerFiles do
 	for line in io.lines(headerFiles[headerIndex]) do
-		local name, value = line:match "^#define%s+(%S+)%s+(%S+)"
-		if name then
-			for _, record in pairs(capture) do
-				if name:match(record[2]) then
-					local defineLine = name .. " = " .. value .. "\n"
-					sections[record[1]] = sections[record[1]] .. defineLine
+		-- object-like macros only; function-like ones have a "(" after the name
+		local name, value = line:match "^#define%s+([%w_]+)%s+(%S+)"
+		if name and not seen[name] then
+			for _, record in ipairs(capture) do
+				local prefix = record[2]
+				if name:sub(1, #prefix) == prefix then
+					local section = sections[prefix]
+					local previous = section[#section]
+					-- range markers like BTN_MOUSE share a value with the next name
+					if previous and previous.value == value then
+						previous.alias = true
+					end
+					seen[name] = true
+					table.insert(section, {
+						name = name,
+						value = value,
+						alias = value:match "^[%a_]" ~= nil
+							or name:match "_MAX$" ~= nil
+							or name:match "_CNT$" ~= nil,
+					})
+					break
 				end
 			end
 		end
 	end
 end
 
+local function arrayName(prefix)
+	return "evdevConstants_" .. prefix:sub(1, -2)
+end
+
 print(header)
-for _, record in pairs(capture) do
-	print(sections[record[1]])
+for _, record in ipairs(capture) do
+	local prefix = record[2]
+	print("/* " .. record[1] .. " */")
+	print("static const struct evdevConstant " .. arrayName(prefix) .. "[] = {")
+	for _, constant in ipairs(sections[prefix]) do
+		local name = constant.name
+		print("#ifdef " .. name)
+		print("\t{ \"" .. name .. "\", " .. name .. ", " .. (constant.alias and 1 or 0) .. " },")
+		print("#endif")
+	end
+	-- keeps the array non-empty whatever the headers define
+	print("\t{ NULL, 0, 0 }")
+	print("};")
+	print()
+end
+
+print("static const struct evdevConstantSection evdevConstantSections[] = {")
+for _, record in ipairs(capture) do
+	local prefix = record[2]
+	print("\t{ \"" .. prefix .. "\", " .. arrayName(prefix) .. ", "
+		.. "sizeof(" .. arrayName(prefix) .. ") / sizeof(struct evdevConstant) - 1 },")
 end
-print(footer)
+print("\t{ NULL, NULL, 0 }")
+print("};")